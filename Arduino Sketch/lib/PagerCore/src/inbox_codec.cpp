@@ -0,0 +1,138 @@
+#include "inbox_codec.h"
+
+#include <string.h>
+
+void putLe16(uint8_t* p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+void putLe32(uint8_t* p, uint32_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+}
+
+uint16_t getLe16(const uint8_t* p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+uint32_t getLe32(const uint8_t* p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Nibble table to keep flash usage small
+uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t len) {
+  static const uint32_t table[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+    0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+    0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+  };
+
+  crc = ~crc;
+  for (size_t i = 0; i < len; ++i) {
+    crc ^= data[i];
+    crc = (crc >> 4) ^ table[crc & 0x0F];
+    crc = (crc >> 4) ^ table[crc & 0x0F];
+  }
+  return ~crc;
+}
+
+void inboxEncodeFileHeader(uint8_t* buf) {
+  buf[0] = 'P';
+  buf[1] = 'G';
+  buf[2] = 'I';
+  buf[3] = INBOX_FORMAT_VERSION;
+}
+
+bool inboxIsFileHeader(const uint8_t* hdr) {
+  return hdr[0] == 'P' && hdr[1] == 'G' && hdr[2] == 'I';
+}
+
+size_t inboxEncodeRecord(uint8_t* buf, uint8_t type, int slot, const PageMessage* msg,
+                         const char* ricName, const uint8_t* packedText) {
+  size_t pos = INBOX_RECORD_HDR_LEN;
+
+  if (type == INBOX_REC_ADD && msg != nullptr) {
+    size_t ricLen = strlen(ricName);
+    if (ricLen > INBOX_RIC_NAME_MAX) {
+      ricLen = INBOX_RIC_NAME_MAX;
+    }
+
+    size_t textLen   = msg->textLen;
+    size_t textBytes = TEXT_PACKED_LEN(textLen);
+
+    putLe32(buf + pos, msg->addr);
+    pos += 4;
+    putLe32(buf + pos, msg->time);
+    pos += 4;
+    buf[pos++] = (uint8_t)ricLen;
+    memcpy(buf + pos, ricName, ricLen);
+    pos += ricLen;
+    putLe16(buf + pos, (uint16_t)textLen);
+    pos += 2;
+    memcpy(buf + pos, packedText, textBytes);
+    pos += textBytes;
+  }
+
+  buf[0] = type;
+  buf[1] = (uint8_t)slot;
+  putLe16(buf + 2, (uint16_t)(pos - INBOX_RECORD_HDR_LEN));
+
+  putLe32(buf + pos, crc32Update(0, buf, pos));
+  pos += INBOX_RECORD_CRC_LEN;
+
+  return pos;
+}
+
+size_t inboxRecordLength(const uint8_t* hdr) {
+  size_t len = INBOX_RECORD_HDR_LEN + getLe16(hdr + 2) + INBOX_RECORD_CRC_LEN;
+  return (len <= INBOX_RECORD_MAX) ? len : 0;
+}
+
+bool inboxDecodeRecord(const uint8_t* rec, size_t len, InboxRecord& out, uint8_t version) {
+  if (len < INBOX_RECORD_HDR_LEN + INBOX_RECORD_CRC_LEN || inboxRecordLength(rec) != len) {
+    return false;
+  }
+
+  size_t bodyLen = getLe16(rec + 2);
+  size_t crcPos  = INBOX_RECORD_HDR_LEN + bodyLen;
+  if (crc32Update(0, rec, crcPos) != getLe32(rec + crcPos)) {
+    return false;
+  }
+
+  out.type = rec[0];
+  out.slot = rec[1];
+  if (out.slot >= INBOX_SIZE) {
+    return false;
+  }
+
+  if (out.type == INBOX_REC_WRITE || out.type == INBOX_REC_DELETE) {
+    return true;
+  }
+  if (out.type != INBOX_REC_ADD || bodyLen < INBOX_ADD_FIXED_LEN) {
+    return false;
+  }
+
+  const uint8_t* body = rec + INBOX_RECORD_HDR_LEN;
+  out.ricLen = body[8];
+  if (INBOX_ADD_FIXED_LEN + out.ricLen > bodyLen) {
+    return false;
+  }
+  out.textLen     = getLe16(body + 9 + out.ricLen);
+  bool   packed    = version > INBOX_FORMAT_PLAIN;
+  size_t textBytes = packed ? TEXT_PACKED_LEN(out.textLen) : out.textLen;
+  if (INBOX_ADD_FIXED_LEN + out.ricLen + textBytes != bodyLen) {
+    return false;
+  }
+
+  const uint8_t* text = body + INBOX_ADD_FIXED_LEN + out.ricLen;
+  out.addr            = getLe32(body);
+  out.packedTime      = getLe32(body + 4);
+  out.ricName         = (const char*)body + 9;
+  out.packedText      = packed ? text : nullptr;
+  out.text            = packed ? nullptr : (const char*)text;
+  return true;
+}
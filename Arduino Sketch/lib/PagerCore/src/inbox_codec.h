@@ -0,0 +1,78 @@
+#pragma once
+
+// -----------------------------------------------------------------------------
+// Inbox file format (binary, version 3)
+//
+// File header: 'P' 'G' 'I' <version>
+// Record:      type(1) slot(1) bodyLen(2) body(bodyLen) crc32(4)
+//   'A' add    body = addr(4) packedTime(4) ricLen(1) ric textLen(2) text
+//              text = TEXT_PACKED_LEN(textLen) bytes, 7 bits per character
+//              (version 2: textLen plain bytes)
+//   'D' delete body = empty (tombstone for slot)
+//   'W' header body = empty (ring write position, ignored since the ordered index)
+// All integers are little-endian, the CRC covers type..body.
+// -----------------------------------------------------------------------------
+
+#include <stddef.h>
+#include <stdint.h>
+#include "inbox_ring.h"
+
+const uint8_t INBOX_FORMAT_VERSION  = 3;
+const uint8_t INBOX_FORMAT_PLAIN    = 2;    // last version with unpacked text
+const size_t  INBOX_FILE_HEADER_LEN = 4;
+const size_t  INBOX_RECORD_HDR_LEN  = 4;
+const size_t  INBOX_RECORD_CRC_LEN  = 4;
+const size_t  INBOX_RECORD_MAX      = 512;  // upper bound for a complete record
+const size_t  INBOX_RIC_NAME_MAX    = 31;
+const size_t  INBOX_ADD_FIXED_LEN   = 11;   // addr + packedTime + ricLen + textLen
+// Largest add record of the current format
+const size_t  INBOX_ADD_RECORD_MAX  = INBOX_RECORD_HDR_LEN + INBOX_ADD_FIXED_LEN + INBOX_RIC_NAME_MAX +
+                                      INBOX_TEXT_PACKED + INBOX_RECORD_CRC_LEN;
+
+const uint8_t INBOX_REC_ADD    = 'A';
+const uint8_t INBOX_REC_DELETE = 'D';
+const uint8_t INBOX_REC_WRITE  = 'W';
+
+void     putLe16(uint8_t* p, uint16_t v);
+void     putLe32(uint8_t* p, uint32_t v);
+uint16_t getLe16(const uint8_t* p);
+uint32_t getLe32(const uint8_t* p);
+
+// CRC-32 (IEEE 802.3)
+uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t len);
+
+// Fill the file header (INBOX_FILE_HEADER_LEN bytes)
+void inboxEncodeFileHeader(uint8_t* buf);
+
+// hdr starts an inbox file of any version (the version is hdr[3])
+bool inboxIsFileHeader(const uint8_t* hdr);
+
+// Build one record into buf (at least INBOX_RECORD_MAX bytes), returns its
+// total length. msg, ricName and the packed text (msg->textLen characters)
+// are only used for INBOX_REC_ADD.
+size_t inboxEncodeRecord(uint8_t* buf, uint8_t type, int slot, const PageMessage* msg,
+                         const char* ricName, const uint8_t* packedText);
+
+// A decoded record; the strings point into the record buffer
+// and are not NUL-terminated
+struct InboxRecord {
+  uint8_t        type;
+  uint8_t        slot;
+  uint32_t       addr;        // INBOX_REC_ADD only
+  uint32_t       packedTime;
+  const char*    ricName;
+  size_t         ricLen;
+  const uint8_t* packedText;  // current format, else nullptr
+  const char*    text;        // INBOX_FORMAT_PLAIN files, else nullptr
+  size_t         textLen;     // characters
+};
+
+// Total record length announced by a record header, 0 if it cannot be a
+// valid record (larger than INBOX_RECORD_MAX)
+size_t inboxRecordLength(const uint8_t* hdr);
+
+// Check and decode a complete record of len bytes (CRC, body layout, slot
+// range, known type) from a file of the given format version. False means
+// corrupt or torn.
+bool inboxDecodeRecord(const uint8_t* rec, size_t len, InboxRecord& out,
+                       uint8_t version = INBOX_FORMAT_VERSION);
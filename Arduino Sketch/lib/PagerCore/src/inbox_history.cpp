@@ -0,0 +1,93 @@
+#include "inbox_history.h"
+
+void historyReset(InboxHistory& h) {
+  h.head         = 0;
+  h.count        = 0;
+  h.firstSeq     = 0;
+  h.segment      = 0;
+  h.segmentPages = 0;
+  h.segmentBytes = 0;
+  h.generation   = 0;
+}
+
+void historySelectSegment(InboxHistory& h, uint8_t seg, uint32_t generation, uint32_t bytes) {
+  // Entries are chronological and segments are filled one after the other,
+  // so the pages of seg are all at the old end
+  while (h.count > 0 && historySegment(h.entries[h.head]) == seg) {
+    h.head = (uint16_t)((h.head + 1) % INBOX_HISTORY_MAX);
+    h.count--;
+    h.firstSeq++;
+  }
+  h.segment      = seg;
+  h.generation   = generation;
+  h.segmentPages = 0;
+  h.segmentBytes = bytes;
+}
+
+uint32_t historyAppend(InboxHistory& h, uint32_t addr, uint8_t textLen, uint32_t packedTime,
+                       uint32_t recordLen) {
+  HistoryEntry& e = h.entries[(h.head + h.count) % INBOX_HISTORY_MAX];
+  e.offset        = h.segmentBytes;
+  e.packedTime    = packedTime;
+  e.info          = (addr & 0x1FFFFF) | ((uint32_t)textLen << 21) | ((uint32_t)(h.segment & 1) << 29);
+
+  h.count++;
+  h.segmentPages++;
+  h.segmentBytes += recordLen;
+  return e.offset;
+}
+
+void historyDropNewest(InboxHistory& h, uint32_t recordLen) {
+  if (h.count == 0 || h.segmentPages == 0) {
+    return;
+  }
+  h.count--;
+  h.segmentPages--;
+  h.segmentBytes -= recordLen;
+}
+
+const HistoryEntry* historyFind(const InboxHistory& h, uint32_t seq) {
+  uint32_t pos = seq - h.firstSeq;
+  if (pos >= h.count) {
+    return nullptr;
+  }
+  return &h.entries[(h.head + pos) % INBOX_HISTORY_MAX];
+}
+
+void historyCacheReset(HistoryCache& c) {
+  for (int i = 0; i < INBOX_HISTORY_CACHE; ++i) {
+    c.used[i] = false;
+  }
+  c.clock  = 0;
+  c.hits   = 0;
+  c.misses = 0;
+}
+
+int historyCacheLookup(HistoryCache& c, uint32_t seq) {
+  for (int i = 0; i < INBOX_HISTORY_CACHE; ++i) {
+    if (c.used[i] && c.seq[i] == seq) {
+      c.lastUse[i] = ++c.clock;
+      c.hits++;
+      return i;
+    }
+  }
+  c.misses++;
+  return -1;
+}
+
+int historyCacheInsert(HistoryCache& c, uint32_t seq) {
+  int slot = 0;
+  for (int i = 0; i < INBOX_HISTORY_CACHE; ++i) {
+    if (!c.used[i]) {
+      slot = i;
+      break;
+    }
+    if (c.lastUse[i] < c.lastUse[slot]) {
+      slot = i;
+    }
+  }
+  c.used[slot]    = true;
+  c.seq[slot]     = seq;
+  c.lastUse[slot] = ++c.clock;
+  return slot;
+}
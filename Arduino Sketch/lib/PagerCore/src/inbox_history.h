@@ -0,0 +1,106 @@
+#pragma once
+
+// Inbox history: pages pushed out of the RAM inbox move to append-only
+// segment files on LittleFS (inbox record format, see inbox_codec.h). RAM
+// keeps a fixed 12-byte index entry per page, bodies are read on demand and
+// the last few are kept in an LRU cache for scrolling.
+//
+// There are two segments of INBOX_HISTORY_SEGMENT_PAGES pages. When the
+// segment being appended to is full, the other one is started over, so the
+// oldest half of the history goes at once and nothing is ever rewritten.
+// Pages are numbered by a sequence number that never repeats; the index is
+// a ring in chronological order, the oldest page has firstSeq.
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Pages kept in the history (RAM: 12 bytes each)
+#ifndef INBOX_HISTORY_MAX
+#define INBOX_HISTORY_MAX 2048
+#endif
+
+// Bodies kept in RAM while scrolling through the history
+#ifndef INBOX_HISTORY_CACHE
+#define INBOX_HISTORY_CACHE 4
+#endif
+
+const int INBOX_HISTORY_SEGMENTS      = 2;
+const int INBOX_HISTORY_SEGMENT_PAGES = INBOX_HISTORY_MAX / INBOX_HISTORY_SEGMENTS;
+
+static_assert(INBOX_HISTORY_MAX <= 0xFFFF, "index positions are 16 bit");
+
+struct HistoryEntry {
+  uint32_t offset;      // record position in its segment file
+  uint32_t packedTime;  // packPagerTime(), 0 = no time
+  uint32_t info;        // addr (21 bits) | textLen (8) << 21 | segment << 29
+};
+
+static_assert(sizeof(HistoryEntry) == 12, "RAM per page");
+
+inline uint32_t historyAddr(const HistoryEntry& e) {
+  return e.info & 0x1FFFFF;
+}
+inline uint8_t historyTextLen(const HistoryEntry& e) {
+  return (uint8_t)(e.info >> 21);
+}
+inline uint8_t historySegment(const HistoryEntry& e) {
+  return (uint8_t)((e.info >> 29) & 1);
+}
+
+struct InboxHistory {
+  HistoryEntry entries[INBOX_HISTORY_MAX];
+  uint16_t     head;          // ring position of the oldest page
+  uint16_t     count;
+  uint32_t     firstSeq;      // sequence number of the oldest page
+  uint8_t      segment;       // segment being appended to
+  uint16_t     segmentPages;  // pages in it
+  uint32_t     segmentBytes;  // its file length = offset of the next record
+  uint32_t     generation;    // its generation (file header), higher = newer
+};
+
+void historyReset(InboxHistory& h);
+
+// Make seg the segment to append to, its file being bytes long. Pages still
+// indexed in seg are dropped (they are the oldest ones).
+void historySelectSegment(InboxHistory& h, uint8_t seg, uint32_t generation, uint32_t bytes);
+
+// The segment being appended to has no room for another page
+inline bool historySegmentFull(const InboxHistory& h) {
+  return h.segmentPages >= INBOX_HISTORY_SEGMENT_PAGES;
+}
+
+// Index a page of recordLen bytes at the end of the current segment, which
+// must not be full. Returns the file offset the record goes to.
+uint32_t historyAppend(InboxHistory& h, uint32_t addr, uint8_t textLen, uint32_t packedTime,
+                       uint32_t recordLen);
+
+// Undo the last historyAppend() (the record could not be written)
+void historyDropNewest(InboxHistory& h, uint32_t recordLen);
+
+// One past the newest sequence number
+inline uint32_t historyEndSeq(const InboxHistory& h) {
+  return h.firstSeq + h.count;
+}
+
+// Index entry of a page, nullptr if it is not (or no longer) in the history
+const HistoryEntry* historyFind(const InboxHistory& h, uint32_t seq);
+
+// LRU cache of page bodies; the bodies themselves live in the caller's
+// array, the cache only decides which of its INBOX_HISTORY_CACHE slots
+// holds which page.
+struct HistoryCache {
+  uint32_t seq[INBOX_HISTORY_CACHE];
+  uint32_t lastUse[INBOX_HISTORY_CACHE];
+  bool     used[INBOX_HISTORY_CACHE];
+  uint32_t clock;
+  uint32_t hits;
+  uint32_t misses;
+};
+
+void historyCacheReset(HistoryCache& c);
+
+// Slot holding seq, or -1 (counted as hit or miss)
+int historyCacheLookup(HistoryCache& c, uint32_t seq);
+
+// Slot to load seq into: a free one, else the least recently used
+int historyCacheInsert(HistoryCache& c, uint32_t seq);
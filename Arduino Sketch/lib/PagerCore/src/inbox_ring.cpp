@@ -0,0 +1,110 @@
+#include "inbox_ring.h"
+
+#include <string.h>
+
+// Append slot at the tail of list
+static void inboxListAppend(InboxRing& ring, InboxList& list, int slot) {
+  ring.prev[slot] = list.tail;
+  ring.next[slot] = INBOX_NIL;
+
+  if (list.tail != INBOX_NIL) {
+    ring.next[list.tail] = slot;
+  } else {
+    list.head = slot;
+  }
+  list.tail = slot;
+}
+
+// Remove slot from list
+static void inboxListRemove(InboxRing& ring, InboxList& list, int slot) {
+  int16_t prev = ring.prev[slot];
+  int16_t next = ring.next[slot];
+
+  if (prev != INBOX_NIL) {
+    ring.next[prev] = next;
+  } else {
+    list.head = next;
+  }
+  if (next != INBOX_NIL) {
+    ring.prev[next] = prev;
+  } else {
+    list.tail = prev;
+  }
+
+  ring.prev[slot] = INBOX_NIL;
+  ring.next[slot] = INBOX_NIL;
+}
+
+void inboxRingReset(InboxRing& ring) {
+  ring.count         = 0;
+  ring.order.head    = ring.order.tail    = INBOX_NIL;
+  ring.freeList.head = ring.freeList.tail = INBOX_NIL;
+
+  for (int i = 0; i < INBOX_SIZE; ++i) {
+    ring.msg[i].valid = false;
+    inboxListAppend(ring, ring.freeList, i);
+  }
+}
+
+int inboxRingAlloc(InboxRing& ring) {
+  if (ring.freeList.head == INBOX_NIL) {
+    inboxRingUnlink(ring, ring.order.head);
+  }
+  return ring.freeList.head;
+}
+
+void inboxRingLinkNewest(InboxRing& ring, int slot) {
+  inboxListRemove(ring, ring.freeList, slot);
+  inboxListAppend(ring, ring.order, slot);
+  ring.msg[slot].valid = true;
+  ring.count++;
+}
+
+void inboxRingUnlink(InboxRing& ring, int slot) {
+  if (!ring.msg[slot].valid) {
+    return;
+  }
+  inboxListRemove(ring, ring.order, slot);
+  inboxListAppend(ring, ring.freeList, slot);
+  ring.msg[slot].valid = false;
+  ring.count--;
+}
+
+void inboxRingSetText(InboxRing& ring, int slot, const char* text, size_t len) {
+  if (len > INBOX_TEXT_MAX) {
+    len = INBOX_TEXT_MAX;
+  }
+  textPack(ring.text[slot], text, len);
+  ring.msg[slot].textLen = (uint8_t)len;
+}
+
+void inboxRingSetPackedText(InboxRing& ring, int slot, const uint8_t* packed, size_t len) {
+  if (len > INBOX_TEXT_MAX) {
+    len = INBOX_TEXT_MAX;
+  }
+  memcpy(ring.text[slot], packed, TEXT_PACKED_LEN(len));
+  ring.msg[slot].textLen = (uint8_t)len;
+}
+
+int inboxRingPush(InboxRing& ring, const PageMessage& msg, const char* text, size_t len) {
+  int slot = inboxRingAlloc(ring);
+  ring.msg[slot] = msg;
+  inboxRingSetText(ring, slot, text, len);
+  inboxRingLinkNewest(ring, slot);
+  return slot;
+}
+
+void inboxRingRestore(InboxRing& ring, int slot, const PageMessage& msg, const char* text, size_t len) {
+  inboxRingUnlink(ring, slot);  // slot was reused at runtime → its old message is gone
+  ring.msg[slot] = msg;
+  inboxRingSetText(ring, slot, text, len);
+  inboxRingLinkNewest(ring, slot);
+}
+
+void inboxRingRestorePacked(InboxRing& ring, int slot, const PageMessage& msg, const uint8_t* packed,
+                            size_t len) {
+  inboxRingUnlink(ring, slot);
+  ring.msg[slot] = msg;
+  inboxRingSetPackedText(ring, slot, packed, len);
+  inboxRingLinkNewest(ring, slot);
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+// Inbox storage in RAM: fixed message slots with a text arena, kept in
+// chronological order by a doubly-linked list over the slots
+// (head = oldest, tail = newest). Unused slots sit on a second list that
+// shares the same links, so insert, delete and next/prev are all O(1).
+// No locking here: the firmware wraps every change in inboxLock().
+
+#include <stddef.h>
+#include <stdint.h>
+#include "pager_time.h"
+#include "text_pack.h"
+
+// Messages kept in RAM and in the inbox file
+#ifndef INBOX_SIZE
+#define INBOX_SIZE 64
+#endif
+
+// Longest page text we keep. DAPNET limits alphanumeric pages to 80 characters,
+// longer transmissions are truncated.
+#ifndef INBOX_TEXT_MAX
+#define INBOX_TEXT_MAX 80
+#endif
+
+static_assert(INBOX_SIZE <= 255, "slots are stored as one byte");
+static_assert(INBOX_TEXT_MAX <= 255, "PageMessage::textLen is 8 bit");
+
+// Bytes per text block (7 bits per character, text_pack.h)
+const size_t INBOX_TEXT_PACKED = TEXT_PACKED_LEN(INBOX_TEXT_MAX);
+
+// RIC table index used when a stored page matches no subscribed RIC anymore
+const uint8_t RIC_INDEX_NONE = 0xFF;
+
+struct PageMessage {
+  uint32_t  addr;
+  uint8_t   ricIndex;  // RIC table entry (ric_table.h) or RIC_INDEX_NONE
+  uint8_t   textLen;   // characters in InboxRing::text[slot]
+  uint32_t  time;      // packPagerTime() of the local receive time, 0 = none
+  bool      valid;
+};
+
+const int16_t INBOX_NIL = -1;
+
+struct InboxList {
+  int16_t head;
+  int16_t tail;
+};
+
+struct InboxRing {
+  PageMessage msg[INBOX_SIZE];
+
+  // One fixed text block per slot, packed (text_pack.h, no terminator), so
+  // storing a page never touches the heap and the worst-case RAM use is
+  // fixed at build time
+  uint8_t text[INBOX_SIZE][INBOX_TEXT_PACKED];
+
+  int16_t   prev[INBOX_SIZE];
+  int16_t   next[INBOX_SIZE];
+  InboxList order;     // valid messages, oldest first
+  InboxList freeList;  // unused slots
+  int       count;     // number of valid messages
+};
+
+// Empty the inbox, all slots free
+void inboxRingReset(InboxRing& ring);
+
+// Slot for a new message: a free one, or the oldest message when the inbox
+// is full (that message is dropped)
+int inboxRingAlloc(InboxRing& ring);
+
+// Take slot off the free list and link it as the newest message
+void inboxRingLinkNewest(InboxRing& ring, int slot);
+
+// Unlink a message and return its slot to the free list (no-op if free)
+void inboxRingUnlink(InboxRing& ring, int slot);
+
+// Pack text into the arena block of slot, truncated to INBOX_TEXT_MAX
+void inboxRingSetText(InboxRing& ring, int slot, const char* text, size_t len);
+
+// Copy len characters of already packed text into the arena block of slot
+void inboxRingSetPackedText(InboxRing& ring, int slot, const uint8_t* packed, size_t len);
+
+// Store msg with text as the newest message, returns its slot
+int inboxRingPush(InboxRing& ring, const PageMessage& msg, const char* text, size_t len);
+
+// Replay a journal "add": the message lands in the slot it had at runtime
+// (dropping what was there) and becomes the newest one
+void inboxRingRestore(InboxRing& ring, int slot, const PageMessage& msg, const char* text, size_t len);
+
+// Same with packed text (records of the current file format)
+void inboxRingRestorePacked(InboxRing& ring, int slot, const PageMessage& msg, const uint8_t* packed,
+                            size_t len);
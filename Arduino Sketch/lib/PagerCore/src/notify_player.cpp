@@ -0,0 +1,100 @@
+#include "notify_player.h"
+
+static void notifyAppend(NotifyPattern& p, uint16_t freqHz, bool led, uint32_t ms) {
+  if (p.count > 0) {
+    NotifyStep& last = p.steps[p.count - 1];
+    if (last.freqHz == freqHz && last.led == led && last.ms + ms <= 0xFFFF) {
+      last.ms = (uint16_t)(last.ms + ms);
+      return;
+    }
+  }
+  // Durations past 16 bits take several steps
+  while (ms > 0 && p.count < NOTIFY_STEPS_MAX) {
+    NotifyStep& s = p.steps[p.count++];
+    s.freqHz      = freqHz;
+    s.led         = led;
+    s.ms          = ms > 0xFFFF ? 0xFFFF : (uint16_t)ms;
+    ms -= s.ms;
+  }
+}
+
+void notifyBuildRing(NotifyPattern& p, const int* notes, int noteCount, uint16_t stepMs, int ledSteps) {
+  p.count = 0;
+  int steps = ledSteps > noteCount ? ledSteps : noteCount;
+  for (int i = 0; i < steps; ++i) {
+    int freq = i < noteCount ? notes[i] : 0;
+    notifyAppend(p, freq > 0 && freq <= 0xFFFF ? (uint16_t)freq : 0, i < ledSteps && (i % 2) == 0, stepMs);
+  }
+}
+
+void notifyBuildReminder(NotifyPattern& p, uint32_t intervalMs, uint16_t pulseMs) {
+  p.count = 0;
+  notifyAppend(p, 0, false, intervalMs);
+  notifyAppend(p, 0, true, pulseMs);
+}
+
+uint32_t notifyPatternMs(const NotifyPattern& p) {
+  uint32_t ms = 0;
+  for (int i = 0; i < p.count; ++i) {
+    ms += p.steps[i].ms;
+  }
+  return ms;
+}
+
+void notifyPlayerReset(NotifyPlayer& n) {
+  n.ring         = nullptr;
+  n.ringPriority = 0;
+  n.reminder     = nullptr;
+  n.step         = 0;
+  n.rings        = 0;
+  n.preempted    = 0;
+  n.refused      = 0;
+}
+
+bool notifyPlayerRing(NotifyPlayer& n, const NotifyPattern* p, uint8_t priority) {
+  if (n.ring != nullptr) {
+    if (priority < n.ringPriority) {
+      n.refused++;
+      return false;
+    }
+    n.preempted++;
+  }
+  n.ring         = p;
+  n.ringPriority = priority;
+  n.step         = 0;
+  n.rings++;
+  return true;
+}
+
+void notifyPlayerReminder(NotifyPlayer& n, const NotifyPattern* p) {
+  if (n.ring == nullptr && p != n.reminder) {
+    n.step = 0;
+  }
+  n.reminder = p;
+}
+
+void notifyPlayerStopRing(NotifyPlayer& n) {
+  if (n.ring != nullptr) {
+    n.ring = nullptr;
+    n.step = 0;
+  }
+}
+
+bool notifyPlayerNext(NotifyPlayer& n, NotifyStep& out) {
+  if (n.ring != nullptr) {
+    if (n.step < n.ring->count) {
+      out = n.ring->steps[n.step++];
+      return true;
+    }
+    n.ring = nullptr;
+    n.step = 0;
+  }
+  if (n.reminder != nullptr && n.reminder->count > 0) {
+    if (n.step >= n.reminder->count) {
+      n.step = 0;
+    }
+    out = n.reminder->steps[n.step++];
+    return true;
+  }
+  return false;
+}
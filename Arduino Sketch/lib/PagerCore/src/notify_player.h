@@ -0,0 +1,68 @@
+#pragma once
+
+// Notification playback: ringtone melodies and LED patterns flattened into
+// step lists (buzzer frequency, LED, duration) that a timer plays on its
+// own, and the player deciding which list runs. Hardware-agnostic: the
+// caller outputs each step and arms its timer for the step's duration.
+//
+// A ring plays once. A page of lower priority than the ring playing is not
+// let in, an equal or higher one starts over. The reminder is a looping
+// background pattern: it runs whenever no ring does and starts from its
+// first step each time it resumes.
+
+#include <stdint.h>
+
+// Steps in one pattern
+#ifndef NOTIFY_STEPS_MAX
+#define NOTIFY_STEPS_MAX 48
+#endif
+
+struct NotifyStep {
+  uint16_t freqHz;  // buzzer, 0 = silent
+  uint16_t ms;      // duration
+  bool     led;
+};
+
+struct NotifyPattern {
+  NotifyStep steps[NOTIFY_STEPS_MAX];
+  uint8_t    count;
+};
+
+// Ring pattern of a melody: noteCount notes (0 = rest) of stepMs each while
+// the LED toggles every stepMs, for ledSteps steps in all. Runs of equal
+// steps are merged.
+void notifyBuildRing(NotifyPattern& p, const int* notes, int noteCount, uint16_t stepMs, int ledSteps);
+
+// Reminder: LED off for intervalMs, then on for pulseMs
+void notifyBuildReminder(NotifyPattern& p, uint32_t intervalMs, uint16_t pulseMs);
+
+// Total duration in ms
+uint32_t notifyPatternMs(const NotifyPattern& p);
+
+struct NotifyPlayer {
+  const NotifyPattern* ring;      // playing once, nullptr = none
+  uint8_t              ringPriority;
+  const NotifyPattern* reminder;  // looping while no ring plays, nullptr = off
+  uint8_t              step;      // next step of the pattern playing
+  uint32_t             rings;     // rings started
+  uint32_t             preempted; // of them cut short by a later page
+  uint32_t             refused;   // pages of lower priority not let in
+};
+
+void notifyPlayerReset(NotifyPlayer& n);
+
+// Start a ring; false if a ring of higher priority is playing
+bool notifyPlayerRing(NotifyPlayer& n, const NotifyPattern* p, uint8_t priority);
+
+// Set the reminder pattern, nullptr stops it
+void notifyPlayerReminder(NotifyPlayer& n, const NotifyPattern* p);
+
+// Stop the ring playing (the reminder carries on)
+void notifyPlayerStopRing(NotifyPlayer& n);
+
+// Step to output next. false: nothing to play, buzzer and LED go off.
+bool notifyPlayerNext(NotifyPlayer& n, NotifyStep& out);
+
+inline bool notifyPlayerRinging(const NotifyPlayer& n) {
+  return n.ring != nullptr;
+}
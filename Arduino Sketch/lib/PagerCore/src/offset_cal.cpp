@@ -0,0 +1,76 @@
+#include "offset_cal.h"
+
+int32_t offsetMedian(int32_t* values, int count) {
+  // Insertion sort, count is a handful of samples
+  for (int i = 1; i < count; ++i) {
+    int32_t v = values[i];
+    int     j = i - 1;
+    while (j >= 0 && values[j] > v) {
+      values[j + 1] = values[j];
+      --j;
+    }
+    values[j + 1] = v;
+  }
+  if (count == 0) {
+    return 0;
+  }
+  return (count & 1) ? values[count / 2] : (values[count / 2 - 1] + values[count / 2]) / 2;
+}
+
+void offsetCalStart(OffsetCalibrator& c) {
+  c.count      = 0;
+  c.rounds     = 0;
+  c.totalHz    = 0;
+  c.lastMedian = 0;
+}
+
+OffsetCalStep offsetCalSample(OffsetCalibrator& c, int32_t errorHz, int32_t& adjustHz) {
+  adjustHz = 0;
+  if (errorHz > OFFSET_SAMPLE_MAX_HZ || errorHz < -OFFSET_SAMPLE_MAX_HZ) {
+    return OFFSET_CAL_WAIT;
+  }
+  c.samples[c.count++] = errorHz;
+  if (c.count < OFFSET_CAL_ROUND) {
+    return OFFSET_CAL_WAIT;
+  }
+
+  int32_t median = offsetMedian(c.samples, c.count);
+  c.count        = 0;
+  c.rounds++;
+  c.lastMedian   = median;
+  adjustHz       = median;
+  c.totalHz     += median;
+
+  bool converged = median <= OFFSET_CAL_DONE_HZ && median >= -OFFSET_CAL_DONE_HZ;
+  return (converged || c.rounds >= OFFSET_CAL_MAX_ROUNDS) ? OFFSET_CAL_DONE : OFFSET_CAL_ADJUST;
+}
+
+void offsetDriftReset(OffsetDrift& d) {
+  d.avgHz16 = 0;
+  d.samples = 0;
+}
+
+bool offsetDriftSample(OffsetDrift& d, int32_t errorHz, int32_t& adjustHz) {
+  adjustHz = 0;
+  if (errorHz > OFFSET_SAMPLE_MAX_HZ || errorHz < -OFFSET_SAMPLE_MAX_HZ) {
+    return false;
+  }
+
+  if (d.samples == 0) {
+    d.avgHz16 = errorHz * 16;
+  } else {
+    d.avgHz16 += (errorHz * 16 - d.avgHz16) >> OFFSET_DRIFT_SHIFT;
+  }
+  if (d.samples < OFFSET_DRIFT_MIN) {
+    d.samples++;
+    return false;
+  }
+
+  int32_t avg = offsetDriftHz(d);
+  if (avg <= OFFSET_DRIFT_LIMIT_HZ && avg >= -OFFSET_DRIFT_LIMIT_HZ) {
+    return false;
+  }
+  adjustHz = avg;
+  offsetDriftReset(d);
+  return true;
+}
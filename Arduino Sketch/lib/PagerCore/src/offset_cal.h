@@ -0,0 +1,52 @@
+#pragma once
+
+// Frequency offset estimation from the receiver's per-preamble frequency
+// error (SX1278 FEI). Errors are in Hz, positive = carrier above the tuned
+// frequency, so the offset has to grow by the error.
+//
+// Calibration runs in rounds: the median of OFFSET_CAL_ROUND samples is
+// applied, then the next round measures again at the new setting, until the
+// median is within OFFSET_CAL_DONE_HZ. Drift tracking keeps an exponential
+// average during normal reception and asks for a correction once it
+// exceeds OFFSET_DRIFT_LIMIT_HZ.
+
+#include <stdint.h>
+
+const int     OFFSET_CAL_ROUND      = 6;      // samples per round
+const int     OFFSET_CAL_MAX_ROUNDS = 4;
+const int32_t OFFSET_CAL_DONE_HZ    = 150;    // converged
+const int32_t OFFSET_SAMPLE_MAX_HZ  = 12000;  // beyond the RX filter: not our carrier
+const int     OFFSET_DRIFT_SHIFT    = 3;      // average over about 8 samples
+const int     OFFSET_DRIFT_MIN      = 8;      // samples before a correction
+const int32_t OFFSET_DRIFT_LIMIT_HZ = 250;
+
+enum OffsetCalStep : uint8_t {
+  OFFSET_CAL_WAIT,    // sample taken, round not complete (or sample rejected)
+  OFFSET_CAL_ADJUST,  // round complete: apply adjustHz, keep calibrating
+  OFFSET_CAL_DONE     // apply adjustHz (may be 0), calibration finished
+};
+
+struct OffsetCalibrator {
+  int32_t samples[OFFSET_CAL_ROUND];
+  int     count;
+  int     rounds;
+  int32_t totalHz;     // sum of all adjustments
+  int32_t lastMedian;  // error at the last round, for the report
+};
+
+struct OffsetDrift {
+  int32_t avgHz16;  // average error, 1/16 Hz
+  int     samples;
+};
+
+void          offsetCalStart(OffsetCalibrator& c);
+OffsetCalStep offsetCalSample(OffsetCalibrator& c, int32_t errorHz, int32_t& adjustHz);
+
+void offsetDriftReset(OffsetDrift& d);
+// True when the average asks for a correction by adjustHz (and restarts)
+bool offsetDriftSample(OffsetDrift& d, int32_t errorHz, int32_t& adjustHz);
+inline int32_t offsetDriftHz(const OffsetDrift& d) {
+  return d.avgHz16 / 16;
+}
+
+int32_t offsetMedian(int32_t* values, int count);  // reorders values
@@ -0,0 +1,56 @@
+#include "page_dedup.h"
+
+void pageDedupReset(PageDedup& d) {
+  for (PageDedupEntry& e : d.entries) {
+    e.used = false;
+  }
+  d.hits   = 0;
+  d.misses = 0;
+}
+
+uint32_t pageDedupHash(uint32_t addr, uint8_t function, const char* text, size_t len) {
+  uint32_t h = 2166136261UL;
+  for (int i = 0; i < 4; ++i) {
+    h = (h ^ ((addr >> (8 * i)) & 0xFF)) * 16777619UL;
+  }
+  h = (h ^ function) * 16777619UL;
+  for (size_t i = 0; i < len; ++i) {
+    h = (h ^ (uint8_t)text[i]) * 16777619UL;
+  }
+  return h;
+}
+
+bool pageDedupCheck(PageDedup& d, uint32_t hash, uint32_t nowMs, uint32_t windowMs) {
+  if (windowMs == 0) {
+    return false;
+  }
+
+  for (PageDedupEntry& e : d.entries) {
+    if (!e.used) {
+      continue;
+    }
+    if (nowMs - e.seenMs >= windowMs) {
+      e.used = false;  // expired, the slot is free again
+      continue;
+    }
+    if (e.hash == hash) {
+      d.hits++;
+      return true;
+    }
+  }
+
+  // A free slot, else the oldest sighting
+  int slot = 0;
+  for (int i = 0; i < PAGE_DEDUP_SLOTS; ++i) {
+    if (!d.entries[i].used) {
+      slot = i;
+      break;
+    }
+    if (nowMs - d.entries[i].seenMs > nowMs - d.entries[slot].seenMs) {
+      slot = i;
+    }
+  }
+  d.entries[slot] = { hash, nowMs, true };
+  d.misses++;
+  return false;
+}
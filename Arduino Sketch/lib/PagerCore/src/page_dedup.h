@@ -0,0 +1,36 @@
+#pragma once
+
+// Duplicate page suppression. Overlapping transmitters (and DAPNET resends)
+// deliver the same page several times within a short time; each page is
+// remembered as a 32-bit hash of address, function and text, and a page whose hash
+// was seen inside the window is a duplicate. The first sighting is what
+// counts: repeats do not extend the window, so a periodic bulletin with the
+// same text still comes through once per window.
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Pages remembered; the oldest is replaced when all are in use
+const int PAGE_DEDUP_SLOTS = 16;
+
+struct PageDedupEntry {
+  uint32_t hash;
+  uint32_t seenMs;  // first sighting (millis())
+  bool     used;
+};
+
+struct PageDedup {
+  PageDedupEntry entries[PAGE_DEDUP_SLOTS];
+  uint32_t       hits;    // duplicates suppressed
+  uint32_t       misses;  // new pages
+};
+
+void pageDedupReset(PageDedup& d);
+
+// FNV-1a over the address (little endian), the function bits and the text;
+// function A and D of one RIC can be different subscriptions
+uint32_t pageDedupHash(uint32_t addr, uint8_t function, const char* text, size_t len);
+
+// True if the page was seen less than windowMs ago; a new page is
+// remembered. windowMs 0 lets everything through.
+bool pageDedupCheck(PageDedup& d, uint32_t hash, uint32_t nowMs, uint32_t windowMs);
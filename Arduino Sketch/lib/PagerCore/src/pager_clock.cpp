@@ -0,0 +1,65 @@
+#include "pager_clock.h"
+
+void pagerClockReset(PagerClock& c) {
+  c.valid       = false;
+  c.baseUtcUs   = 0;
+  c.baseMonoUs  = 0;
+  c.slewUs      = 0;
+  c.lastErrorMs = 0;
+  c.syncs       = 0;
+  c.steps       = 0;
+}
+
+int64_t pagerClockMicros(const PagerClock& c, int64_t monoUs) {
+  int64_t elapsed = monoUs - c.baseMonoUs;
+  int64_t maxSlew = elapsed / PAGER_CLOCK_SLEW_DIV;
+  int64_t slew    = c.slewUs;
+  if (slew > maxSlew) {
+    slew = maxSlew;
+  } else if (slew < -maxSlew) {
+    slew = -maxSlew;
+  }
+  return c.baseUtcUs + elapsed + slew;
+}
+
+PagerClockSync pagerClockSync(PagerClock& c, int64_t monoUs, PagerEpoch utc, uint32_t resolutionS,
+                              uint32_t stepLimitS) {
+  int64_t beaconUs = (int64_t)utc * 1000000;
+  c.syncs++;
+
+  if (!c.valid) {
+    c.valid       = true;
+    c.baseUtcUs   = beaconUs;
+    c.baseMonoUs  = monoUs;
+    c.slewUs      = 0;
+    c.lastErrorMs = 0;
+    c.steps++;
+    return PAGER_CLOCK_SET;
+  }
+
+  // Distance to the window the beacon names; a running slew is superseded
+  int64_t now   = pagerClockMicros(c, monoUs);
+  int64_t endUs = beaconUs + (int64_t)resolutionS * 1000000;
+  int64_t error = 0;
+  if (now < beaconUs) {
+    error = beaconUs - now;
+  } else if (now >= endUs) {
+    error = endUs - 1 - now;
+  }
+  int64_t errorMs = error / 1000;
+  c.lastErrorMs   = errorMs > INT32_MAX ? INT32_MAX : errorMs < -INT32_MAX ? -INT32_MAX : (int32_t)errorMs;
+  c.baseUtcUs   = now;
+  c.baseMonoUs  = monoUs;
+  c.slewUs      = 0;
+
+  if (error > (int64_t)stepLimitS * 1000000 || error < -(int64_t)stepLimitS * 1000000) {
+    c.baseUtcUs = beaconUs;
+    c.steps++;
+    return PAGER_CLOCK_STEPPED;
+  }
+  if (error == 0) {
+    return PAGER_CLOCK_IN_SYNC;
+  }
+  c.slewUs = error;
+  return PAGER_CLOCK_SLEWING;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+// Pager clock: UTC from a monotonic microsecond counter (esp_timer on the
+// target) and the time beacons. The first beacon, or one that is further off
+// than the step limit, sets the clock outright. Smaller errors are slewed
+// out: the clock runs up to 1/PAGER_CLOCK_SLEW_DIV faster or slower until
+// the error is gone, so message timestamps never jump and the clock never
+// runs backwards.
+
+#include <stdint.h>
+#include "pager_time.h"
+
+// Slew rate: at most 1 s of correction per PAGER_CLOCK_SLEW_DIV seconds
+#ifndef PAGER_CLOCK_SLEW_DIV
+#define PAGER_CLOCK_SLEW_DIV 20
+#endif
+
+struct PagerClock {
+  bool     valid;
+  int64_t  baseUtcUs;   // UTC in µs since 2000 at baseMonoUs
+  int64_t  baseMonoUs;  // counter value of the last sync
+  int64_t  slewUs;      // correction spread out from baseMonoUs on
+  int32_t  lastErrorMs; // beacon minus clock at the last sync
+  uint32_t syncs;       // beacons taken
+  uint32_t steps;       // of them set the clock outright
+};
+
+enum PagerClockSync {
+  PAGER_CLOCK_SET,      // first beacon
+  PAGER_CLOCK_STEPPED,  // error above the step limit, clock set
+  PAGER_CLOCK_SLEWING,  // error is being slewed out
+  PAGER_CLOCK_IN_SYNC   // clock within the beacon's resolution
+};
+
+void pagerClockReset(PagerClock& c);
+
+// UTC in µs since 2000 at counter value monoUs (c must be valid, monoUs not
+// before the last sync)
+int64_t pagerClockMicros(const PagerClock& c, int64_t monoUs);
+
+inline PagerEpoch pagerClockNow(const PagerClock& c, int64_t monoUs) {
+  return (PagerEpoch)(pagerClockMicros(c, monoUs) / 1000000);
+}
+
+// Take a beacon received at monoUs. It names the instant utc .. utc +
+// resolutionS (a beacon with minutes only stands for the whole minute); a
+// clock inside that window counts as in sync.
+PagerClockSync pagerClockSync(PagerClock& c, int64_t monoUs, PagerEpoch utc, uint32_t resolutionS,
+                              uint32_t stepLimitS);
@@ -0,0 +1,142 @@
+#include "pager_time.h"
+
+// Days between 2000-01-01 and the given date (proleptic Gregorian calendar,
+// H. Hinnant's days_from_civil with the year shifted to start in March)
+static int32_t pagerDaysFromCivil(int year, int month, int day) {
+  year -= month <= 2;
+  int32_t  era = (year >= 0 ? year : year - 399) / 400;
+  uint32_t yoe = (uint32_t)(year - era * 400);
+  uint32_t doy = (153 * (uint32_t)(month > 2 ? month - 3 : month + 9) + 2) / 5 + (uint32_t)day - 1;
+  uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + (int32_t)doe - 730425;  // 730425 = 0000-03-01 .. 2000-01-01
+}
+
+static void pagerCivilFromDays(int32_t days, int& year, int& month, int& day) {
+  days += 730425;
+  int32_t  era = (days >= 0 ? days : days - 146096) / 146097;
+  uint32_t doe = (uint32_t)(days - era * 146097);
+  uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  uint32_t mp  = (5 * doy + 2) / 153;
+
+  day   = (int)(doy - (153 * mp + 2) / 5 + 1);
+  month = (int)(mp < 10 ? mp + 3 : mp - 9);
+  year  = (int)yoe + era * 400 + (month <= 2);
+}
+
+bool pagerIsLeapYear(int year) {
+  return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+int pagerDaysInMonth(int year, int month) {
+  switch (month) {
+    case 4:
+    case 6:
+    case 9:
+    case 11:
+      return 30;
+    case 2:
+      return pagerIsLeapYear(year) ? 29 : 28;
+    default:
+      return 31;
+  }
+}
+
+bool pagerTimeInRange(const PagerTime& t) {
+  return t.year >= PAGER_EPOCH_YEAR && t.year < PAGER_EPOCH_YEAR + 136 && t.month >= 1 && t.month <= 12 &&
+         t.day >= 1 && t.day <= pagerDaysInMonth(t.year, t.month) && t.hour >= 0 && t.hour < 24 &&
+         t.minute >= 0 && t.minute < 60 && t.second >= 0 && t.second < 60;
+}
+
+PagerEpoch pagerTimeToEpoch(const PagerTime& t) {
+  uint32_t days = (uint32_t)pagerDaysFromCivil(t.year, t.month, t.day);
+  return days * 86400UL + (uint32_t)(t.hour * 3600 + t.minute * 60 + t.second);
+}
+
+void pagerTimeFromEpoch(PagerEpoch epoch, PagerTime& t) {
+  uint32_t secs = epoch % 86400UL;
+  pagerCivilFromDays((int32_t)(epoch / 86400UL), t.year, t.month, t.day);
+  t.hour   = (int)(secs / 3600);
+  t.minute = (int)(secs / 60 % 60);
+  t.second = (int)(secs % 60);
+  t.valid  = true;
+}
+
+uint32_t packPagerTime(const PagerTime& t) {
+  if (!t.valid) {
+    return 0;
+  }
+  return ((uint32_t)(t.year - 2000) & 0x3F) << 26 |
+         ((uint32_t)t.month & 0x0F) << 22 |
+         ((uint32_t)t.day & 0x1F) << 17 |
+         ((uint32_t)t.hour & 0x1F) << 12 |
+         ((uint32_t)t.minute & 0x3F) << 6 |
+         ((uint32_t)t.second & 0x3F);
+}
+
+void unpackPagerTime(uint32_t packed, PagerTime& t) {
+  t.year   = 2000 + (int)((packed >> 26) & 0x3F);
+  t.month  = (int)((packed >> 22) & 0x0F);
+  t.day    = (int)((packed >> 17) & 0x1F);
+  t.hour   = (int)((packed >> 12) & 0x1F);
+  t.minute = (int)((packed >> 6) & 0x3F);
+  t.second = (int)(packed & 0x3F);
+  t.valid  = (packed != 0);
+}
+
+void pagerTimeAddMinutes(PagerTime& t, int deltaMin) {
+  if (!t.valid || deltaMin == 0 || !pagerTimeInRange(t)) {
+    return;
+  }
+
+  int64_t epoch = (int64_t)pagerTimeToEpoch(t) + (int64_t)deltaMin * 60;
+  pagerTimeFromEpoch(epoch > 0 ? (PagerEpoch)epoch : 0, t);
+}
+
+void pagerTimeTickSecond(PagerTime& t) {
+  if (pagerTimeInRange(t)) {
+    pagerTimeFromEpoch(pagerTimeToEpoch(t) + 1, t);
+  }
+}
+
+// Day (since 2000) of the n-th Sunday of month (n = 0: the last one)
+static int32_t pagerSunday(int year, int month, int n) {
+  if (n == 0) {
+    int32_t last = pagerDaysFromCivil(year, month, pagerDaysInMonth(year, month));
+    return last - (last + 6) % 7;  // 2000-01-01 was a Saturday
+  }
+  int32_t first = pagerDaysFromCivil(year, month, 1);
+  return first + (7 - (first + 6) % 7) % 7 + 7 * (n - 1);
+}
+
+int pagerUtcOffsetMinutes(PagerEpoch utc, int standardMinutes, uint8_t rule) {
+  if (rule != PAGER_DST_EU && rule != PAGER_DST_US) {
+    return standardMinutes;
+  }
+
+  PagerTime t;
+  pagerTimeFromEpoch(utc, t);
+
+  int64_t start;  // UTC seconds
+  int64_t end;
+  if (rule == PAGER_DST_EU) {
+    start = (int64_t)pagerSunday(t.year, 3, 0) * 86400 + 3600;
+    end   = (int64_t)pagerSunday(t.year, 10, 0) * 86400 + 3600;
+  } else {
+    // 02:00 local standard time, 02:00 local daylight time
+    start = (int64_t)pagerSunday(t.year, 3, 2) * 86400 + 7200 - standardMinutes * 60;
+    end   = (int64_t)pagerSunday(t.year, 11, 1) * 86400 + 7200 - (standardMinutes + 60) * 60;
+  }
+  return (int64_t)utc >= start && (int64_t)utc < end ? standardMinutes + 60 : standardMinutes;
+}
+
+PagerEpoch pagerLocalToUtc(PagerEpoch local, int standardMinutes, uint8_t rule) {
+  // The offset at local - standard offset is the right one: the switches lie
+  // at least an hour away from the instants that could be mistaken
+  int64_t guess = (int64_t)local - standardMinutes * 60;
+  if (guess < 0) {
+    return 0;
+  }
+  int64_t utc = (int64_t)local - pagerUtcOffsetMinutes((PagerEpoch)guess, standardMinutes, rule) * 60;
+  return utc > 0 ? (PagerEpoch)utc : 0;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+// Pager clock date/time and its arithmetic. Hardware-agnostic: no Arduino
+// headers, so the native test environment builds it as is.
+//
+// The clock itself is a count of seconds since 2000-01-01 00:00:00 UTC
+// (PagerEpoch); PagerTime is its broken-down form, computed only where
+// date fields are shown or stored. Conversions in both directions are
+// O(1) and follow the Gregorian calendar.
+
+#include <stdint.h>
+
+struct PagerTime {
+  int  year;
+  int  month;
+  int  day;
+  int  hour;
+  int  minute;
+  int  second;
+  bool valid;
+};
+
+// Seconds since 2000-01-01 00:00:00 (lasts until 2136)
+typedef uint32_t PagerEpoch;
+
+const int PAGER_EPOCH_YEAR = 2000;
+
+bool pagerIsLeapYear(int year);
+
+// Days of month (1..12) in year
+int pagerDaysInMonth(int year, int month);
+
+// Fields within their ranges, year 2000 or later
+bool pagerTimeInRange(const PagerTime& t);
+
+// Broken-down time to epoch seconds and back; t must be in range
+PagerEpoch pagerTimeToEpoch(const PagerTime& t);
+void       pagerTimeFromEpoch(PagerEpoch epoch, PagerTime& t);
+
+// Pack a timestamp into 32 bits (0 = no time):
+// year-2000 (6) | month (4) | day (5) | hour (5) | minute (6) | second (6)
+uint32_t packPagerTime(const PagerTime& t);
+void     unpackPagerTime(uint32_t packed, PagerTime& t);
+
+// Add minutes (either sign), carrying into days, months and years
+void pagerTimeAddMinutes(PagerTime& t, int deltaMin);
+
+// Advance by one second
+void pagerTimeTickSecond(PagerTime& t);
+
+// Daylight saving time rules for the local offset
+enum PagerDstRule : uint8_t {
+  PAGER_DST_NONE,
+  PAGER_DST_EU,  // last Sunday of March 01:00 UTC .. last Sunday of October 01:00 UTC
+  PAGER_DST_US   // second Sunday of March 02:00 .. first Sunday of November 02:00 local
+};
+
+// Offset of local time from UTC at the instant utc: the standard offset,
+// plus one hour while daylight saving time is in effect under rule
+int pagerUtcOffsetMinutes(PagerEpoch utc, int standardMinutes, uint8_t rule);
+
+// UTC of a local time (time beacons sent in local time). The hour that
+// repeats when daylight saving time ends is read as standard time.
+PagerEpoch pagerLocalToUtc(PagerEpoch local, int standardMinutes, uint8_t rule);
@@ -0,0 +1,81 @@
+#include "pocsag_bch.h"
+
+#include "pocsag_codeword.h"
+
+namespace {
+
+constexpr uint32_t BCH_GENERATOR   = 0x769;
+constexpr uint16_t SYNDROME_PARITY = 0x400;  // parity bit of the syndrome
+
+constexpr uint32_t bchRemainder(uint32_t bits31) {
+  for (int bit = 30; bit >= 10; --bit) {
+    if (bits31 & (1UL << bit)) {
+      bits31 ^= BCH_GENERATOR << (bit - 10);
+    }
+  }
+  return bits31 & 0x3FF;
+}
+
+// Syndrome of a single bit error at codeword bit `pos` (0 = parity bit)
+constexpr uint16_t bitSyndrome(int pos) {
+  return (uint16_t)((pos == 0 ? 0 : bchRemainder(1UL << (pos - 1))) | SYNDROME_PARITY);
+}
+
+struct BchTables {
+  uint16_t bytes[4][256];  // syndrome of byte i of the codeword
+  uint16_t errors[2048];   // (pos1 + 1) | (pos2 + 1) << 6, 0 = not correctable
+};
+
+constexpr BchTables buildTables() {
+  BchTables t{};
+  for (int byte = 0; byte < 4; ++byte) {
+    for (int v = 0; v < 256; ++v) {
+      uint16_t s = 0;
+      for (int bit = 0; bit < 8; ++bit) {
+        if (v & (1 << bit)) {
+          s ^= bitSyndrome(byte * 8 + bit);
+        }
+      }
+      t.bytes[byte][v] = s;
+    }
+  }
+  for (int i = 0; i < 32; ++i) {
+    t.errors[bitSyndrome(i)] = (uint16_t)(i + 1);
+    for (int j = i + 1; j < 32; ++j) {
+      t.errors[bitSyndrome(i) ^ bitSyndrome(j)] = (uint16_t)((i + 1) | (j + 1) << 6);
+    }
+  }
+  return t;
+}
+
+constexpr BchTables TABLES = buildTables();
+
+static_assert(TABLES.errors[0] == 0, "syndrome 0 must not be a correction");
+
+}  // namespace
+
+uint16_t pocsagSyndrome(uint32_t cw) {
+  return TABLES.bytes[0][cw & 0xFF] ^ TABLES.bytes[1][(cw >> 8) & 0xFF] ^
+         TABLES.bytes[2][(cw >> 16) & 0xFF] ^ TABLES.bytes[3][cw >> 24];
+}
+
+int pocsagCorrectCodeword(uint32_t& cw) {
+  uint16_t s = pocsagSyndrome(cw);
+  if (s == 0) {
+    return 0;
+  }
+  uint16_t e = TABLES.errors[s];
+  if (e == 0) {
+    return -1;
+  }
+  cw ^= 1UL << ((e & 0x3F) - 1);
+  if (e >> 6) {
+    cw ^= 1UL << ((e >> 6) - 1);
+    return 2;
+  }
+  return 1;
+}
+
+bool pocsagIsSyncWord(uint32_t w, int maxErrors) {
+  return pocsagBitErrors(w, POCSAG_SYNC_WORD) <= maxErrors;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+// BCH(31,21) + parity error correction for POCSAG codewords.
+// The syndrome is the 10-bit BCH remainder plus the parity bit; both are
+// linear, so it is the XOR of per-byte lookups. A second table maps every
+// syndrome of a 1- or 2-bit error to its bit positions. With the parity bit
+// the code has distance 6: 3-bit errors are always detected, never "fixed".
+// Both tables are built at compile time (constexpr, C++14 or later) and
+// take 6 KB of flash.
+
+#include <stdint.h>
+
+// Sync word bit errors tolerated while hunting, and where the next batch
+// is expected (bit-aligned already, so a false match is much less likely)
+const int POCSAG_SYNC_HUNT_ERRORS  = 2;
+const int POCSAG_SYNC_BATCH_ERRORS = 4;
+
+// 11-bit syndrome, 0 for a valid codeword
+uint16_t pocsagSyndrome(uint32_t cw);
+
+// Correct up to 2 bit errors in place. Returns the number of bits flipped,
+// or -1 if the codeword is not correctable (cw is left as received).
+int pocsagCorrectCodeword(uint32_t& cw);
+
+inline int pocsagBitErrors(uint32_t a, uint32_t b) {
+  return __builtin_popcount(a ^ b);
+}
+
+// Errored sync word: within `maxErrors` bits of POCSAG_SYNC_WORD
+bool pocsagIsSyncWord(uint32_t w, int maxErrors);
@@ -0,0 +1,43 @@
+#include "pocsag_codeword.h"
+
+#include "pocsag_bch.h"
+
+static const uint32_t BCH_GENERATOR = 0x769;  // 11 bits, degree 10
+
+// Remainder of the 31 code bits (cw >> 1) divided by the generator
+static uint32_t bchRemainder(uint32_t bits31) {
+  for (int bit = 30; bit >= 10; --bit) {
+    if (bits31 & (1UL << bit)) {
+      bits31 ^= BCH_GENERATOR << (bit - 10);
+    }
+  }
+  return bits31 & 0x3FF;
+}
+
+static uint32_t parity32(uint32_t v) {
+  v ^= v >> 16;
+  v ^= v >> 8;
+  v ^= v >> 4;
+  v ^= v >> 2;
+  v ^= v >> 1;
+  return v & 1;
+}
+
+uint32_t pocsagEncodeCodeword(uint32_t cw) {
+  uint32_t data21 = cw >> 11;
+  uint32_t bits31 = (data21 << 10) | bchRemainder(data21 << 10);
+  cw              = bits31 << 1;
+  return cw | parity32(cw);
+}
+
+bool pocsagCodewordValid(uint32_t cw) {
+  return pocsagSyndrome(cw) == 0;
+}
+
+uint32_t pocsagAddressWord(uint32_t ric, uint8_t function) {
+  return pocsagEncodeCodeword(((ric >> 3) & 0x3FFFF) << 13 | (uint32_t)(function & 3) << 11);
+}
+
+uint32_t pocsagMessageWord(uint32_t data20) {
+  return pocsagEncodeCodeword(0x80000000UL | (data20 & 0xFFFFF) << 11);
+}
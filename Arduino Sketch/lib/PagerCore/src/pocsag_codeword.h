@@ -0,0 +1,34 @@
+#pragma once
+
+// POCSAG codeword layout (ITU-R M.584):
+//   bit 31      0 = address, 1 = message
+//   bits 30..11 address: RIC bits 20..3 (18) + function (2); message: 20 data bits
+//   bits 10..1  BCH(31,21) check bits, generator x^10+x^9+x^8+x^6+x^5+x^3+1
+//   bit 0       even parity over the whole codeword
+// A batch is the sync word followed by 8 frames of 2 codewords; a RIC's
+// address codeword goes into frame (RIC & 7).
+
+#include <stdint.h>
+
+const uint32_t POCSAG_SYNC_WORD     = 0x7CD215D8;
+const uint32_t POCSAG_IDLE_WORD     = 0x7A89C197;
+const int      POCSAG_FRAMES        = 8;
+const int      POCSAG_BATCH_WORDS   = 2 * POCSAG_FRAMES;
+const uint32_t POCSAG_BATCH_BITS    = 32 * (POCSAG_BATCH_WORDS + 1);
+const uint32_t POCSAG_PREAMBLE_BITS = 576;  // 1010... before the first sync word
+
+const uint8_t POCSAG_FUNC_NUMERIC = 0;
+const uint8_t POCSAG_FUNC_ALPHA   = 3;
+
+// Complete a codeword from its upper 21 bits (bits 31..11 of cw, rest ignored)
+uint32_t pocsagEncodeCodeword(uint32_t cw);
+
+// BCH syndrome zero and even parity
+bool pocsagCodewordValid(uint32_t cw);
+
+uint32_t pocsagAddressWord(uint32_t ric, uint8_t function);
+uint32_t pocsagMessageWord(uint32_t data20);
+
+inline bool pocsagIsMessageWord(uint32_t cw) {
+  return (cw & 0x80000000UL) != 0;
+}
@@ -0,0 +1,157 @@
+#include "pocsag_decoder.h"
+
+#include <string.h>
+#include "pocsag_bch.h"
+
+static const char NUMERIC_CHARS[16] = {
+  '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '*', 'U', ' ', '-', ']', '['
+};
+
+void pocsagDecoderInit(PocsagDecoder& dec, PocsagPageHandler handler, void* ctx, bool correct) {
+  memset(&dec, 0, sizeof(dec));
+  dec.handler = handler;
+  dec.ctx     = ctx;
+  dec.correct = correct;
+}
+
+// Sync word at the current bit position; errored ones only with correction
+static bool decIsSync(PocsagDecoder& dec, int maxErrors) {
+  if (dec.shift == POCSAG_SYNC_WORD) {
+    return true;
+  }
+  if (dec.correct && pocsagIsSyncWord(dec.shift, maxErrors)) {
+    dec.correctedSyncs++;
+    return true;
+  }
+  return false;
+}
+
+static void decFinishPage(PocsagDecoder& dec) {
+  if (!dec.pageOpen) {
+    return;
+  }
+  dec.pageOpen = false;
+
+  // Padding of the last codeword decodes as NUL/EOT (or spaces for numeric pages)
+  PocsagPage& p = dec.page;
+  while (p.len > 0 && (p.text[p.len - 1] == '\0' || p.text[p.len - 1] == 0x04 ||
+                       (p.function == POCSAG_FUNC_NUMERIC && p.text[p.len - 1] == ' '))) {
+    p.len--;
+  }
+  p.text[p.len] = '\0';
+
+  dec.pages++;
+  if (dec.handler) {
+    dec.handler(p, dec.ctx);
+  }
+}
+
+static void decAppendData(PocsagDecoder& dec, uint32_t cw) {
+  PocsagPage& p       = dec.page;
+  const bool  alpha   = (p.function != POCSAG_FUNC_NUMERIC);
+  const int   symBits = alpha ? 7 : 4;
+
+  for (int bit = 30; bit >= 11; --bit) {
+    dec.symbol |= ((cw >> bit) & 1) << dec.symbolBits;
+    if (++dec.symbolBits < symBits) {
+      continue;
+    }
+    if (p.len < INBOX_TEXT_MAX) {
+      p.text[p.len++] = alpha ? (char)dec.symbol : NUMERIC_CHARS[dec.symbol & 0x0F];
+    }
+    dec.symbol     = 0;
+    dec.symbolBits = 0;
+  }
+  p.endBit = dec.bitIndex;
+}
+
+static void decCodeword(PocsagDecoder& dec, uint32_t cw) {
+  int  frame = dec.word / 2;
+  bool valid;
+
+  if (dec.correct) {
+    int fixed = pocsagCorrectCodeword(cw);
+    valid     = fixed >= 0;
+    if (fixed > 0) {
+      dec.correctedWords++;
+      dec.correctedBits += (uint32_t)fixed;
+    }
+  } else {
+    valid = pocsagCodewordValid(cw);
+  }
+
+  dec.codewords++;
+  if (!valid) {
+    dec.badCodewords++;
+  }
+
+  if (valid && cw == POCSAG_IDLE_WORD) {
+    decFinishPage(dec);
+    return;
+  }
+
+  if (pocsagIsMessageWord(cw)) {
+    if (dec.pageOpen) {
+      if (!valid && dec.page.badWords < 0xFF) {
+        dec.page.badWords++;
+      }
+      decAppendData(dec, cw);
+    }
+    return;
+  }
+
+  // Address codeword: ends the previous page, a bad one loses the new page
+  decFinishPage(dec);
+  if (!valid) {
+    return;
+  }
+
+  PocsagPage& p  = dec.page;
+  p.addr         = ((cw >> 13) & 0x3FFFF) << 3 | (uint32_t)frame;
+  p.function     = (uint8_t)((cw >> 11) & 3);
+  p.len          = 0;
+  p.badWords     = 0;
+  p.endBit       = dec.bitIndex;
+  dec.symbol     = 0;
+  dec.symbolBits = 0;
+  dec.pageOpen   = true;
+}
+
+void pocsagDecoderPushBit(PocsagDecoder& dec, uint8_t bit) {
+  dec.shift = (dec.shift << 1) | (bit & 1);
+  dec.bitIndex++;
+
+  if (!dec.inSync) {
+    if (decIsSync(dec, POCSAG_SYNC_HUNT_ERRORS)) {
+      dec.inSync   = true;
+      dec.bitCount = 0;
+      dec.word     = 0;
+      dec.syncs++;
+    }
+    return;
+  }
+
+  if (++dec.bitCount < 32) {
+    return;
+  }
+  dec.bitCount = 0;
+
+  if (dec.word == POCSAG_BATCH_WORDS) {
+    if (decIsSync(dec, POCSAG_SYNC_BATCH_ERRORS)) {
+      dec.word = 0;
+    } else {
+      // End of transmission (or a corrupted sync word): back to hunting
+      decFinishPage(dec);
+      dec.inSync = false;
+      dec.syncLosses++;
+    }
+    return;
+  }
+
+  decCodeword(dec, dec.shift);
+  dec.word++;
+}
+
+void pocsagDecoderFlush(PocsagDecoder& dec) {
+  decFinishPage(dec);
+}
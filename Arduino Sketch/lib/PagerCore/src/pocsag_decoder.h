@@ -0,0 +1,58 @@
+#pragma once
+
+// Reference POCSAG bit stream decoder: sync hunting, batch framing and
+// message assembly, one bit at a time. Without correction, codewords with
+// BCH/parity errors stay as received: a bad address word loses the page, a
+// bad message word garbles it (counted in badWords) - the behaviour of
+// RadioLib's PagerClient. With correction, 1-2 bit errors per codeword are
+// fixed and errored sync words are accepted (pocsag_bch.h).
+// Used by the native replay tests; the firmware decodes with PagerClient.
+
+#include <stddef.h>
+#include <stdint.h>
+#include "inbox_ring.h"
+#include "pocsag_codeword.h"
+
+struct PocsagPage {
+  uint32_t addr;
+  uint8_t  function;
+  char     text[INBOX_TEXT_MAX + 1];  // truncated like the inbox, NUL-terminated
+  uint8_t  len;
+  uint8_t  badWords;                   // message codewords that failed the check
+  uint32_t endBit;                     // bit index after the last codeword
+};
+
+typedef void (*PocsagPageHandler)(const PocsagPage& page, void* ctx);
+
+struct PocsagDecoder {
+  PocsagPageHandler handler;
+  void*             ctx;
+  bool              correct;
+
+  uint32_t shift;
+  uint32_t bitIndex;    // bits pushed so far
+  bool     inSync;
+  int      bitCount;    // bits of the current codeword
+  int      word;        // codeword index in the batch, POCSAG_BATCH_WORDS = sync expected
+
+  bool       pageOpen;
+  PocsagPage page;
+  uint32_t   symbol;    // partial character, LSB first
+  int        symbolBits;
+
+  uint32_t syncs;
+  uint32_t syncLosses;
+  uint32_t codewords;
+  uint32_t badCodewords;     // not correctable (or correction off)
+  uint32_t correctedWords;
+  uint32_t correctedBits;
+  uint32_t correctedSyncs;   // sync words accepted with bit errors
+  uint32_t pages;
+};
+
+void pocsagDecoderInit(PocsagDecoder& dec, PocsagPageHandler handler, void* ctx,
+                       bool correct = false);
+void pocsagDecoderPushBit(PocsagDecoder& dec, uint8_t bit);
+
+// End of stream: emit a page that is still being assembled
+void pocsagDecoderFlush(PocsagDecoder& dec);
@@ -0,0 +1,126 @@
+#include "pocsag_encoder.h"
+
+#include <string.h>
+
+void bitBufferInit(BitBuffer& buf, uint8_t* data, size_t bytes) {
+  buf.data         = data;
+  buf.capacityBits = bytes * 8;
+  buf.bits         = 0;
+  memset(data, 0, bytes);
+}
+
+bool bitBufferPut(BitBuffer& buf, uint32_t value, int count) {
+  if (buf.bits + (size_t)count > buf.capacityBits) {
+    return false;
+  }
+  for (int i = count - 1; i >= 0; --i, ++buf.bits) {
+    if (value & (1UL << i)) {
+      buf.data[buf.bits >> 3] |= (uint8_t)(0x80 >> (buf.bits & 7));
+    }
+  }
+  return true;
+}
+
+uint8_t bitBufferGet(const uint8_t* data, size_t index) {
+  return (data[index >> 3] >> (7 - (index & 7))) & 1;
+}
+
+// Codeword at the next position, opening a new batch with its sync word
+static void encPutWord(PocsagEncoder& enc, uint32_t cw) {
+  if (enc.overflow) {
+    return;
+  }
+  if (enc.word == POCSAG_BATCH_WORDS) {
+    if (!bitBufferPut(*enc.out, POCSAG_SYNC_WORD, 32)) {
+      enc.overflow = true;
+      return;
+    }
+    enc.word = 0;
+  }
+  if (!bitBufferPut(*enc.out, cw, 32)) {
+    enc.overflow = true;
+    return;
+  }
+  enc.word++;
+}
+
+void pocsagBeginTransmission(PocsagEncoder& enc, BitBuffer& out) {
+  enc.out      = &out;
+  enc.word     = POCSAG_BATCH_WORDS;
+  enc.overflow = false;
+
+  for (uint32_t i = 0; i < POCSAG_PREAMBLE_BITS && !enc.overflow; i += 32) {
+    enc.overflow = !bitBufferPut(out, 0xAAAAAAAAUL, 32);
+  }
+}
+
+// Numeric pages: BCD with the POCSAG extras
+static uint8_t numericSymbol(char c) {
+  if (c >= '0' && c <= '9') {
+    return (uint8_t)(c - '0');
+  }
+  switch (c) {
+    case 'U': return 0xB;
+    case '-': return 0xD;
+    case ']': return 0xE;
+    case '[': return 0xF;
+    default:  return 0xC;  // space
+  }
+}
+
+bool pocsagEncodePage(PocsagEncoder& enc, uint32_t ric, uint8_t function,
+                      const char* text, size_t len, uint32_t* endBit) {
+  // Address codeword into frame (ric & 7). Past that frame already: finish
+  // the batch with idle codewords and use the next one.
+  int frame = (int)(ric & 7);
+  if (enc.word != POCSAG_BATCH_WORDS && enc.word / 2 > frame) {
+    while (enc.word != POCSAG_BATCH_WORDS && !enc.overflow) {
+      encPutWord(enc, POCSAG_IDLE_WORD);
+    }
+  }
+  while (!enc.overflow && (enc.word == POCSAG_BATCH_WORDS ? 0 : enc.word) / 2 < frame) {
+    encPutWord(enc, POCSAG_IDLE_WORD);
+  }
+  encPutWord(enc, pocsagAddressWord(ric, function));
+
+  // Symbols go out LSB first, 20 bits per message codeword
+  const bool alpha   = (function != POCSAG_FUNC_NUMERIC);
+  const int  symBits = alpha ? 7 : 4;
+  uint32_t   data    = 0;
+  int        filled  = 0;
+
+  for (size_t i = 0; i < len && !enc.overflow; ++i) {
+    uint8_t sym = alpha ? (uint8_t)(text[i] & 0x7F) : numericSymbol(text[i]);
+    for (int b = 0; b < symBits; ++b) {
+      data = (data << 1) | ((sym >> b) & 1);
+      if (++filled == 20) {
+        encPutWord(enc, pocsagMessageWord(data));
+        data   = 0;
+        filled = 0;
+      }
+    }
+  }
+
+  // Pad the last codeword: NUL bits for text, spaces for numeric pages
+  if (filled > 0) {
+    while (filled < 20) {
+      uint32_t pad = alpha ? 0 : ((0xC >> (filled % 4)) & 1);
+      data         = (data << 1) | pad;
+      filled++;
+    }
+    encPutWord(enc, pocsagMessageWord(data));
+  }
+
+  if (endBit) {
+    *endBit = (uint32_t)enc.out->bits;
+  }
+  return !enc.overflow;
+}
+
+bool pocsagEndTransmission(PocsagEncoder& enc) {
+  encPutWord(enc, POCSAG_IDLE_WORD);
+  while (enc.word != POCSAG_BATCH_WORDS && !enc.overflow) {
+    encPutWord(enc, POCSAG_IDLE_WORD);
+  }
+  return !enc.overflow;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+// POCSAG transmitter side for test streams: builds preamble, batches and
+// alphanumeric/numeric pages into a bit buffer, exactly as a DAPNET
+// transmitter would key them (MSB of each codeword first).
+
+#include <stddef.h>
+#include <stdint.h>
+#include "pocsag_codeword.h"
+
+// Packed bits, MSB of data[0] first
+struct BitBuffer {
+  uint8_t* data;
+  size_t   capacityBits;
+  size_t   bits;
+};
+
+void    bitBufferInit(BitBuffer& buf, uint8_t* data, size_t bytes);
+bool    bitBufferPut(BitBuffer& buf, uint32_t value, int count);  // false when full
+uint8_t bitBufferGet(const uint8_t* data, size_t index);
+
+struct PocsagEncoder {
+  BitBuffer* out;
+  int        word;      // codewords in the current batch, POCSAG_BATCH_WORDS = batch full
+  bool       overflow;  // a codeword did not fit anymore
+};
+
+// Start a transmission: preamble, the first sync word follows with the first codeword
+void pocsagBeginTransmission(PocsagEncoder& enc, BitBuffer& out);
+
+// Append one page. ric goes into its frame, the text follows in message
+// codewords. endBit (optional) receives the bit index after the last codeword.
+bool pocsagEncodePage(PocsagEncoder& enc, uint32_t ric, uint8_t function,
+                      const char* text, size_t len, uint32_t* endBit);
+
+// Terminate the last page with an idle codeword and fill the batch
+bool pocsagEndTransmission(PocsagEncoder& enc);
@@ -0,0 +1,53 @@
+#include "pocsag_rate.h"
+
+static const uint16_t RATES[]    = { 512, 1200, 2400 };
+static const int      RATE_COUNT  = sizeof(RATES) / sizeof(RATES[0]);
+
+void pocsagRateDetectorReset(PocsagRateDetector& d) {
+  d.candidate = -1;
+  d.run       = 0;
+  d.runMicros = 0;
+}
+
+// Rate whose bit period is within +-25 % of the interval, -1 if none
+static int8_t classify(uint32_t intervalUs) {
+  for (int i = 0; i < RATE_COUNT; ++i) {
+    uint32_t period = 1000000UL / RATES[i];
+    if (intervalUs * 4 >= period * 3 && intervalUs * 4 <= period * 5) {
+      return (int8_t)i;
+    }
+  }
+  return -1;
+}
+
+uint16_t pocsagRateDetectorEdge(PocsagRateDetector& d, uint32_t intervalUs) {
+  int8_t c = classify(intervalUs);
+  if (c < 0) {
+    pocsagRateDetectorReset(d);
+    return 0;
+  }
+  if (c != d.candidate) {
+    d.candidate = c;
+    d.run       = 0;
+    d.runMicros = 0;
+  }
+  d.run++;
+  d.runMicros += intervalUs;
+  if (d.run < POCSAG_RATE_DETECT_EDGES) {
+    return 0;
+  }
+
+  uint16_t rate = RATES[c];
+  pocsagRateDetectorReset(d);
+  return rate;
+}
+
+float pocsagRxBandwidthKHz(uint16_t bitRate) {
+  if (bitRate <= 512) {
+    return 12.5f;
+  }
+  if (bitRate <= 1200) {
+    return 15.6f;
+  }
+  return 20.8f;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+// POCSAG bit rate detection from preamble timing. The 576-bit preamble is
+// 1010..., so every level change is one bit period apart: a run of equal
+// intervals near 1953, 833 or 417 us identifies 512, 1200 or 2400 bps.
+// Receivers sample at the fastest rate while hunting: the slower preambles
+// then show up as runs of 2 (1200) or 4-5 (512) samples, still well inside
+// the +-25 % windows, which do not overlap.
+
+#include <stdint.h>
+
+const uint16_t POCSAG_HUNT_BIT_RATE     = 2400;
+const int      POCSAG_RATE_DETECT_EDGES = 24;  // equal intervals in a row
+
+struct PocsagRateDetector {
+  int8_t   candidate;   // index into the rate table, -1 = none
+  uint16_t run;         // consecutive intervals matching it
+  uint32_t runMicros;   // their total length
+};
+
+void pocsagRateDetectorReset(PocsagRateDetector& d);
+
+// One interval between two level changes. Returns the bit rate once a
+// preamble is recognised (and starts over), 0 otherwise.
+uint16_t pocsagRateDetectorEdge(PocsagRateDetector& d, uint32_t intervalUs);
+
+// SX1278 RX filter (single side, kHz) for a bit rate: 4.5 kHz deviation,
+// half the bit rate and room for a few kHz of crystal offset
+float pocsagRxBandwidthKHz(uint16_t bitRate);
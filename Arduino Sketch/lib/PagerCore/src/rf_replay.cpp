@@ -0,0 +1,200 @@
+#include "rf_replay.h"
+
+#include <stdio.h>
+#include <string.h>
+#include "inbox_codec.h"
+#include "inbox_ring.h"
+
+static uint32_t xorshift32(uint32_t& s) {
+  if (s == 0) {
+    s = 0x9E3779B9;
+  }
+  s ^= s << 13;
+  s ^= s >> 17;
+  s ^= s << 5;
+  return s;
+}
+
+bool replayBitRateSupported(uint32_t bitRate) {
+  return bitRate == 512 || bitRate == 1200 || bitRate == 2400;
+}
+
+uint32_t replayTextHash(const char* text, size_t len) {
+  return crc32Update(0, (const uint8_t*)text, len);
+}
+
+size_t replaySyntheticText(uint16_t n, uint32_t& rng, char* buf, size_t maxLen) {
+  static const char* const WORDS[] = {
+    "Einsatz", "Probealarm", "DAPNET", "Test", "Hauptstrasse", "RTW", "HLF",
+    "Brandmeldeanlage", "Sammelruf", "Wetter", "Sturmwarnung", "OV", "Relais"
+  };
+  const int WORD_COUNT = sizeof(WORDS) / sizeof(WORDS[0]);
+
+  size_t target = 12 + xorshift32(rng) % (maxLen - 11);
+  size_t len    = (size_t)snprintf(buf, maxLen + 1, "RPL%05u", (unsigned)n);
+
+  while (len < target) {
+    const char* w    = WORDS[xorshift32(rng) % WORD_COUNT];
+    size_t      wLen = strlen(w);
+    if (len + 1 + wLen > target) {
+      break;
+    }
+    buf[len++] = ' ';
+    memcpy(buf + len, w, wLen);
+    len += wLen;
+  }
+  buf[len] = '\0';
+  return len;
+}
+
+int replayBuildScenario(const ReplayScenario& sc, BitBuffer& bits, ReplayExpect* expect, int maxExpect) {
+  uint32_t      rng = sc.seed;
+  PocsagEncoder enc;
+  int           built   = 0;
+  int           inBurst = 0;
+  char          text[INBOX_TEXT_MAX + 1];
+
+  for (uint16_t n = 0; n < sc.pages && built < maxExpect; ++n) {
+    if (inBurst == 0) {
+      pocsagBeginTransmission(enc, bits);
+    }
+
+    uint32_t ric = sc.rics[n % sc.ricCount];
+    size_t   len = replaySyntheticText(n, rng, text, INBOX_TEXT_MAX);
+    uint32_t endBit;
+    if (!pocsagEncodePage(enc, ric, POCSAG_FUNC_ALPHA, text, len, &endBit)) {
+      break;
+    }
+
+    // End of a transmission: idle fill, then noise until the next one
+    bool last = (n + 1 == sc.pages) || (++inBurst >= sc.pagesPerBurst);
+    if (last) {
+      inBurst = 0;
+      if (!pocsagEndTransmission(enc)) {
+        break;
+      }
+      for (uint32_t i = 0; i < sc.gapBits; ++i) {
+        if (!bitBufferPut(bits, xorshift32(rng) & 1, 1)) {
+          break;
+        }
+      }
+    }
+
+    ReplayExpect& e = expect[built++];
+    e.addr          = ric;
+    e.endBit        = endBit;
+    e.textLen       = (uint16_t)len;
+    e.textHash      = replayTextHash(text, len);
+  }
+  return built;
+}
+
+void replayChannelInit(ReplayChannel& ch, const ReplayImpairment& cfg) {
+  ch.cfg        = cfg;
+  ch.rng        = cfg.seed;
+  ch.untilBurst = cfg.burstEveryBits;
+  ch.burstLeft  = 0;
+  ch.errors     = 0;
+}
+
+uint8_t replayChannelBit(ReplayChannel& ch, uint8_t bit) {
+  uint8_t out = bit;
+
+  if (ch.cfg.burstEveryBits != 0 && --ch.untilBurst == 0) {
+    ch.untilBurst = ch.cfg.burstEveryBits;
+    ch.burstLeft  = ch.cfg.burstBits;
+  }
+
+  if (ch.burstLeft > 0) {
+    ch.burstLeft--;
+    out = xorshift32(ch.rng) & 1;  // no signal: the slicer outputs noise
+  } else if (ch.cfg.berPpm != 0 && xorshift32(ch.rng) % 1000000UL < ch.cfg.berPpm) {
+    out ^= 1;
+  }
+
+  if (out != bit) {
+    ch.errors++;
+  }
+  return out;
+}
+
+void replayMatcherInit(ReplayMatcher& m, const ReplayExpect* expect, int count) {
+  memset(&m, 0, sizeof(m));
+  m.expect         = expect;
+  m.count          = count;
+  m.stats.expected = (uint32_t)count;
+}
+
+int replayMatchPage(ReplayMatcher& m, uint32_t addr, const char* text, size_t len) {
+  int last = m.next + REPLAY_MATCH_WINDOW;
+  if (last > m.count) {
+    last = m.count;
+  }
+
+  for (int i = m.next; i < last; ++i) {
+    const ReplayExpect& e = m.expect[i];
+    if (e.addr != addr) {
+      continue;
+    }
+
+    m.stats.lost += (uint32_t)(i - m.next);  // skipped over: never decoded
+    m.next        = i + 1;
+
+    if (len == e.textLen && replayTextHash(text, len) == e.textHash) {
+      m.stats.intact++;
+    } else {
+      m.stats.corrupted++;
+    }
+    return i;
+  }
+
+  m.stats.spurious++;
+  return -1;
+}
+
+void replayRecordLatency(ReplayMatcher& m, uint32_t latencyUs) {
+  m.stats.latencyCount++;
+  m.stats.latencySumUs += latencyUs;
+  if (latencyUs > m.stats.latencyMaxUs) {
+    m.stats.latencyMaxUs = latencyUs;
+  }
+}
+
+void replayMatcherFinish(ReplayMatcher& m) {
+  m.stats.lost += (uint32_t)(m.count - m.next);
+  m.next        = m.count;
+}
+
+void replayEncodeFileHeader(uint8_t* buf, uint16_t bitRate, uint16_t pages, uint32_t bits) {
+  buf[0] = 'P';
+  buf[1] = 'R';
+  buf[2] = 'P';
+  buf[3] = REPLAY_FILE_VERSION;
+  putLe16(buf + 4, bitRate);
+  putLe16(buf + 6, pages);
+  putLe32(buf + 8, bits);
+}
+
+bool replayDecodeFileHeader(const uint8_t* buf, uint16_t& bitRate, uint16_t& pages, uint32_t& bits) {
+  if (buf[0] != 'P' || buf[1] != 'R' || buf[2] != 'P' || buf[3] != REPLAY_FILE_VERSION) {
+    return false;
+  }
+  bitRate = getLe16(buf + 4);
+  pages   = getLe16(buf + 6);
+  bits    = getLe32(buf + 8);
+  return replayBitRateSupported(bitRate);
+}
+
+void replayEncodeExpect(uint8_t* buf, const ReplayExpect& e) {
+  putLe32(buf, e.addr);
+  putLe32(buf + 4, e.endBit);
+  putLe16(buf + 8, e.textLen);
+  putLe32(buf + 10, e.textHash);
+}
+
+void replayDecodeExpect(const uint8_t* buf, ReplayExpect& e) {
+  e.addr     = getLe32(buf);
+  e.endBit   = getLe32(buf + 4);
+  e.textLen  = getLe16(buf + 8);
+  e.textHash = getLe32(buf + 10);
+}
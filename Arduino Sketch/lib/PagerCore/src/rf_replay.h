@@ -0,0 +1,116 @@
+#pragma once
+
+// Recorded/synthetic RF replay: test POCSAG streams with their expected
+// pages, a channel model that injects bit errors and error bursts, and the
+// bookkeeping that turns decoded pages into throughput, latency and losses.
+//
+// Replay file: 'P' 'R' 'P' <version>  bitRate(2) pageCount(2) bitCount(4)
+//              pageCount x (addr(4) endBit(4) textLen(2) textHash(4))
+//              bitCount bits, MSB first
+// All integers are little-endian. textHash is crc32Update(0, text, textLen).
+// pageCount may be 0 for a plain capture: then only decodes are counted.
+
+#include <stddef.h>
+#include <stdint.h>
+#include "pocsag_encoder.h"
+
+const uint8_t  REPLAY_FILE_VERSION    = 1;
+const size_t   REPLAY_FILE_HEADER_LEN = 12;
+const size_t   REPLAY_FILE_PAGE_LEN   = 14;
+const int      REPLAY_MATCH_WINDOW    = 16;  // expected pages searched ahead per decode
+
+struct ReplayExpect {
+  uint32_t addr;
+  uint32_t endBit;    // bit index after the page's last codeword
+  uint16_t textLen;
+  uint32_t textHash;
+};
+
+// 512, 1200 and 2400 bps
+bool replayBitRateSupported(uint32_t bitRate);
+
+// Air time in microseconds of the first bits of a stream
+inline uint64_t replayBitsToMicros(uint64_t bits, uint32_t bitRate) {
+  return bits * 1000000ULL / bitRate;
+}
+
+uint32_t replayTextHash(const char* text, size_t len);
+
+// -----------------------------------------------------------------------------
+// Synthetic traffic
+// -----------------------------------------------------------------------------
+struct ReplayScenario {
+  uint16_t        pages;
+  uint8_t         pagesPerBurst;  // pages per transmission, each with its own preamble
+  uint32_t        gapBits;        // receiver noise between transmissions
+  const uint32_t* rics;           // addresses used round-robin
+  int             ricCount;
+  uint32_t        seed;
+};
+
+// Deterministic page text for page n (length varies up to maxLen)
+size_t replaySyntheticText(uint16_t n, uint32_t& rng, char* buf, size_t maxLen);
+
+// Build the stream into bits and fill expect[]. Returns the number of pages
+// that fit into the buffer.
+int replayBuildScenario(const ReplayScenario& sc, BitBuffer& bits, ReplayExpect* expect, int maxExpect);
+
+// -----------------------------------------------------------------------------
+// Channel model
+// -----------------------------------------------------------------------------
+struct ReplayImpairment {
+  uint32_t berPpm;          // random bit errors per million bits
+  uint32_t burstEveryBits;  // 0 = no bursts
+  uint16_t burstBits;       // bits of noise per burst (a fade or a collision)
+  uint32_t seed;
+};
+
+struct ReplayChannel {
+  ReplayImpairment cfg;
+  uint32_t         rng;
+  uint32_t         untilBurst;
+  uint16_t         burstLeft;
+  uint32_t         errors;  // bits flipped so far
+};
+
+void    replayChannelInit(ReplayChannel& ch, const ReplayImpairment& cfg);
+uint8_t replayChannelBit(ReplayChannel& ch, uint8_t bit);
+
+// -----------------------------------------------------------------------------
+// Results
+// -----------------------------------------------------------------------------
+struct ReplayStats {
+  uint32_t expected;
+  uint32_t intact;        // address and text as sent
+  uint32_t corrupted;     // address matched, text garbled
+  uint32_t lost;          // never decoded
+  uint32_t spurious;      // decoded, but not part of the stream
+  uint32_t latencyCount;
+  uint64_t latencySumUs;
+  uint32_t latencyMaxUs;
+};
+
+struct ReplayMatcher {
+  const ReplayExpect* expect;
+  int                 count;
+  int                 next;
+  ReplayStats         stats;
+};
+
+void replayMatcherInit(ReplayMatcher& m, const ReplayExpect* expect, int count);
+
+// Account a decoded page, returns the index of the expected page or -1
+int replayMatchPage(ReplayMatcher& m, uint32_t addr, const char* text, size_t len);
+
+void replayRecordLatency(ReplayMatcher& m, uint32_t latencyUs);
+
+// Stream done: whatever was not decoded is lost
+void replayMatcherFinish(ReplayMatcher& m);
+
+// -----------------------------------------------------------------------------
+// Replay file
+// -----------------------------------------------------------------------------
+void replayEncodeFileHeader(uint8_t* buf, uint16_t bitRate, uint16_t pages, uint32_t bits);
+bool replayDecodeFileHeader(const uint8_t* buf, uint16_t& bitRate, uint16_t& pages, uint32_t& bits);
+void replayEncodeExpect(uint8_t* buf, const ReplayExpect& e);
+void replayDecodeExpect(const uint8_t* buf, ReplayExpect& e);
@@ -0,0 +1,205 @@
+#include "ric_table.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static uint32_t ricKey(uint32_t addr, uint8_t function) {
+  return addr * (RIC_FUNCTION_ANY + 1) + function;
+}
+
+// Fibonacci hashing: the top bits of key * 2^32/phi
+static uint32_t ricSlot(uint32_t key) {
+  return (uint32_t)(key * 2654435761UL) >> (32 - RIC_HASH_BITS);
+}
+
+static void ricIndexEntry(RicTable& t, uint8_t idx) {
+  const RicEntry& e = t.entries[idx];
+  uint32_t        s = ricSlot(ricKey(e.addr, e.function));
+  while (t.slots[s] != RIC_NOT_FOUND) {
+    s = (s + 1) & (RIC_HASH_SLOTS - 1);
+  }
+  t.slots[s] = idx;
+  if ((uint8_t)(e.addr & 7) > t.lastFrame) {
+    t.lastFrame = (uint8_t)(e.addr & 7);
+  }
+}
+
+static void ricRebuild(RicTable& t) {
+  memset(t.slots, RIC_NOT_FOUND, sizeof(t.slots));
+  t.lastFrame = 0;
+  for (int i = 0; i < t.count; ++i) {
+    ricIndexEntry(t, (uint8_t)i);
+  }
+}
+
+void ricTableReset(RicTable& t) {
+  t.count = 0;
+  ricRebuild(t);
+}
+
+uint8_t ricTableFindExact(const RicTable& t, uint32_t addr, uint8_t function) {
+  uint32_t s = ricSlot(ricKey(addr, function));
+  while (t.slots[s] != RIC_NOT_FOUND) {
+    const RicEntry& e = t.entries[t.slots[s]];
+    if (e.addr == addr && e.function == function) {
+      return t.slots[s];
+    }
+    s = (s + 1) & (RIC_HASH_SLOTS - 1);
+  }
+  return RIC_NOT_FOUND;
+}
+
+uint8_t ricTableMatch(const RicTable& t, uint32_t addr, uint8_t function) {
+  if (function < RIC_FUNCTION_ANY) {
+    uint8_t idx = ricTableFindExact(t, addr, function);
+    return idx != RIC_NOT_FOUND ? idx : ricTableFindExact(t, addr, RIC_FUNCTION_ANY);
+  }
+
+  // Function not known: any entry of the address, the catch-all first
+  uint8_t idx = ricTableFindExact(t, addr, RIC_FUNCTION_ANY);
+  for (uint8_t f = 0; f < RIC_FUNCTION_ANY && idx == RIC_NOT_FOUND; ++f) {
+    idx = ricTableFindExact(t, addr, f);
+  }
+  return idx;
+}
+
+uint8_t ricTableAdd(RicTable& t, const RicEntry& e) {
+  if (e.addr > RIC_ADDR_MAX || e.function > RIC_FUNCTION_ANY || e.priority >= RIC_PRIORITY_COUNT) {
+    return RIC_NOT_FOUND;
+  }
+
+  uint8_t idx = ricTableFindExact(t, e.addr, e.function);
+  if (idx == RIC_NOT_FOUND) {
+    if (t.count >= RIC_TABLE_MAX) {
+      return RIC_NOT_FOUND;
+    }
+    idx = (uint8_t)t.count++;
+    t.entries[idx] = e;
+    ricIndexEntry(t, idx);
+  } else {
+    t.entries[idx] = e;
+  }
+  t.entries[idx].name[RIC_NAME_MAX] = '\0';
+  return idx;
+}
+
+bool ricTableRemove(RicTable& t, uint32_t addr, uint8_t function) {
+  uint8_t idx = ricTableFindExact(t, addr, function);
+  if (idx == RIC_NOT_FOUND) {
+    return false;
+  }
+  memmove(&t.entries[idx], &t.entries[idx + 1], (size_t)(t.count - idx - 1) * sizeof(RicEntry));
+  t.count--;
+  ricRebuild(t);
+  return true;
+}
+
+uint8_t ricTableFindName(const RicTable& t, const char* name, size_t nameLen) {
+  for (int i = 0; i < t.count; ++i) {
+    if (strlen(t.entries[i].name) == nameLen && memcmp(t.entries[i].name, name, nameLen) == 0) {
+      return (uint8_t)i;
+    }
+  }
+  return RIC_NOT_FOUND;
+}
+
+// Field [p, end) of a comma-separated line, without surrounding blanks
+static const char* ricField(const char*& p, const char*& end) {
+  while (*p == ' ' || *p == '\t') {
+    p++;
+  }
+  const char* start = p;
+  while (*p != '\0' && *p != ',' && *p != '\r' && *p != '\n') {
+    p++;
+  }
+  end = p;
+  while (end > start && (end[-1] == ' ' || end[-1] == '\t')) {
+    end--;
+  }
+  if (*p == ',') {
+    p++;
+  }
+  return start;
+}
+
+// Unsigned decimal field, false if it is empty, not a number or above max
+static bool ricNumber(const char* start, const char* end, uint32_t max, uint32_t& value) {
+  if (start == end || end - start > 7) {
+    return false;
+  }
+  value = 0;
+  for (const char* c = start; c < end; ++c) {
+    if (*c < '0' || *c > '9') {
+      return false;
+    }
+    value = value * 10 + (uint32_t)(*c - '0');
+  }
+  return value <= max;
+}
+
+int ricTableParseLine(const char* line, RicEntry& e) {
+  const char* p = line;
+  while (*p == ' ' || *p == '\t') {
+    p++;
+  }
+  if (*p == '\0' || *p == '#' || *p == '\r' || *p == '\n') {
+    return 0;
+  }
+
+  const char* end;
+  const char* field = ricField(p, end);
+  uint32_t    value;
+  if (!ricNumber(field, end, RIC_ADDR_MAX, value)) {
+    return -1;
+  }
+  e.addr = value;
+
+  field = ricField(p, end);
+  if (end - field != 1) {
+    return -1;
+  }
+  char f = (char)(*field & ~0x20);  // upper case
+  if (*field == '*') {
+    e.function = RIC_FUNCTION_ANY;
+  } else if (f >= 'A' && f <= 'D') {
+    e.function = (uint8_t)(f - 'A');
+  } else {
+    return -1;
+  }
+
+  field = ricField(p, end);
+  if (field == end || end - field > RIC_NAME_MAX) {
+    return -1;
+  }
+  memcpy(e.name, field, (size_t)(end - field));
+  e.name[end - field] = '\0';
+
+  e.ringtone = 0;
+  e.priority = RIC_PRIORITY_NORMAL;
+  field      = ricField(p, end);
+  if (field != end) {
+    if (!ricNumber(field, end, 255, value)) {
+      return -1;
+    }
+    e.ringtone = (uint8_t)value;
+  }
+  field = ricField(p, end);
+  if (field != end) {
+    if (!ricNumber(field, end, RIC_PRIORITY_COUNT - 1, value)) {
+      return -1;
+    }
+    e.priority = (uint8_t)value;
+  }
+
+  // Nothing but a line end may follow
+  return (*p == '\0' || *p == '\r' || *p == '\n') ? 1 : -1;
+}
+
+size_t ricTableFormatLine(const RicEntry& e, char* buf, size_t bufLen) {
+  int n = snprintf(buf, bufLen, "%lu,%c,%s,%u,%u", (unsigned long)e.addr, ricFunctionLetter(e.function),
+                   e.name, (unsigned)e.ringtone, (unsigned)e.priority);
+  if (n < 0) {
+    return 0;
+  }
+  return (size_t)n < bufLen ? (size_t)n : bufLen - 1;
+}
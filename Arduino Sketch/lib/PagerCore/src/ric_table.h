@@ -0,0 +1,92 @@
+#pragma once
+
+// Subscription table: which RICs (and which of their function codes A-D)
+// the pager listens to, with name, ringtone and priority per entry.
+//
+// Entries are kept in insertion order (the index is what the inbox and the
+// statistics refer to); an open-addressing hash over (address, function)
+// finds an entry in constant time, so hundreds of group RICs cost the bit
+// interrupt no more than one. An entry for RIC_FUNCTION_ANY matches every
+// function code of its address that has no entry of its own.
+//
+// Text form, one entry per line ('#' starts a comment):
+//   <ric>,<A|B|C|D|*>,<name>[,<ringtone>[,<priority>]]
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Most entries in the table; indices are stored as one byte
+#ifndef RIC_TABLE_MAX
+#define RIC_TABLE_MAX 255
+#endif
+
+#define RIC_NAME_MAX 15
+
+static_assert(RIC_TABLE_MAX <= 255, "entry indices are stored as one byte");
+
+const uint32_t RIC_ADDR_MAX         = 0x1FFFFF;  // 21-bit POCSAG address
+const uint8_t  RIC_FUNCTION_ANY     = 4;         // entry matches A-D
+const uint8_t  RIC_FUNCTION_UNKNOWN = 0xFF;      // page without known function bits
+const uint8_t  RIC_NOT_FOUND        = 0xFF;
+
+// Priority of a page: silent pages are stored but do not ring, a running
+// notification is only interrupted by a page of the same or higher priority
+enum RicPriority : uint8_t {
+  RIC_PRIORITY_SILENT,
+  RIC_PRIORITY_NORMAL,
+  RIC_PRIORITY_HIGH,
+  RIC_PRIORITY_URGENT,
+  RIC_PRIORITY_COUNT
+};
+
+struct RicEntry {
+  uint32_t addr;
+  uint8_t  function;  // 0-3 = A-D, or RIC_FUNCTION_ANY
+  uint8_t  ringtone;
+  uint8_t  priority;  // RicPriority
+  char     name[RIC_NAME_MAX + 1];
+};
+
+// At least twice RIC_TABLE_MAX slots, so probe chains stay short
+const int RIC_HASH_BITS  = 9;
+const int RIC_HASH_SLOTS = 1 << RIC_HASH_BITS;
+static_assert(RIC_HASH_SLOTS >= 2 * RIC_TABLE_MAX, "hash must stay half empty");
+
+struct RicTable {
+  RicEntry entries[RIC_TABLE_MAX];
+  int      count;
+  uint8_t  slots[RIC_HASH_SLOTS];  // entry index or RIC_NOT_FOUND
+  uint8_t  lastFrame;              // highest frame (address & 7) of any entry
+};
+
+void ricTableReset(RicTable& t);
+
+// Add an entry or update the one with the same address and function.
+// Returns the entry index, RIC_NOT_FOUND if the table is full or e is invalid.
+uint8_t ricTableAdd(RicTable& t, const RicEntry& e);
+
+// Remove the entry for (addr, function); later entries move down by one.
+bool ricTableRemove(RicTable& t, uint32_t addr, uint8_t function);
+
+// Entry for exactly this address and function code
+uint8_t ricTableFindExact(const RicTable& t, uint32_t addr, uint8_t function);
+
+// Entry a page is routed to: the function's own entry, else the address's
+// RIC_FUNCTION_ANY entry. With RIC_FUNCTION_UNKNOWN any entry of the
+// address matches (the ANY entry first).
+uint8_t ricTableMatch(const RicTable& t, uint32_t addr, uint8_t function);
+
+// First entry with this name (linear, for restoring old inbox records)
+uint8_t ricTableFindName(const RicTable& t, const char* name, size_t nameLen);
+
+// Parse one line of the text form. Returns 1 for an entry, 0 for a blank or
+// comment line, -1 for a malformed one. The line is not modified.
+int ricTableParseLine(const char* line, RicEntry& e);
+
+// Text form of an entry (without line end), returns its length
+size_t ricTableFormatLine(const RicEntry& e, char* buf, size_t bufLen);
+
+// 'A'-'D' or '*'
+inline char ricFunctionLetter(uint8_t function) {
+  return function < RIC_FUNCTION_ANY ? (char)('A' + function) : '*';
+}
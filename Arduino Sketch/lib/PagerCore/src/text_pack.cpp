@@ -0,0 +1,28 @@
+#include "text_pack.h"
+
+#include <string.h>
+
+size_t textPack(uint8_t* dst, const char* src, size_t len) {
+  size_t bytes = TEXT_PACKED_LEN(len);
+  memset(dst, 0, bytes);
+
+  for (size_t i = 0; i < len; ++i) {
+    unsigned c   = (uint8_t)src[i];
+    size_t   bit = i * 7;
+    if (c > 0x7F) {
+      c = '?';
+    }
+    dst[bit >> 3] |= (uint8_t)(c << (bit & 7));
+    if ((bit & 7) > 1) {
+      dst[(bit >> 3) + 1] |= (uint8_t)(c >> (8 - (bit & 7)));
+    }
+  }
+  return bytes;
+}
+
+void textUnpack(char* dst, const uint8_t* packed, size_t first, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    dst[i] = textCharAt(packed, first + i);
+  }
+  dst[count] = '\0';
+}
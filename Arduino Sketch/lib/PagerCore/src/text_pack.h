@@ -0,0 +1,33 @@
+#pragma once
+
+// Page text packed at 7 bits per character. POCSAG alphanumeric pages are
+// 7-bit ASCII, so the eighth bit of every stored character is wasted; the
+// inbox keeps its text in this form in RAM and in the inbox file alike.
+//
+// Character i occupies bits i*7 .. i*7+6 of the byte stream, least
+// significant bit first. Readers unpack only the characters they need.
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Bytes needed for chars packed characters
+#define TEXT_PACKED_LEN(chars) (((chars) * 7 + 7) / 8)
+
+// Pack len characters of src into dst (TEXT_PACKED_LEN(len) bytes). Bytes
+// outside 7-bit ASCII (only possible in migrated text files) become '?'.
+// Returns the packed length.
+size_t textPack(uint8_t* dst, const char* src, size_t len);
+
+// Character i of packed text
+inline char textCharAt(const uint8_t* packed, size_t i) {
+  size_t   bit   = i * 7;
+  unsigned value = packed[bit >> 3] >> (bit & 7);
+  if ((bit & 7) > 1) {
+    value |= (unsigned)packed[(bit >> 3) + 1] << (8 - (bit & 7));
+  }
+  return (char)(value & 0x7F);
+}
+
+// Unpack count characters starting at character first into dst and
+// NUL-terminate it (dst holds count + 1 bytes)
+void textUnpack(char* dst, const uint8_t* packed, size_t first, size_t count);
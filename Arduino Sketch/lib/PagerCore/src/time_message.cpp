@@ -0,0 +1,105 @@
+#include "time_message.h"
+
+#include <string.h>
+
+// One beacon format. fields: pairs of digits, 'Y' 'M' 'D' 'h' 'm' 's' name
+// the field, ' ' stands for one or more blanks.
+struct TimeFormat {
+  uint32_t    ric;
+  const char* marker;  // text in front of the fields, "" = none
+  const char* fields;
+  bool        local;
+  uint8_t     resolution;
+};
+
+static const TimeFormat TIME_FORMATS[] = {
+  { 216, "YYYYMMDDHHMMSS", "YYMMDDhhmmss", false, 1 },
+  { 224, "YYYYMMDDHHMMSS", "YYMMDDhhmmss", false, 1 },
+  { 208, "XTIME=", "hhmmDDMMYY", true, 60 },
+  { 2000, "XTIME=", "hhmmDDMMYY", true, 60 },
+  { 2504, "", "hhmmss DDMMYY", true, 1 },
+};
+
+static bool isDigit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+// Two decimal digits at p, checked with isDigit() by the caller
+static int parse2Digits(const char* p) {
+  return (p[0] - '0') * 10 + (p[1] - '0');
+}
+
+static TimeMessageResult parseFields(const char* p, const char* end, const char* fields, PagerTime& t) {
+  t.second = 0;
+  for (const char* f = fields; *f != '\0'; f += (*f == ' ') ? 1 : 2) {
+    if (*f == ' ') {
+      if (p >= end) {
+        return TIME_MSG_SHORT;
+      }
+      if (*p != ' ') {
+        return TIME_MSG_BAD;
+      }
+      while (p < end && *p == ' ') {
+        p++;
+      }
+      continue;
+    }
+
+    if (end - p < 2) {
+      return TIME_MSG_SHORT;
+    }
+    if (!isDigit(p[0]) || !isDigit(p[1])) {
+      return TIME_MSG_BAD;
+    }
+    int value = parse2Digits(p);
+    p += 2;
+    switch (*f) {
+      case 'Y': t.year = 2000 + value; break;
+      case 'M': t.month = value; break;
+      case 'D': t.day = value; break;
+      case 'h': t.hour = value; break;
+      case 'm': t.minute = value; break;
+      default: t.second = value; break;
+    }
+  }
+  return TIME_MSG_OK;
+}
+
+TimeMessageResult parseTimeMessage(uint32_t addr, const char* str, size_t len, TimeBeacon& beacon) {
+  const TimeFormat* format = nullptr;
+  for (const TimeFormat& f : TIME_FORMATS) {
+    if (f.ric == addr) {
+      format = &f;
+      break;
+    }
+  }
+  if (format == nullptr) {
+    return TIME_MSG_NONE;
+  }
+
+  const char* end = str + len;
+  const char* p   = str;
+  if (format->marker[0] != '\0') {
+    p = strstr(str, format->marker);
+    if (p == nullptr) {
+      return TIME_MSG_SHORT;
+    }
+    p += strlen(format->marker);
+  } else {
+    while (p < end && *p == ' ') {
+      p++;
+    }
+  }
+
+  PagerTime t        = {};
+  TimeMessageResult r = parseFields(p, end, format->fields, t);
+  if (r != TIME_MSG_OK) {
+    return r;
+  }
+
+  t.valid           = true;
+  beacon.time       = t;
+  beacon.local      = format->local;
+  beacon.resolution = format->resolution;
+  return TIME_MSG_OK;
+}
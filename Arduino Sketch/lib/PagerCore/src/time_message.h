@@ -0,0 +1,35 @@
+#pragma once
+
+// DAPNET time beacon parsing. Pure string handling over the received buffer
+// (no copies, no allocation); the caller converts the result to UTC and
+// feeds its clock.
+//
+// The RIC selects the format before the text is looked at:
+//   216, 224    "YYYYMMDDHHMMSS" yymmddhhmmss        UTC
+//   208, 2000   "XTIME=" hhmmddmmyy                  local time, minutes only
+//   2504        hhmmss <blanks> ddmmyy               local time
+
+#include <stddef.h>
+#include <stdint.h>
+#include "pager_time.h"
+
+// Time beacon RICs (all in frame 0)
+const uint32_t TIME_BEACON_RICS[] = { 216, 224, 208, 2000, 2504 };
+
+enum TimeMessageResult {
+  TIME_MSG_NONE,   // not a time RIC
+  TIME_MSG_OK,     // beacon holds the transmitted time
+  TIME_MSG_SHORT,  // time RIC, but pattern missing or string too short
+  TIME_MSG_BAD     // time RIC, but the digits do not fit the format
+};
+
+struct TimeBeacon {
+  PagerTime time;
+  bool      local;       // time is local time, not UTC
+  uint8_t   resolution;  // seconds the transmitted time stands for (1 or 60)
+};
+
+// Parse a beacon of RIC addr. str must be NUL-terminated, len is its length.
+// Fields are only range-checked as digits; pagerTimeInRange() tells whether
+// the date exists.
+TimeMessageResult parseTimeMessage(uint32_t addr, const char* str, size_t len, TimeBeacon& beacon);
@@ -8,6 +8,17 @@ In the near future, bring this to a menu, and load-edit them in SPIFFS
 extern float offset = 0.0000;  // device specific, in MHz. VHF: 0.0014 UHF: 0.0044
 extern float frequency = 439.98750;
 
+#define BAUDRATE 1200 //POCSAG bit rate: 512, 1200, 2400 or 0 = detect it from the preamble
+
+//Frequency scan: with two or more channels (MHz, 0 = unused) the pager hops
+//between them, listening SCAN_DWELL_MS on each until it hears a batch sync.
+//Leave empty to stay on "frequency" above.
+#define SCANNUMBER 4
+#define SCAN_DWELL_MS 1200
+float scanFrequency[SCANNUMBER]={
+        0,
+};
+
 #define RICNUMBER 8 //Maximum number of RIC usable
 #define RINGTONE 4 //Number of ringtones available
 #define NOTENUMBER 8 //Number of tones per ringtone
@@ -4,9 +4,11 @@ This code implements a basic pager, initially designed for DAPNET use, but it ca
 
 Additional files:
  - config.h contains the user configuration (frequency, offset, RIC, ringtones, etc)
+ - /rics.txt on LittleFS, if present, replaces the RICs of config.h (see ric_table.h, "rics" console command)
  - periph.h contains pin assignment
 
-Frequency offset must be configured for reliable decoding. At present time, there is no "cal" mode available, but it is planned.
+Frequency offset must be configured for reliable decoding: start from the value in config.h, then run the "cal" console command,
+which measures the offset on received traffic and saves it to LittleFS. Drift is tracked and corrected during normal operation.
 */
 
 #include <Arduino.h>
@@ -18,9 +20,33 @@ Frequency offset must be configured for reliable decoding. At present time, ther
 #include <WiFi.h>
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
+#include <glcdfont.c>  // classic 5x7 font of Adafruit_GFX, used by the glyph blitter
 #include <FS.h>
 #include <LittleFS.h>
 #include <esp_bt.h>
+#include <atomic>
+#include <freertos/semphr.h>
+#include <esp_pm.h>
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+#include <hal/gpio_ll.h>
+#include <esp_timer.h>
+#include <esp_adc_cal.h>
+#include <pager_time.h>    // lib/PagerCore: hardware-agnostic units (native tests)
+#include <pager_clock.h>
+#include <time_message.h>
+#include <inbox_ring.h>
+#include <inbox_codec.h>
+#include <inbox_history.h>
+#include <text_pack.h>
+#include <notify_player.h>
+#include <offset_cal.h>
+#include <pocsag_codeword.h>
+#include <pocsag_bch.h>
+#include <pocsag_rate.h>
+#include <rf_replay.h>
+#include <ric_table.h>
+#include <page_dedup.h>
 
 // -----------------------------------------------------------------------------
 // Configuration helpers
@@ -32,47 +58,433 @@ Frequency offset must be configured for reliable decoding. At present time, ther
 #define DISPLAY_TIMEOUT_SECONDS 15
 #endif
 
+// Inbox persistence mode:
+// 1 = journal (append one record per page/deletion, compact in the background)
+// 0 = rewrite the complete inbox file on every change
+#ifndef INBOX_JOURNAL_MODE
+#define INBOX_JOURNAL_MODE 1
+#endif
+
+// Journal size in bytes above which the inbox file gets compacted
+#ifndef INBOX_JOURNAL_COMPACT_BYTES
+#define INBOX_JOURNAL_COMPACT_BYTES 16384
+#endif
+
+// Radio receive task: core, priority and poll interval while the receiver is idle.
+// loop() runs on core 1, so the decoder gets core 0 for itself.
+#ifndef RADIO_TASK_CORE
+#define RADIO_TASK_CORE 0
+#endif
+
+#ifndef RADIO_TASK_PRIORITY
+#define RADIO_TASK_PRIORITY 5
+#endif
+
+#ifndef RADIO_TASK_POLL_MS
+#define RADIO_TASK_POLL_MS 10
+#endif
+
+// Burst handling: pages the radio task decodes back-to-back before it yields
+// for a tick, and the depth of the page queue towards loop()
+#ifndef RX_DRAIN_BUDGET
+#define RX_DRAIN_BUDGET 8
+#endif
+
+#ifndef RX_QUEUE_SIZE
+#define RX_QUEUE_SIZE 8
+#endif
+
+// Write-behind persistence: pages arriving within this time are written to
+// flash together (0 = write as soon as the persistence task gets to it)
+#ifndef PERSIST_WRITE_BEHIND_MS
+#define PERSIST_WRITE_BEHIND_MS 2000
+#endif
+
+// Persistence task placement, below the radio task so it never delays decoding
+#ifndef PERSIST_TASK_CORE
+#define PERSIST_TASK_CORE 0
+#endif
+
+#ifndef PERSIST_TASK_PRIORITY
+#define PERSIST_TASK_PRIORITY 1
+#endif
+
+// Let the chip enter light sleep while all tasks are idle
+// (needs an Arduino core built with power management / tickless idle)
+#ifndef LIGHT_SLEEP_ENABLE
+#define LIGHT_SLEEP_ENABLE 1
+#endif
+
+// Longest time loop() sleeps without any timer or event
+#ifndef SCHED_MAX_SLEEP_MS
+#define SCHED_MAX_SLEEP_MS 1000
+#endif
+
+// Frame-slot duty cycling: put the SX1278 to sleep for the part of each batch
+// that cannot carry a page for our RICs (0 = always-on RX)
+#ifndef RX_DUTY_CYCLE
+#define RX_DUTY_CYCLE 0
+#endif
+
+// Wake up this many bits before the next batch sync (2 codewords)
+#ifndef RX_DUTY_WAKE_MARGIN_BITS
+#define RX_DUTY_WAKE_MARGIN_BITS 64
+#endif
+
+// Sleeps shorter than this are not worth the re-sync
+#ifndef RX_DUTY_MIN_SLEEP_MS
+#define RX_DUTY_MIN_SLEEP_MS 20
+#endif
+
+// SX1278 datasheet currents used for the duty cycle estimate
+#ifndef RX_CURRENT_MA
+#define RX_CURRENT_MA 10.8f
+#endif
+
+#ifndef RX_SLEEP_CURRENT_MA
+#define RX_SLEEP_CURRENT_MA 0.0002f
+#endif
+
+// Local time: standard offset from UTC in minutes and the daylight saving
+// rule (PAGER_DST_NONE, PAGER_DST_EU or PAGER_DST_US). Default: Europe/Berlin.
+#ifndef TIME_ZONE_OFFSET_MINUTES
+#define TIME_ZONE_OFFSET_MINUTES 60
+#endif
+
+#ifndef TIME_ZONE_DST_RULE
+#define TIME_ZONE_DST_RULE PAGER_DST_EU
+#endif
+
+// Time beacons further off than this set the clock at once; smaller errors
+// are slewed out at 1/PAGER_CLOCK_SLEW_DIV (pager_clock.h)
+#ifndef TIME_STEP_LIMIT_S
+#define TIME_STEP_LIMIT_S 120
+#endif
+
+// LEDC channel driving the buzzer (notification playback)
+#ifndef NOTIFY_LEDC_CHANNEL
+#define NOTIFY_LEDC_CHANNEL 0
+#endif
+
+// OLED I2C clock, 400 kHz per the SSD1306 datasheet. Many modules also run
+// at 800000 (opt-in: check for garbage on the display first).
+#ifndef OLED_I2C_CLOCK
+#define OLED_I2C_CLOCK 400000UL
+#endif
+
+// Push only the changed 8-row pages of the framebuffer for status bar
+// updates (0 = always send the full 1 KB framebuffer)
+#ifndef OLED_PARTIAL_UPDATE
+#define OLED_PARTIAL_UPDATE 1
+#endif
+
+// Fast boot: start the receiver first, mount LittleFS and restore the inbox
+// in the persistence task, no fixed splash/settle delays
+// (0 = sequential start-up as before)
+#ifndef FAST_BOOT
+#define FAST_BOOT 1
+#endif
+
+// Per-stage latency histograms with a serial dump ("prof").
+// Development aid: 0 compiles every probe out.
+#ifndef PROFILE_ENABLE
+#define PROFILE_ENABLE 0
+#endif
+
+// Battery sampler: one ADC sample per tick into the filter
+#ifndef BATTERY_SAMPLE_MS
+#define BATTERY_SAMPLE_MS 1000
+#endif
+
+// Below this battery voltage the inbox journal is flushed ahead of a brown-out
+#ifndef BATTERY_LOW_VOLTS
+#define BATTERY_LOW_VOLTS 3.40f
+#endif
+
+// How often the RX statistics are saved to LittleFS
+#ifndef RX_STATS_SAVE_MS
+#define RX_STATS_SAVE_MS (15UL * 60UL * 1000UL)
+#endif
+
+// Serial console: baud rate for commands and logs, and for the binary
+// inbox export ("export [baud]" overrides the latter per run)
+#ifndef CONSOLE_BAUD
+#define CONSOLE_BAUD 115200
+#endif
+
+#ifndef CONSOLE_EXPORT_BAUD
+#define CONSOLE_EXPORT_BAUD 921600
+#endif
+
+// UART TX ring buffer: lets Serial.write() return while the FIFO drains,
+// must hold at least one complete export frame
+#ifndef CONSOLE_TX_BUFFER
+#define CONSOLE_TX_BUFFER 2048
+#endif
+
+// Offset calibration: drift corrections are saved at most this often
+// (flash wear); a finished "cal" is saved at once
+#ifndef OFFSET_SAVE_MS
+#define OFFSET_SAVE_MS (30UL * 60UL * 1000UL)
+#endif
+
+// Pages to wait for before comparing the success rate after a calibration
+#ifndef OFFSET_REPORT_PAGES
+#define OFFSET_REPORT_PAGES 20
+#endif
+
+// Channel scan / auto bit rate: stay on a channel this long after its last
+// batch sync before hunting again (covers the gaps between transmissions)
+#ifndef RX_SCAN_HOLD_MS
+#define RX_SCAN_HOLD_MS 5000
+#endif
+
+// BCH(31,21) codeword correction in front of PagerClient: fixes 1-2 bit
+// errors per codeword and accepts errored sync words, one codeword of delay
+#ifndef POCSAG_BCH_ENABLE
+#define POCSAG_BCH_ENABLE 0
+#endif
+
+// RF replay harness: "replay" console command plays synthetic or recorded
+// POCSAG streams into the decoder instead of the SX1278. Development aid.
+#ifndef RF_REPLAY_ENABLE
+#define RF_REPLAY_ENABLE 0
+#endif
+
+// RAM for synthetic replay streams (about 100 long pages)
+#ifndef RF_REPLAY_BUFFER_BYTES
+#define RF_REPLAY_BUFFER_BYTES 16384
+#endif
+
+// Pages to addresses (or function codes) that are not in the RIC table are
+// dropped by the radio task before they reach the queue, the log or the
+// display. 0 = log them on the serial console as before.
+#ifndef RIC_DROP_UNSUBSCRIBED
+#define RIC_DROP_UNSUBSCRIBED 0
+#endif
+
+// A page arriving again (other transmitter, resend) within this window is
+// not stored or rung again. 0 = keep every copy.
+#ifndef PAGE_DEDUP_WINDOW_MS
+#define PAGE_DEDUP_WINDOW_MS (5UL * 60UL * 1000UL)
+#endif
+
 // Path for the persistent inbox file in LittleFS
 const char* INBOX_FILE_PATH = "/inbox.log";
+// Temporary file used while compacting (renamed over INBOX_FILE_PATH when complete)
+const char* INBOX_TMP_PATH  = "/inbox.tmp";
+// RIC subscription table (text, see ric_table.h); ric[] in config.h if missing
+const char* RIC_TABLE_PATH  = "/rics.txt";
 
 // -----------------------------------------------------------------------------
 // Firmware version
 // -----------------------------------------------------------------------------
 const char* FW_VERSION = "v0.2a";
 
+// -----------------------------------------------------------------------------
+// Stage profiling (PROFILE_ENABLE)
+//
+// PROFILE_SCOPE(stage) times the rest of the enclosing block with the CPU
+// cycle counter and files it into a log2 histogram per stage (bucket i holds
+// durations below 2^i µs). Every stage is recorded by one task only, the
+// serial dump reads without locking. With PROFILE_ENABLE 0 the macros expand
+// to nothing and none of this is compiled.
+// -----------------------------------------------------------------------------
+#if PROFILE_ENABLE
+enum ProfStage {
+  PROF_CLOCK,       // pagerLocalTime() date computation
+  PROF_BUTTONS,     // handleButtons()
+  PROF_DISPLAY_PS,  // handleDisplayPowerSave()
+  PROF_NOTIFY,      // notification step (esp_timer task)
+  PROF_RING,        // ringBuzzer(), starting a notification (loop)
+  PROF_CLOCK_BAR,   // status bar redraw + flush
+  PROF_RX_PAGES,    // handleReceivedPages()
+  PROF_READ_DATA,   // pager.readData() (radio task)
+  PROF_STORE,       // storeMessage()
+  PROF_PERSIST,     // journal append / snapshot (persistence task)
+  PROF_FLUSH_NOW,   // inboxFlushNow() on low battery (loop)
+  PROF_STAGE_COUNT
+};
+
+const char* const PROF_STAGE_NAMES[PROF_STAGE_COUNT] = {
+  "clock", "buttons", "displayPS", "notify", "ring", "clockBar",
+  "rxPages", "readData", "store", "persist", "flushNow"
+};
+
+const int PROF_BUCKETS = 21;  // last bucket: 2^19 µs (~0.5 s) and more
+
+struct ProfHistogram {
+  uint32_t count;
+  uint32_t minUs;
+  uint32_t maxUs;
+  uint64_t totalUs;
+  uint32_t buckets[PROF_BUCKETS];
+};
+
+ProfHistogram profHist[PROF_STAGE_COUNT];
+uint32_t      profCyclesPerUs = 80;
+
+void profReset() {
+  memset(profHist, 0, sizeof(profHist));
+  for (ProfHistogram& h : profHist) {
+    h.minUs = UINT32_MAX;
+  }
+}
+
+void profInit() {
+  profCyclesPerUs = ESP.getCpuFreqMHz();
+  profReset();
+}
+
+void profRecord(ProfStage stage, uint32_t cycles) {
+  ProfHistogram& h  = profHist[stage];
+  uint32_t       us = cycles / profCyclesPerUs;
+
+  int bucket = (us == 0) ? 0 : 32 - __builtin_clz(us);  // us < 2^bucket
+  if (bucket >= PROF_BUCKETS) {
+    bucket = PROF_BUCKETS - 1;
+  }
+
+  h.buckets[bucket]++;
+  h.count++;
+  h.totalUs += us;
+  if (us < h.minUs) h.minUs = us;
+  if (us > h.maxUs) h.maxUs = us;
+}
+
+struct ProfScope {
+  ProfStage stage;
+  uint32_t  start;
+
+  explicit ProfScope(ProfStage s) : stage(s), start(ESP.getCycleCount()) {}
+  ~ProfScope() { profRecord(stage, ESP.getCycleCount() - start); }
+};
+
+#define PROF_CONCAT2(a, b) a##b
+#define PROF_CONCAT(a, b)  PROF_CONCAT2(a, b)
+#define PROFILE_SCOPE(stage) ProfScope PROF_CONCAT(profScope, __LINE__)(stage)
+#define PROFILE_CALL(stage, ...) do { ProfScope profScope(stage); __VA_ARGS__; } while (0)
+
+// Upper bound of the bucket holding the 99th percentile
+uint32_t profP99Us(const ProfHistogram& h) {
+  uint64_t seen = 0;
+  for (int b = 0; b < PROF_BUCKETS; ++b) {
+    seen += h.buckets[b];
+    if (seen * 100 >= (uint64_t)h.count * 99) {
+      return 1UL << b;
+    }
+  }
+  return h.maxUs;
+}
+
+// Serial dump: one summary line per stage, then its non-empty buckets
+void profDump() {
+  char line[96];
+
+  Serial.println(F("[Prof] stage        count     min     avg    p99<=     max (us)"));
+  for (int s = 0; s < PROF_STAGE_COUNT; ++s) {
+    const ProfHistogram& h = profHist[s];
+    if (h.count == 0) {
+      continue;
+    }
+
+    snprintf(line, sizeof(line), "[Prof] %-10s %7lu %7lu %7lu %8lu %7lu",
+             PROF_STAGE_NAMES[s],
+             (unsigned long)h.count,
+             (unsigned long)h.minUs,
+             (unsigned long)(h.totalUs / h.count),
+             (unsigned long)profP99Us(h),
+             (unsigned long)h.maxUs);
+    Serial.println(line);
+
+    Serial.print(F("[Prof]   <us:count"));
+    for (int b = 0; b < PROF_BUCKETS; ++b) {
+      if (h.buckets[b] != 0) {
+        Serial.print(' ');
+        Serial.print(1UL << b);
+        Serial.print(':');
+        Serial.print(h.buckets[b]);
+      }
+    }
+    Serial.println();
+  }
+}
+#else
+#define PROFILE_SCOPE(stage) do {} while (0)
+#define PROFILE_CALL(stage, ...) do { __VA_ARGS__; } while (0)
+#endif
+
 // -----------------------------------------------------------------------------
 // Battery measurement (VBAT on GPIO35)
 // -----------------------------------------------------------------------------
 #if defined(ESP32)
-const int   PIN_BATTERY_ADC   = 35;    // ADC pin for battery voltage
-const float ADC_REF_VOLTAGE   = 3.3f;  // approximate ADC reference voltage
-const int   ADC_MAX_VALUE     = 4095;  // 12-bit ADC
+const int   PIN_BATTERY_ADC   = 35;    // ADC pin for battery voltage (ADC1 channel 7)
+const uint32_t ADC_DEFAULT_VREF_MV = 1100;  // used if the chip has no eFuse calibration
 
 // Voltage divider ratio: VBAT / Vadc
 // Example: 100k / 100k -> factor 2.0 (4.2V -> ~2.1V at ADC).
 // Adjust if your board uses a different divider.
 const float BAT_VDIV_RATIO    = 2.0f;
 
-float batteryVoltage = 0.0f;          // last measured battery voltage
+// Filter window: trimmed mean (min and max dropped) over the last samples
+const int   BATTERY_FILTER_SIZE      = 8;
+const float BATTERY_LOW_HYSTERESIS   = 0.10f;  // V above BATTERY_LOW_VOLTS to clear
+const float BATTERY_PRESENT_MIN_VOLTS = 2.5f;  // below: no battery connected
+const unsigned long BATTERY_WARMUP_MS = 50;    // sample interval until the window is refreshed
+
+float batteryVoltage = 0.0f;          // filtered battery voltage, always ready
+bool  batteryLow     = false;         // below BATTERY_LOW_VOLTS
+
+esp_adc_cal_characteristics_t batteryAdcChars;
+uint16_t      batterySamples[BATTERY_FILTER_SIZE];  // pin voltage in mV
+uint8_t       batterySampleNext       = 0;
+uint8_t       batteryWarmupLeft       = 0;  // fast samples left after boot
+unsigned long batteryLastSampleMillis = 0;
 #endif
 
 // -----------------------------------------------------------------------------
 // Radio & pager instances
 // -----------------------------------------------------------------------------
-SX1278 radio = new Module(LORA_SS, LORA_DIO0, LORA_RST, LORA_DIO1);  // Radio module instance
+// Sampled, corrected or replayed bits go into RadioLib's direct-mode buffer
+// exactly where readBit() puts the DIO2 level (updateDirectBuffer() is protected)
+class PagerRadio : public SX1278 {
+public:
+  explicit PagerRadio(Module* mod) : SX1278(mod) {}
+  void feedBit(uint8_t bit) { updateDirectBuffer(bit); }
+};
+
+PagerRadio radio(new Module(LORA_SS, LORA_DIO0, LORA_RST, LORA_DIO1));  // Radio module instance
 PagerClient pager(&radio);                                           // Pager client instance
 
+// POCSAG bit rate from config.h; auto rate starts hunting at the fastest one
+const uint16_t POCSAG_BIT_RATE = BAUDRATE != 0 ? BAUDRATE : POCSAG_HUNT_BIT_RATE;
+uint16_t       rxBitRate       = POCSAG_BIT_RATE;  // SX1278 bit rate right now
+
+#if CONFIG_PM_ENABLE
+esp_pm_lock_handle_t radioPmLock = nullptr;  // held while the receiver needs the CPU awake
+#endif
+
+// Runtime retune request from the serial console, applied by the radio task
+// (the values are written before the flag is raised)
+std::atomic<bool> radioRetunePending{false};
+float             radioRetuneFrequency = 0.0f;  // MHz
+float             radioRetuneOffset    = 0.0f;  // MHz
+
 // -----------------------------------------------------------------------------
 // Display setup
 // -----------------------------------------------------------------------------
 #define SCREEN_ADDRESS 0x3C  // 0x3D for 128x64, 0x3C for 128x32 (SSD1306 address)
 
-Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RST);
+// Keep the fast clock after each transfer too, our partial updates use Wire directly
+Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RST, OLED_I2C_CLOCK, OLED_I2C_CLOCK);
 
 // Layout constants
 const int STATUS_BAR_HEIGHT = 10;
 const int SCREEN_W          = 128;
 const int SCREEN_H          = 64;
+const int SCREEN_PAGES      = SCREEN_H / 8;  // SSD1306 pages of 8 rows
+const int FONT_W            = 6;             // TextSize 1 glyph cell
+const int FONT_H            = 8;
 
 // Display power-save
 bool         displayIsOn               = true;
@@ -81,7 +493,17 @@ int          displayTimeoutSeconds     = DISPLAY_TIMEOUT_SECONDS;
 
 // Inbox state (0-based)
 int inboxCurrent = 0;  // currently selected/visible inbox message
-int inboxTotal   = 0;  // total number of messages in inbox (logical count)
+
+// Below the oldest RAM message the inbox view continues into the history
+bool     inboxInHistory  = false;  // showing a history page instead of inboxCurrent
+uint32_t inboxHistorySeq = 0;      // its sequence number
+
+// Scroll position inside the message shown in the inbox view
+const int INBOX_SCROLL_HISTORY = -2;  // inboxScrollSlot of a history page
+int      inboxScrollSlot  = -1;     // slot the scroll position belongs to
+uint32_t inboxScrollSeq   = 0;      // history page it belongs to
+int      inboxScrollLine  = 0;      // first visible body line
+bool inboxViewActive  = false;  // inbox view (not a new page or the menu) on screen
 
 // Inbox menu state
 bool inboxMenuActive = false;
@@ -92,104 +514,300 @@ const int   INBOX_MENU_ITEM_COUNT = 3;
 // Persistent storage status
 bool storageOk = false;
 
-// -----------------------------------------------------------------------------
-// Time structures and helpers
-// -----------------------------------------------------------------------------
-struct PagerTime {
-  int  year;
-  int  month;
-  int  day;
-  int  hour;
-  int  minute;
-  int  second;
-  bool valid;
+// Inbox restored from LittleFS; until then loop() leaves the inbox alone
+// (received pages wait in the radio queue, button edges in theirs)
+std::atomic<bool> inboxReady(false);
+
+// Last status bar refresh (loop() redraws it once per second)
+unsigned long lastClockDrawMillis = 0;
+
+// Status bar texts as currently drawn in the framebuffer
+struct StatusBarText {
+  char left[20];   // date + time
+  char right[12];  // inbox "x/n"
 };
 
-PagerTime     pagerTime            = {0, 0, 0, 0, 0, 0, false};
-unsigned long lastTimeUpdateMillis = 0;
+StatusBarText statusBarShown = {};
+
+// Dirty column range per display page (dirtyX0 > dirtyX1 = page clean)
+uint8_t displayDirtyX0[SCREEN_PAGES];
+uint8_t displayDirtyX1[SCREEN_PAGES];
 
-// Time offset in minutes relative to UTC
-// Example for Europe/Berlin: winter = 60, summer = 120
-int timeOffsetMinutes = 60;
+// -----------------------------------------------------------------------------
+// Pager clock (PagerEpoch, PagerTime and the calendar live in pager_time.h)
+//
+// A single UTC counter: the last time beacon plus the esp_timer time since
+// it arrived, corrections slewed in (pager_clock.h). Nothing ticks, so light
+// sleep and long stalls need no catch-up; local date fields are computed
+// only when they are shown or stored (pagerLocalTime()).
+// -----------------------------------------------------------------------------
+PagerClock pagerClock = {};
 
 // -----------------------------------------------------------------------------
 // Reading VBat
+//
+// The sampler never blocks: loop() takes one calibrated sample every
+// BATTERY_SAMPLE_MS (TIMER_BATTERY) and batteryVoltage always holds the
+// filtered value for the display.
 // -----------------------------------------------------------------------------
 
 #if defined(ESP32)
-float readBatteryVoltage() {
-  // We take multiple samples and average them to reduce noise
-  const int samples = 8;
-  uint32_t sum      = 0;
+void inboxFlushNow();
 
-  for (int i = 0; i < samples; ++i) {
-    sum += analogRead(PIN_BATTERY_ADC);
-    delay(2); // small pause between samples
+// One ADC reading in mV at the pin, corrected with the chip's eFuse calibration
+uint16_t batterySampleMv() {
+  return (uint16_t)esp_adc_cal_raw_to_voltage(analogRead(PIN_BATTERY_ADC), &batteryAdcChars);
+}
+
+// Trimmed mean of the filter window, as battery voltage
+float batteryFilteredVoltage() {
+  uint32_t sum = 0;
+  uint16_t lo  = 0xFFFF;
+  uint16_t hi  = 0;
+
+  for (uint16_t mv : batterySamples) {
+    sum += mv;
+    lo   = min(lo, mv);
+    hi   = max(hi, mv);
   }
 
+  float pinMv = (float)(sum - lo - hi) / (float)(BATTERY_FILTER_SIZE - 2);
+  return pinMv / 1000.0f * BAT_VDIV_RATIO;
+}
+
+// Configure the ADC and fill the filter with a first reading
+void batteryInit() {
+  analogReadResolution(12);                           // 0..4095
+  analogSetPinAttenuation(PIN_BATTERY_ADC, ADC_11db); // up to ~3.6V at pin
+
+  esp_adc_cal_value_t cal = esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_12,
+                                                     ADC_DEFAULT_VREF_MV, &batteryAdcChars);
 
-  float avg = (float)sum / (float)samples;
+  Serial.print(F("[Battery] ADC calibration: "));
+  if (cal == ESP_ADC_CAL_VAL_EFUSE_TP) {
+    Serial.println(F("eFuse two point"));
+  } else if (cal == ESP_ADC_CAL_VAL_EFUSE_VREF) {
+    Serial.println(F("eFuse Vref"));
+  } else {
+    Serial.println(F("default Vref"));
+  }
 
-  // Convert ADC value to voltage at the pin
-  float vAdc = (avg / (float)ADC_MAX_VALUE) * ADC_REF_VOLTAGE;
+  uint16_t mv = batterySampleMv();
+  for (uint16_t& sample : batterySamples) {
+    sample = mv;
+  }
 
-  // Convert to real battery voltage using the divider ratio
-  float vBat = vAdc * BAT_VDIV_RATIO;
+  batteryVoltage          = batteryFilteredVoltage();
+  batteryLastSampleMillis = millis();
 
-  return vBat;
+  // The first reading may still see the supply settling: replace the
+  // whole window quickly instead of waiting for it
+  batteryWarmupLeft       = BATTERY_FILTER_SIZE;
 }
-#endif
-#if defined(ESP32)
-void updateBatteryMeasurement() {
-  // Update global batteryVoltage with a fresh reading
-  batteryVoltage = readBatteryVoltage();
+
+// Interval until the next sample
+unsigned long batterySampleInterval() {
+  return batteryWarmupLeft > 0 ? BATTERY_WARMUP_MS : BATTERY_SAMPLE_MS;
+}
+
+// Battery dropped below BATTERY_LOW_VOLTS: get the queued journal records
+// onto flash while there is still enough voltage to write them
+void onBatteryLow() {
+  Serial.print(F("[Battery] Low: "));
+  Serial.print(batteryVoltage, 2);
+  Serial.println(F("V, flushing inbox"));
+
+  inboxFlushNow();
+}
+
+// Take the next sample when it is due (called from loop())
+void handleBattery() {
+  unsigned long now = millis();
+  if (now - batteryLastSampleMillis < batterySampleInterval()) {
+    return;
+  }
+  batteryLastSampleMillis = now;
+  if (batteryWarmupLeft > 0) {
+    batteryWarmupLeft--;
+  }
+
+  batterySamples[batterySampleNext] = batterySampleMv();
+  batterySampleNext                 = (batterySampleNext + 1) % BATTERY_FILTER_SIZE;
+  batteryVoltage                    = batteryFilteredVoltage();
+
+  if (batteryVoltage < BATTERY_PRESENT_MIN_VOLTS) {
+    // No battery (USB only): nothing to warn about
+    batteryLow = false;
+  } else if (!batteryLow && batteryVoltage < BATTERY_LOW_VOLTS) {
+    batteryLow = true;
+    onBatteryLow();
+  } else if (batteryLow && batteryVoltage > BATTERY_LOW_VOLTS + BATTERY_LOW_HYSTERESIS) {
+    batteryLow = false;
+  }
 }
 #endif
 // -----------------------------------------------------------------------------
 // Inbox structures
 // -----------------------------------------------------------------------------
-const int INBOX_SIZE = 64;
+// Slots, text arena and chronological order (INBOX_SIZE, INBOX_TEXT_MAX
+// and PageMessage are in inbox_ring.h)
+InboxRing inboxRing;
+
+// Message text layout, computed once when the text is stored: where each
+// display line starts and how many characters it shows. Lines break at word
+// boundaries; words longer than a line are split.
+const int TEXT_CHARS_PER_LINE = 21;  // ~128px / 6px per character
+
+// A line ends early only if the next word does not fit, so any two adjacent
+// lines hold more than TEXT_CHARS_PER_LINE characters
+const int TEXT_LINES_MAX = (2 * INBOX_TEXT_MAX) / (TEXT_CHARS_PER_LINE + 1) + 2;
+
+struct TextLayout {
+  uint8_t lineCount;
+  uint8_t lineStart[TEXT_LINES_MAX];
+  uint8_t lineLen[TEXT_LINES_MAX];
+};
+
+TextLayout inboxLayout[INBOX_SIZE];
+
+int inboxCurrentPos = 0;  // 1-based position of inboxCurrent in inboxRing.order
+
+// Older pages on LittleFS, indexed in RAM (inbox_history.h)
+InboxHistory inboxHistory;
+HistoryCache historyCache;
+int          historyQueueCount   = 0;      // evicted pages waiting, under inboxMutex
+bool         historyClearPending = false;  // "Del All": remove the segments
+
+// Inbox journal state
+size_t inboxJournalBytes   = 0;      // current size of the inbox file
+bool   inboxCompactPending = false;  // journal needs to be compacted
+
+// -----------------------------------------------------------------------------
+// RX statistics state
+//
+// Monotonic counters since boot. Every counter has exactly one writer (bit
+// interrupt, radio task, loop() or persistence task), aligned 32-bit words
+// are read consistently from the other core. The persisted totals of earlier
+// boots live in rxStatsBase; what is shown and saved is base + session.
+// The receive path counts through rxCount, which an RF replay points at its
+// own counters for the run; flash writes always go to rxStats.
+// -----------------------------------------------------------------------------
+enum RxStatId {
+  RX_STAT_BOOTS,          // start-ups (session: 1)
+  RX_STAT_DECODED,        // pages read from RadioLib (radio task)
+  RX_STAT_FAILED,         // readData() errors (radio task)
+  RX_STAT_FAIL_OTHER,     // errors whose code did not fit the code table
+  RX_STAT_TIME_BEACONS,   // pages to a time RIC (loop)
+  RX_STAT_BYTES_STORED,   // text bytes put into the inbox (loop)
+  RX_STAT_FLASH_WRITES,   // journal/snapshot/statistics writes (persistence task)
+  RX_STAT_SYNCS,          // batch sync acquired after hunting (bit interrupt)
+  RX_STAT_SYNC_LOSSES,    // expected sync missing, incl. end of transmission
+  RX_STAT_BATCHES,        // complete batches received
+  RX_STAT_IDLE_BATCHES,   // batches of idle codewords only
+  RX_STAT_FEC_WORDS,      // codewords with 1-2 bits corrected (POCSAG_BCH_ENABLE)
+  RX_STAT_FEC_BITS,       // bits corrected in them
+  RX_STAT_FEC_FAILED,     // codewords with more errors, passed on as received
+  RX_STAT_FEC_SYNCS,      // sync words accepted with bit errors
+  RX_STAT_UNSUBSCRIBED,   // pages to RICs/functions not in the table (radio task)
+  RX_STAT_DUPLICATES,     // copies dropped by the dedup cache (loop)
+  RX_STAT_COUNT
+};
+
+const int RX_STATS_FAIL_CODES = 4;  // distinct readData() error codes kept
+
+struct RxFailCode {
+  int32_t  code;
+  uint32_t count;  // 0 = entry unused
+};
+
+// Pages of one subscription, keyed by address and function rather than by
+// table index, so `rics` edits that shift the table do not move the counts
+struct RxRicCount {
+  uint32_t addr;
+  uint8_t  function;
+  uint32_t count;  // 0 = entry unused
+};
 
-struct PageMessage {
-  uint32_t  addr;
-  String    ricName;
-  String    text;
-  PagerTime time;
-  bool      valid;
+struct RxStatsCounters {
+  uint32_t   n[RX_STAT_COUNT];
+  RxRicCount ricPages[RICNUMBER];  // pages per subscription (the first RICNUMBER seen)
+  RxFailCode fail[RX_STATS_FAIL_CODES];
+  uint32_t   backlogMax;           // deepest RadioLib backlog (high-water mark)
+  uint32_t   queueDropped;         // pages lost because loop() fell behind
 };
 
-PageMessage inbox[INBOX_SIZE];
-int         inboxCount      = 0;  // number of valid entries
-int         inboxWriteIndex = 0;  // next write position (ring buffer)
+RxStatsCounters rxStats     = {};  // this boot
+RxStatsCounters rxStatsBase = {};  // earlier boots (from LittleFS)
+RxStatsCounters* volatile rxCount = &rxStats;  // receive path: rxStats, or the replay's
+bool            rxStatsSavePending = false;
+bool            offsetSavePending  = false;  // calibrated offset to LittleFS
+
+// readData() error: count it under its code (radio task)
+void rxStatsCountFailure(int code) {
+  RxStatsCounters& stats = *rxCount;
+  stats.n[RX_STAT_FAILED]++;
+
+  for (RxFailCode& f : stats.fail) {
+    if (f.count == 0) {
+      f.code = code;  // code store before count: readers skip empty entries
+    }
+    if (f.code == code) {
+      f.count++;
+      return;
+    }
+  }
+  stats.n[RX_STAT_FAIL_OTHER]++;
+}
+
+// Page to a subscribed table entry (loop). Once RICNUMBER different entries
+// were counted this boot, further ones go uncounted.
+void rxStatsCountRic(uint32_t addr, uint8_t function) {
+  for (RxRicCount& c : rxCount->ricPages) {
+    if (c.count == 0) {
+      c.addr     = addr;  // key store before count: readers skip empty entries
+      c.function = function;
+    }
+    if (c.addr == addr && c.function == function) {
+      c.count++;
+      return;
+    }
+  }
+}
+
+// Pages counted for one table entry
+uint32_t rxStatsRicPages(const RxStatsCounters& t, uint32_t addr, uint8_t function) {
+  for (const RxRicCount& c : t.ricPages) {
+    if (c.count != 0 && c.addr == addr && c.function == function) {
+      return c.count;
+    }
+  }
+  return 0;
+}
 
 // -----------------------------------------------------------------------------
 // New message reminder state
 // -----------------------------------------------------------------------------
 
 // New message reminder (LED blink every 30s until acknowledged)
-bool         newMessagePending          = false;
-unsigned long lastReminderBlinkMillis   = 0;
-const unsigned long REMINDER_INTERVAL_MS = 30000;  // 30 seconds
-
-bool         reminderPulseActive        = false;
-unsigned long reminderPulseEndMillis    = 0;
-const unsigned long REMINDER_PULSE_MS   = 50;      // 50ms LED pulse
+bool           newMessagePending    = false;
+const uint32_t REMINDER_INTERVAL_MS = 30000;  // 30 seconds
+const uint16_t REMINDER_PULSE_MS    = 50;     // 50ms LED pulse
 
 // -----------------------------------------------------------------------------
-// Non-blocking notification (buzzer + LED blink) state
+// Notification playback (buzzer + LED blink) state
 // -----------------------------------------------------------------------------
 
-struct NotifyState {
-  bool         active;
-  unsigned long lastStepMillis;
-  int          step;
-  int          ringToneChoice;
-};
-
-NotifyState notifyState = { false, 0, 0, 0 };
+const uint16_t NOTIFY_STEP_MS   = 100; // 100ms per step
+const int      NOTIFY_LED_STEPS = 40;  // 40 steps = 4 seconds total
 
-const unsigned long NOTIFY_STEP_MS   = 100; // 100ms per step
-const int           NOTIFY_LED_STEPS = 40;  // 40 steps = 4 seconds total
+NotifyPattern        notifyRings[RINGTONE];  // per ringtone, built from beepTones
+NotifyPattern        notifyReminderPattern;
+NotifyPlayer         notifyPlayer;           // under notifyMux: loop() and the esp_timer task
+portMUX_TYPE         notifyMux        = portMUX_INITIALIZER_UNLOCKED;
+esp_timer_handle_t   notifyTimer      = nullptr;
+bool                 notifyReminderOn = false;    // newMessagePending as last handed to the player
+uint16_t             notifyFreqHz     = 0;        // tone on the buzzer (esp_timer task)
+esp_pm_lock_handle_t notifyPmLock     = nullptr;  // held while a tone sounds
 
 // -----------------------------------------------------------------------------
 // Forward declarations
@@ -201,15 +819,49 @@ void inboxShowPrev();
 void onUpPressed();
 void onDownPressed();
 void onEnterPressed();
+void onEnterLongPressed();
 void handleButtons();
 void handleDisplayPowerSave();
-void handleNewMessageReminder();
-void handleNotify();
+void notifyReminderSync();
 void saveInboxToFS();
+void inboxLock();
+void inboxUnlock();
 void loadInboxFromFS();
 void resetInboxMemory();
-void restorePushMessage(const PageMessage& msg);
+void restorePushMessage(const PageMessage& msg, const char* text, size_t textLen);
+void persistStoredMessage(int slot);
+void persistDeletedMessage(int slot);
+void persistTaskStart();
+void inboxFlushNow();
+void radioTaskStart();
+void handleReceivedPages();
+bool isTimeBeaconRic(uint32_t addr);
+const PagerTime& pagerLocalTime();
+bool replayActive();
+void schedWakeLoop();
+void schedWakeFromIsr();
+void powerInit();
+void schedArmTimers();
+void schedWaitForEvent();
+void powerArmWakeup();
+void powerDisarmWakeup();
 void storageInit();
+void storageInitMemory();
+void storageMount();
+void rxStatsLoad();
+void offsetCalLoad();
+void offsetCalSave();
+void ricTableLoad();
+void historyLoad();
+void historyQueueEvicted(int slot);
+void historyRequestClear();
+void historyFlushLocked();
+void rxStatsSave();
+void rxStatsPageOpen();
+unsigned long rxStatsNextDue();
+bool consoleNextDue(unsigned long& due);
+void rxStatsPageButton(int id);
+extern bool rxStatsPageActive;
 void displaySetOn(bool on);
 void markDisplayActivity();
 void displayInboxMenu();
@@ -228,6 +880,145 @@ void clearContentArea() {
   display.fillRect(0, STATUS_BAR_HEIGHT, SCREEN_W, SCREEN_H - STATUS_BAR_HEIGHT, BLACK);
 }
 
+// Forget all dirty regions (framebuffer and panel are in sync)
+void displayDirtyClear() {
+  for (int page = 0; page < SCREEN_PAGES; ++page) {
+    displayDirtyX0[page] = 0xFF;
+    displayDirtyX1[page] = 0;
+  }
+}
+
+// Mark a framebuffer rectangle as changed since the last flush
+void displayMarkDirty(int x, int y, int w, int h) {
+  if (w <= 0 || h <= 0) {
+    return;
+  }
+
+  int x0 = max(x, 0);
+  int x1 = min(x + w - 1, SCREEN_W - 1);
+  int p0 = max(y, 0) / 8;
+  int p1 = min(y + h - 1, SCREEN_H - 1) / 8;
+
+  for (int page = p0; page <= p1 && x0 <= x1; ++page) {
+    if (x0 < displayDirtyX0[page]) displayDirtyX0[page] = x0;
+    if (x1 > displayDirtyX1[page]) displayDirtyX1[page] = x1;
+  }
+}
+
+// Send the complete framebuffer
+void displayFlushAll() {
+  display.display();
+  displayDirtyClear();
+}
+
+// Send only the dirty column ranges of the dirty pages. The panel runs in
+// horizontal addressing mode, so after setting the page/column window the
+// data bytes go straight from the framebuffer (one byte = 8 rows of a column).
+void displayFlushDirty() {
+#if OLED_PARTIAL_UPDATE
+  const uint8_t* buffer = display.getBuffer();
+  const size_t   chunk  = 32;  // data bytes per I2C transaction (Wire buffer)
+
+  for (int page = 0; page < SCREEN_PAGES; ++page) {
+    if (displayDirtyX0[page] > displayDirtyX1[page]) {
+      continue;
+    }
+
+    uint8_t x0 = displayDirtyX0[page];
+    uint8_t x1 = displayDirtyX1[page];
+
+    Wire.beginTransmission(SCREEN_ADDRESS);
+    Wire.write((uint8_t)0x00);  // Co = 0, D/C = 0: command stream
+    Wire.write((uint8_t)SSD1306_PAGEADDR);
+    Wire.write((uint8_t)page);
+    Wire.write((uint8_t)page);
+    Wire.write((uint8_t)SSD1306_COLUMNADDR);
+    Wire.write(x0);
+    Wire.write(x1);
+    Wire.endTransmission();
+
+    const uint8_t* data = buffer + page * SCREEN_W + x0;
+    size_t         left = x1 - x0 + 1;
+    while (left > 0) {
+      size_t n = (left > chunk) ? chunk : left;
+      Wire.beginTransmission(SCREEN_ADDRESS);
+      Wire.write((uint8_t)0x40);  // D/C = 1: data stream
+      Wire.write(data, n);
+      Wire.endTransmission();
+      data += n;
+      left -= n;
+    }
+  }
+
+  displayDirtyClear();
+#else
+  displayFlushAll();
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// Fast text output
+//
+// Text in TextSize 1 goes straight into the SSD1306 framebuffer instead of
+// through Adafruit_GFX::print(): the classic font already stores each glyph as
+// 5 column bytes (LSB = top row), which is exactly the page layout of the
+// panel, so a glyph is 5 ORs (10 if it straddles two pages) instead of up to
+// 40 drawPixel() calls. White on black, display rotation 0.
+// -----------------------------------------------------------------------------
+
+// Width in pixels of len characters (fixed 6 px cells)
+constexpr int textWidth(size_t len) {
+  return (int)len * FONT_W;
+}
+
+// Width of a string literal, at compile time
+template <size_t N>
+constexpr int textWidth(const char (&)[N]) {
+  return textWidth(N - 1);
+}
+
+// Draw one code page 437 glyph with its top-left corner at x/y
+void blitGlyph(int x, int y, uint8_t c) {
+  if (x <= -FONT_W || x >= SCREEN_W || y < 0 || y >= SCREEN_H) {
+    return;
+  }
+
+  uint8_t*             page0 = display.getBuffer() + (y / 8) * SCREEN_W;
+  uint8_t              shift = y & 7;
+  uint8_t*             page1 = (shift && y / 8 + 1 < SCREEN_PAGES) ? page0 + SCREEN_W : nullptr;
+  const unsigned char* glyph = font + c * 5;
+
+  for (int i = 0; i < 5; ++i) {
+    int col = x + i;
+    if (col < 0 || col >= SCREEN_W) {
+      continue;
+    }
+    uint8_t bits  = pgm_read_byte(glyph + i);
+    page0[col]   |= (uint8_t)(bits << shift);
+    if (page1) {
+      page1[col] |= (uint8_t)(bits >> (8 - shift));
+    }
+  }
+}
+
+// Draw len characters at x/y, returns the x position after the text
+int blitText(int x, int y, const char* text, size_t len) {
+  for (size_t i = 0; i < len; ++i, x += FONT_W) {
+    blitGlyph(x, y, (uint8_t)text[i]);
+  }
+  return x;
+}
+
+int blitText(int x, int y, const char* text) {
+  return blitText(x, y, text, strlen(text));
+}
+
+// Draw text right-aligned to the screen edge
+void blitTextRight(int y, const char* text) {
+  size_t len = strlen(text);
+  blitText(SCREEN_W - textWidth(len), y, text, len);
+}
+
 // Turn the OLED display on or off (hardware power-save)
 void displaySetOn(bool on) {
   if (on == displayIsOn) {
@@ -237,13 +1028,9 @@ void displaySetOn(bool on) {
   displayIsOn = on;
 
   if (displayIsOn) {
-    // When the display is turned on, we update the battery reading
-#if defined(ESP32)
-    updateBatteryMeasurement();
-#endif
     // Turn the OLED panel back on, keep buffer content
     display.ssd1306_command(SSD1306_DISPLAYON);
-    display.display();
+    displayFlushAll();
   } else {
     // Turn the OLED panel off
     display.ssd1306_command(SSD1306_DISPLAYOFF);
@@ -286,87 +1073,66 @@ void handleDisplayPowerSave() {
 }
 
 // -----------------------------------------------------------------------------
-// Time helpers
+// RIC table helpers
+//
+// The subscription table lives in two copies: the bit interrupt, the radio
+// task and loop() read the published one, a change is built in the other
+// copy and published with one pointer store (see ricTablePublish()).
 // -----------------------------------------------------------------------------
+static_assert(RIC_TABLE_MAX <= RIC_INDEX_NONE && RIC_NOT_FOUND == RIC_INDEX_NONE,
+              "inbox pages store the entry index in one byte");
 
-// Add minutes to pagerTime and handle day/month/year overflow
-void addMinutesToPagerTime(int deltaMin) {
-  if (!pagerTime.valid || deltaMin == 0) {
-    return;
-  }
+RicTable               ricTables[2];
+std::atomic<RicTable*> ricActive(&ricTables[0]);
 
-  // Convert everything to minutes
-  long totalMin = pagerTime.hour * 60L + pagerTime.minute + deltaMin;
-
-  // Extract day offset and hour/minute
-  int dayOffset = 0;
-  while (totalMin < 0) {
-    totalMin += 24L * 60L;
-    dayOffset--;
-  }
-  while (totalMin >= 24L * 60L) {
-    totalMin -= 24L * 60L;
-    dayOffset++;
-  }
+inline const RicTable& ricTable() {
+  return *ricActive.load(std::memory_order_acquire);
+}
 
-  pagerTime.hour   = totalMin / 60;
-  pagerTime.minute = totalMin % 60;
+// The copy that is not published, to build the next version in
+RicTable& ricSpare() {
+  return ricActive.load(std::memory_order_relaxed) == &ricTables[0] ? ricTables[1] : ricTables[0];
+}
 
-  // Adjust date (very simple month logic, no leap years)
-  if (dayOffset != 0) {
-    pagerTime.day += dayOffset;
+// Display name of a table entry ("" for RIC_INDEX_NONE)
+const char* ricNameAt(uint8_t ricIndex) {
+  const RicTable& t = ricTable();
+  return ricIndex < t.count ? t.entries[ricIndex].name : "";
+}
 
-    while (true) {
-      int daysInMonth = 31;
-      switch (pagerTime.month) {
-        case 4:
-        case 6:
-        case 9:
-        case 11:
-          daysInMonth = 30;
-          break;
-        case 2:
-          daysInMonth = 28;  // we ignore leap years here
-          break;
-        default:
-          daysInMonth = 31;
-          break;
-      }
+// Find the table entry of a restored page: by address first, then by name
+// (the name is what older inbox files identify the sender by)
+uint8_t ricIndexFor(uint32_t addr, const char* name, size_t nameLen) {
+  const RicTable& t   = ricTable();
+  uint8_t         idx = ricTableMatch(t, addr, RIC_FUNCTION_UNKNOWN);
+  return idx != RIC_NOT_FOUND ? idx : ricTableFindName(t, name, nameLen);
+}
 
-      if (pagerTime.day > daysInMonth) {
-        pagerTime.day -= daysInMonth;
-        pagerTime.month++;
-        if (pagerTime.month > 12) {
-          pagerTime.month = 1;
-          pagerTime.year++;
-        }
-      } else if (pagerTime.day <= 0) {
-        pagerTime.month--;
-        if (pagerTime.month < 1) {
-          pagerTime.month = 12;
-          pagerTime.year--;
-        }
-
-        switch (pagerTime.month) {
-          case 4:
-          case 6:
-          case 9:
-          case 11:
-            daysInMonth = 30;
-            break;
-          case 2:
-            daysInMonth = 28;
-            break;
-          default:
-            daysInMonth = 31;
-            break;
-        }
-        pagerTime.day += daysInMonth;
-      } else {
-        break;
-      }
+// Fallback table: the ric[] entries of config.h, all function codes
+void ricTableFromConfig(RicTable& t) {
+  ricTableReset(t);
+  for (int i = 0; i < RICNUMBER; ++i) {
+    if (ric[i].name == nullptr) {
+      continue;
     }
+    RicEntry e = {};
+    e.addr     = (uint32_t)ric[i].ricvalue;
+    e.function = RIC_FUNCTION_ANY;
+    e.ringtone = (ric[i].ringtype >= 0 && ric[i].ringtype < RINGTONE) ? (uint8_t)ric[i].ringtype : 0;
+    e.priority = RIC_PRIORITY_NORMAL;
+    strncpy(e.name, ric[i].name, RIC_NAME_MAX);
+    ricTableAdd(t, e);
+  }
+}
+
+// Sender label of a stored page: RIC name, or the plain address if the RIC
+// is not subscribed anymore. Returns a pointer into the table or into buf.
+const char* inboxSenderLabel(const PageMessage& msg, char* buf, size_t bufLen) {
+  if (msg.ricIndex != RIC_INDEX_NONE && ricNameAt(msg.ricIndex)[0] != '\0') {
+    return ricNameAt(msg.ricIndex);
   }
+  snprintf(buf, bufLen, "%lu", (unsigned long)msg.addr);
+  return buf;
 }
 
 // -----------------------------------------------------------------------------
@@ -375,138 +1141,573 @@ void addMinutesToPagerTime(int deltaMin) {
 
 // Reset all inbox entries in RAM
 void resetInboxMemory() {
-  inboxCount      = 0;
-  inboxWriteIndex = 0;
-  inboxTotal      = 0;
+  inboxRingReset(inboxRing);
   inboxCurrent    = 0;
+  inboxCurrentPos = 0;
+  inboxInHistory  = false;
+}
 
-  for (int i = 0; i < INBOX_SIZE; ++i) {
-    inbox[i].valid = false;
+// Show history page seq in the inbox view
+void inboxSelectHistory(uint32_t seq) {
+  inboxInHistory  = true;
+  inboxHistorySeq = seq;
+}
+
+// Make the newest message the current one (the newest history page if the
+// RAM inbox is empty)
+void inboxSelectNewest() {
+  inboxCurrent    = (inboxRing.order.tail != INBOX_NIL) ? inboxRing.order.tail : 0;
+  inboxCurrentPos = inboxRing.count;
+  inboxInHistory  = false;
+  if (inboxRing.count == 0 && inboxHistory.count > 0) {
+    inboxSelectHistory(historyEndSeq(inboxHistory) - 1);
+  }
+}
+
+// Word-wrap text into layout (text must be at most INBOX_TEXT_MAX characters)
+void layoutText(const char* text, size_t len, TextLayout& layout) {
+  size_t pos        = 0;
+  layout.lineCount  = 0;
+
+  while (pos < len && layout.lineCount < TEXT_LINES_MAX) {
+    // Spaces at the start of a wrapped line are not shown
+    while (pos < len && text[pos] == ' ') {
+      pos++;
+    }
+    if (pos >= len) {
+      break;
+    }
+
+    size_t start = pos;
+    size_t end   = min(len, start + TEXT_CHARS_PER_LINE);
+    size_t next  = end;
+
+    // Explicit line break
+    for (size_t i = start; i < end; ++i) {
+      if (text[i] == '\n') {
+        end  = i;
+        next = i + 1;
+        break;
+      }
+    }
+
+    // Would split a word: break after the last space of the line instead
+    if (next == end && end < len && text[end] != ' ') {
+      size_t brk = end;
+      while (brk > start && text[brk - 1] != ' ') {
+        brk--;
+      }
+      if (brk > start) {
+        end  = brk;
+        next = brk;
+      }
+    }
+
+    // Trailing spaces are not shown either
+    size_t shown = end;
+    while (shown > start && text[shown - 1] == ' ') {
+      shown--;
+    }
+
+    layout.lineStart[layout.lineCount] = (uint8_t)start;
+    layout.lineLen[layout.lineCount]   = (uint8_t)(shown - start);
+    layout.lineCount++;
+    pos = next;
   }
 }
 
-// Push a message into the ring buffer without modifying the current time
-// Used when restoring messages from LittleFS
-void restorePushMessage(const PageMessage& msg) {
-  PageMessage& dst = inbox[inboxWriteIndex];
-  dst             = msg;
-  dst.valid       = true;
+// Lay out the text of a freshly stored slot for the display
+void inboxLayoutSlot(int slot) {
+  char text[INBOX_TEXT_MAX + 1];
+  textUnpack(text, inboxRing.text[slot], 0, inboxRing.msg[slot].textLen);
+  layoutText(text, inboxRing.msg[slot].textLen, inboxLayout[slot]);
 
-  inboxWriteIndex = (inboxWriteIndex + 1) % INBOX_SIZE;
-  if (inboxCount < INBOX_SIZE) {
-    inboxCount++;
+  if (slot == inboxScrollSlot) {
+    inboxScrollSlot = INBOX_NIL;  // different message now, start at the top
   }
+}
+
+// Replay a journal "add" record: the message lands in the same slot it had at
+// runtime and becomes the newest one (records are in chronological order)
+void restoreSlotMessage(int slot, const PageMessage& msg, const char* text, size_t textLen) {
+  inboxRingRestore(inboxRing, slot, msg, text, textLen);
+  inboxLayoutSlot(slot);
+}
+
+// Push a message as the newest one without modifying the current time
+// Used when restoring messages from old files that carry no slot numbers
+void restorePushMessage(const PageMessage& msg, const char* text, size_t textLen) {
+  inboxLayoutSlot(inboxRingPush(inboxRing, msg, text, textLen));
+}
+
+// Replay a journal "delete" record (tombstone)
+void restoreDeleteSlot(int slot) {
+  inboxRingUnlink(inboxRing, slot);
+}
+
+// -----------------------------------------------------------------------------
+// Inbox file I/O (record layout in inbox_codec.h)
+// -----------------------------------------------------------------------------
+// Build one record into buf (at least INBOX_RECORD_MAX bytes), returns its total length.
+// msg is only used for INBOX_REC_ADD.
+size_t buildInboxRecord(uint8_t* buf, uint8_t type, int slot, const PageMessage* msg) {
+  const char* ricName = (msg != nullptr) ? ricNameAt(msg->ricIndex) : "";
+  return inboxEncodeRecord(buf, type, slot, msg, ricName, inboxRing.text[slot]);
+}
+
+// Largest snapshot: the file header and every slot as an add record
+const size_t INBOX_SNAPSHOT_MAX = INBOX_FILE_HEADER_LEN + INBOX_SIZE * INBOX_ADD_RECORD_MAX;
+
+uint8_t inboxSnapshot[INBOX_SNAPSHOT_MAX];  // persistence task (or boot) only
+
+// Serialise all valid inbox messages in logical chronological order into
+// inboxSnapshot. Caller holds inboxMutex. Returns the length.
+size_t buildInboxSnapshot(int& count) {
+  inboxEncodeFileHeader(inboxSnapshot);
+  size_t len = INBOX_FILE_HEADER_LEN;
+
+  // Messages from oldest to newest
+  count = 0;
+  for (int idx = inboxRing.order.head; idx != INBOX_NIL; idx = inboxRing.next[idx]) {
+    len += buildInboxRecord(inboxSnapshot + len, INBOX_REC_ADD, idx, &inboxRing.msg[idx]);
+    count++;
+  }
+  return len;
+}
+
+// Write inboxSnapshot to INBOX_TMP_PATH first and then swap it in, so a power
+// loss never leaves a half-written inbox behind. File access only: called
+// without inboxMutex.
+bool writeInboxSnapshot(size_t len) {
+  File f = LittleFS.open(INBOX_TMP_PATH, FILE_WRITE);
+  if (!f) {
+    Serial.println(F("[FS] Failed to open inbox file for writing"));
+    return false;
+  }
+  bool ok = f.write(inboxSnapshot, len) == len;
+  f.close();
+  if (!ok) {
+    Serial.println(F("[FS] Failed to write inbox snapshot"));
+    LittleFS.remove(INBOX_TMP_PATH);
+    return false;
+  }
+
+  LittleFS.remove(INBOX_FILE_PATH);
+  if (!LittleFS.rename(INBOX_TMP_PATH, INBOX_FILE_PATH)) {
+    Serial.println(F("[FS] Failed to replace inbox file"));
+    return false;
+  }
+  return true;
+}
 
-  inboxTotal = inboxCount;
+// Snapshot written: records queued meanwhile go behind it
+void inboxSnapshotDone(size_t len, int count) {
+  inboxLock();
+  inboxJournalBytes   = len;
+  inboxCompactPending = false;
+  inboxUnlock();
+
+  Serial.print(F("[FS] Saved inbox messages to LittleFS, count="));
+  Serial.println(count);
 }
 
-// Save all valid inbox messages to LittleFS in logical chronological order
+// Save the inbox as a snapshot. inboxMutex is only held while serialising,
+// the flash I/O runs with it released.
 void saveInboxToFS() {
   if (!storageOk) {
     return;
   }
 
-  File f = LittleFS.open(INBOX_FILE_PATH, FILE_WRITE);
-  if (!f) {
-    Serial.println(F("[FS] Failed to open inbox file for writing"));
+  int count;
+  inboxLock();
+  size_t len = buildInboxSnapshot(count);
+  inboxUnlock();
+
+  if (writeInboxSnapshot(len)) {
+    inboxSnapshotDone(len, count);
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Write-behind persistence
+//
+// storeMessage()/deleteCurrentMessage() only queue a journal operation. A
+// low-priority task collects everything that arrives within
+// PERSIST_WRITE_BEHIND_MS and appends it with a single file write; it also
+// runs the compaction when the receiver is idle. inboxMutex protects the RAM
+// inbox while the task serialises it, persistMutex serialises the file access.
+// Note that flash writes still stall both cores briefly (cache disabled), the
+// task only keeps their number low and their timing away from loop().
+// -----------------------------------------------------------------------------
+struct PersistOp {
+  uint8_t type;  // INBOX_REC_ADD or INBOX_REC_DELETE
+  uint8_t slot;
+};
+
+const int    PERSIST_QUEUE_SIZE = 32;
+const size_t PERSIST_BATCH_MAX  = 2048;  // bytes per file write
+
+PersistOp     persistQueue[PERSIST_QUEUE_SIZE];
+int           persistQueueCount      = 0;
+unsigned long persistFirstDirtyMillis = 0;      // when the oldest queued op was added
+bool          persistSnapshotPending = false;  // queue overflowed → rewrite everything
+bool          persistClearPending    = false;  // "Del All": remove the file
+uint32_t      persistQueueEpoch      = 0;      // bumped whenever the queue is discarded
+
+SemaphoreHandle_t inboxMutex       = nullptr;
+SemaphoreHandle_t persistMutex     = nullptr;
+TaskHandle_t      persistTaskHandle = nullptr;
+
+void inboxLock() {
+  if (inboxMutex) {
+    xSemaphoreTake(inboxMutex, portMAX_DELAY);
+  }
+}
+
+void inboxUnlock() {
+  if (inboxMutex) {
+    xSemaphoreGive(inboxMutex);
+  }
+}
+
+// Wake the persistence task (or do nothing before it is running)
+void persistNotify() {
+  if (persistTaskHandle) {
+    xTaskNotifyGive(persistTaskHandle);
+  }
+}
+
+// Queue a journal operation. Caller holds inboxMutex.
+void persistEnqueue(uint8_t type, int slot) {
+  if (!storageOk) {
     return;
   }
 
-  if (inboxCount == 0) {
-    // Empty inbox → create an empty file
-    f.close();
-    Serial.println(F("[FS] Saved empty inbox"));
+  if (persistQueueCount == 0 && !persistSnapshotPending) {
+    persistFirstDirtyMillis = millis();
+  }
+
+#if INBOX_JOURNAL_MODE
+  if (persistQueueCount < PERSIST_QUEUE_SIZE) {
+    persistQueue[persistQueueCount].type = type;
+    persistQueue[persistQueueCount].slot = (uint8_t)slot;
+    persistQueueCount++;
+  } else {
+    // Too much at once: a snapshot of the RAM inbox covers all of it
+    persistQueueCount      = 0;
+    persistSnapshotPending = true;
+    persistQueueEpoch++;
+  }
+#else
+  (void)type;
+  (void)slot;
+  persistSnapshotPending = true;
+#endif
+
+  persistNotify();
+}
+
+// Persist a newly stored message
+void persistStoredMessage(int slot) {
+  persistEnqueue(INBOX_REC_ADD, slot);
+}
+
+// Persist the deletion of a message
+void persistDeletedMessage(int slot) {
+  persistEnqueue(INBOX_REC_DELETE, slot);
+}
+
+// Drop everything queued and remove the inbox file ("Del All").
+// Caller holds inboxMutex.
+void persistRequestClear() {
+  persistQueueEpoch++;
+  persistQueueCount      = 0;
+  persistSnapshotPending = false;
+  persistClearPending    = true;
+  persistNotify();
+}
+
+// Write everything that is queued. Caller holds persistMutex.
+void persistFlushLocked() {
+  if (!storageOk) {
     return;
   }
 
-  // Find the oldest valid message in the ring buffer
-  int oldestIndex = -1;
+  // Decisions and serialising happen under inboxMutex; files are only
+  // opened, written, renamed and removed with it released
+  inboxLock();
 
-  for (int i = 0; i < INBOX_SIZE; ++i) {
-    int idx = (inboxWriteIndex + i) % INBOX_SIZE;
-    if (inbox[idx].valid) {
-      oldestIndex = idx;
-      break;
+  bool clear = persistClearPending;
+  if (clear) {
+    persistClearPending = false;
+    inboxCompactPending = false;
+    inboxJournalBytes   = 0;
+  }
+
+  bool     snapshot = persistSnapshotPending || inboxCompactPending;
+  bool     append   = persistQueueCount > 0;
+  uint32_t epoch    = persistQueueEpoch;
+  int      count    = 0;
+  size_t   len      = 0;
+  if (snapshot) {
+    // The snapshot reflects the RAM inbox, queued ops are part of it
+    if (inboxCompactPending) {
+      Serial.print(F("[FS] Compacting inbox journal ("));
+      Serial.print((unsigned long)inboxJournalBytes);
+      Serial.println(F(" bytes)"));
+    }
+    persistQueueCount      = 0;
+    persistSnapshotPending = false;
+    len                    = buildInboxSnapshot(count);
+  }
+  inboxUnlock();
+
+  if (clear && !snapshot) {
+    if (LittleFS.exists(INBOX_TMP_PATH)) {
+      LittleFS.remove(INBOX_TMP_PATH);
+    }
+    if (LittleFS.exists(INBOX_FILE_PATH)) {
+      LittleFS.remove(INBOX_FILE_PATH);
+      Serial.println(F("[FS] Inbox file removed"));
+    }
+  }
+
+  if (snapshot) {
+    if (writeInboxSnapshot(len)) {
+      inboxSnapshotDone(len, count);
     }
+    rxStats.n[RX_STAT_FLASH_WRITES]++;
+    return;
+  }
+
+  if (!append) {
+    return;
+  }
+
+  File f = LittleFS.open(INBOX_FILE_PATH, FILE_APPEND);
+  if (!f) {
+    Serial.println(F("[FS] Failed to open inbox journal for appending"));
+    return;
   }
 
-  if (oldestIndex < 0) {
-    // Should not happen, but we handle it gracefully
+  // "Del All" or a queue overflow while the file was opened: the next flush
+  // (already notified) starts over
+  inboxLock();
+  if (persistQueueEpoch != epoch) {
+    inboxUnlock();
     f.close();
-    Serial.println(F("[FS] No valid messages found while saving"));
-    return;
-  }
-
-  // Write messages from oldest to newest
-  int idx   = oldestIndex;
-  int count = 0;
-
-  while (count < inboxCount) {
-    PageMessage& msg = inbox[idx];
-    if (msg.valid) {
-      // Format: addr|ricName|YYYYMMDDHHMMSS|text\n
-      f.print(msg.addr);
-      f.print('|');
-      f.print(msg.ricName);
-      f.print('|');
-
-      if (msg.time.valid) {
-        char timeBuf[16];
-        // YYYYMMDDHHMMSS
-        snprintf(timeBuf, sizeof(timeBuf), "%04d%02d%02d%02d%02d%02d",
-                 msg.time.year,
-                 msg.time.month,
-                 msg.time.day,
-                 msg.time.hour,
-                 msg.time.minute,
-                 msg.time.second);
-        f.print(timeBuf);
-      } else {
-        f.print('-');
-      }
-      f.print('|');
+    return;
+  }
+
+  // Serialise the queued records under inboxMutex, write them with it released
+  static uint8_t batch[PERSIST_BATCH_MAX];
+  int            done    = 0;
+  int            batched = persistQueueCount;
+
+  while (done < batched) {
+    size_t len = 0;
+
+    // Fresh file (first page after boot or after "Del All")
+    if (inboxJournalBytes == 0) {
+      inboxEncodeFileHeader(batch);
+      len = INBOX_FILE_HEADER_LEN;
+    }
+
+    while (done < batched && len + INBOX_RECORD_MAX <= sizeof(batch)) {
+      const PersistOp& op = persistQueue[done];
+      len += buildInboxRecord(batch + len, op.type, op.slot,
+                              op.type == INBOX_REC_ADD ? &inboxRing.msg[op.slot] : nullptr);
+      done++;
+    }
 
-      String flatText = msg.text;
-      flatText.replace('\n', ' ');
-      flatText.replace('\r', ' ');
-      // We could also escape '|' if needed; for now we just avoid newlines.
-      f.print(flatText);
-      f.print('\n');
+    // Ops queued meanwhile move to the front
+    if (done == batched) {
+      int rest = persistQueueCount - batched;
+      memmove(persistQueue, persistQueue + batched, rest * sizeof(PersistOp));
+      persistQueueCount       = rest;
+      persistFirstDirtyMillis = millis();
+    }
+
+    inboxUnlock();
+    inboxJournalBytes += f.write(batch, len);
+    rxStats.n[RX_STAT_FLASH_WRITES]++;
+    inboxLock();
 
-      count++;
+    // "Del All" or a queue overflow while we were writing: the rest is obsolete
+    if (persistQueueEpoch != epoch) {
+      break;
     }
+  }
 
-    idx = (idx + 1) % INBOX_SIZE;
+  if (inboxJournalBytes > INBOX_JOURNAL_COMPACT_BYTES) {
+    inboxCompactPending = true;
   }
 
+  inboxUnlock();
   f.close();
-  Serial.print(F("[FS] Saved inbox messages to LittleFS, count="));
-  Serial.println(inboxCount);
+
+  Serial.print(F("[FS] Journal flush, records="));
+  Serial.println(batched);
 }
 
-// Load inbox messages from LittleFS into RAM
-void loadInboxFromFS() {
-  if (!storageOk) {
-    return;
+// Explicit flush hook (low battery, before restart): writes all queued
+// records synchronously from the calling task
+void inboxFlushNow() {
+  if (!inboxReady) {
+    return;  // still restoring (fast boot), nothing queued yet
+  }
+  PROFILE_SCOPE(PROF_FLUSH_NOW);
+  if (persistMutex) {
+    xSemaphoreTake(persistMutex, portMAX_DELAY);
   }
+  persistFlushLocked();
+  historyFlushLocked();
+  rxStatsSave();
+  if (persistMutex) {
+    xSemaphoreGive(persistMutex);
+  }
+}
 
-  if (!LittleFS.exists(INBOX_FILE_PATH)) {
-    Serial.println(F("[FS] No inbox file found, starting with empty inbox"));
-    resetInboxMemory();
-    return;
+// Persistence task: waits for queued ops, lets them collect for up to
+// PERSIST_WRITE_BEHIND_MS and writes them; compacts while the receiver is idle
+void persistTask(void* arg) {
+  (void)arg;
+
+#if FAST_BOOT
+  // Boot: the receiver is already listening, restore the inbox meanwhile
+  storageMount();
+  Serial.print(F("[Boot] Inbox ready after "));
+  Serial.print((uint32_t)(esp_timer_get_time() / 1000));
+  Serial.println(F(" ms"));
+  schedWakeLoop();
+#endif
+
+  while (true) {
+    TickType_t wait = pdMS_TO_TICKS(1000);
+
+    inboxLock();
+    bool dirty = persistQueueCount > 0 || persistSnapshotPending || persistClearPending ||
+                 historyQueueCount > 0 || historyClearPending;
+    unsigned long age = millis() - persistFirstDirtyMillis;
+    inboxUnlock();
+
+    if (rxStatsSavePending) {
+      xSemaphoreTake(persistMutex, portMAX_DELAY);
+      rxStatsSave();
+      xSemaphoreGive(persistMutex);
+    }
+
+    if (offsetSavePending) {
+      xSemaphoreTake(persistMutex, portMAX_DELAY);
+      offsetCalSave();
+      xSemaphoreGive(persistMutex);
+    }
+
+    if (dirty && age < PERSIST_WRITE_BEHIND_MS && !persistClearPending) {
+      wait = pdMS_TO_TICKS(PERSIST_WRITE_BEHIND_MS - age);
+    } else if (dirty || (inboxCompactPending && pager.available() == 0)) {
+      xSemaphoreTake(persistMutex, portMAX_DELAY);
+      PROFILE_CALL(PROF_PERSIST, persistFlushLocked());
+      historyFlushLocked();
+      xSemaphoreGive(persistMutex);
+      continue;
+    }
+
+    ulTaskNotifyTake(pdTRUE, wait);
   }
+}
 
-  File f = LittleFS.open(INBOX_FILE_PATH, FILE_READ);
-  if (!f) {
-    Serial.println(F("[FS] Failed to open inbox file for reading"));
-    resetInboxMemory();
-    return;
+void persistTaskStart() {
+  // Extra stack for mounting LittleFS and the inbox restore (fast boot)
+  xTaskCreatePinnedToCore(persistTask, "persist", 6144, nullptr,
+                          PERSIST_TASK_PRIORITY, &persistTaskHandle, PERSIST_TASK_CORE);
+}
+
+// Replay binary records from f (positioned after the file header) of the
+// given format version. Returns false if a truncated or corrupt record was
+// found; everything before it has been restored.
+bool loadInboxBinary(File& f, uint8_t version) {
+  uint8_t rec[INBOX_RECORD_MAX];
+
+  while (true) {
+    size_t got = f.read(rec, INBOX_RECORD_HDR_LEN);
+    if (got == 0) {
+      return true;  // clean end of file
+    }
+
+    size_t recLen = (got == INBOX_RECORD_HDR_LEN) ? inboxRecordLength(rec) : 0;
+    if (recLen == 0) {
+      return false;
+    }
+    size_t restLen = recLen - INBOX_RECORD_HDR_LEN;
+    if (f.read(rec + INBOX_RECORD_HDR_LEN, restLen) != restLen) {
+      return false;
+    }
+
+    InboxRecord r;
+    if (!inboxDecodeRecord(rec, recLen, r, version)) {
+      return false;
+    }
+
+    if (r.type == INBOX_REC_WRITE) {
+      // Obsolete ring position header, nothing to restore
+    } else if (r.type == INBOX_REC_DELETE) {
+      restoreDeleteSlot(r.slot);
+    } else {
+      PageMessage msg;
+      msg.addr     = r.addr;
+      msg.ricIndex = ricIndexFor(r.addr, r.ricName, r.ricLen);
+      msg.valid    = true;
+      msg.time     = r.packedTime;
+
+      if (r.packedText != nullptr) {
+        inboxRingRestorePacked(inboxRing, r.slot, msg, r.packedText, r.textLen);
+        inboxLayoutSlot(r.slot);
+      } else {
+        restoreSlotMessage(r.slot, msg, r.text, r.textLen);
+      }
+    }
+  }
+}
+
+// Parse a text line "addr|ricName|YYYYMMDDHHMMSS|text" (format version 1) into msg/text
+bool parseInboxTextRecord(const String& line, PageMessage& msg, String& text) {
+  int p1 = line.indexOf('|');
+  int p2 = (p1 >= 0) ? line.indexOf('|', p1 + 1) : -1;
+  int p3 = (p2 >= 0) ? line.indexOf('|', p2 + 1) : -1;
+
+  if (p1 < 0 || p2 < 0 || p3 < 0) {
+    return false;
   }
 
-  Serial.println(F("[FS] Loading inbox from LittleFS"));
+  String sAddr = line.substring(0, p1);
+  String sRic  = line.substring(p1 + 1, p2);
+  String sTime = line.substring(p2 + 1, p3);
+  String sText = line.substring(p3 + 1);
+
+  msg.addr     = (uint32_t)sAddr.toInt();
+  msg.ricIndex = ricIndexFor(msg.addr, sRic.c_str(), sRic.length());
+  msg.valid    = true;
+  text         = sText;
+
+  PagerTime t = {};
+  if (sTime != "-" && sTime.length() >= 14) {
+    t.year   = sTime.substring(0, 4).toInt();
+    t.month  = sTime.substring(4, 6).toInt();
+    t.day    = sTime.substring(6, 8).toInt();
+    t.hour   = sTime.substring(8, 10).toInt();
+    t.minute = sTime.substring(10, 12).toInt();
+    t.second = sTime.substring(12, 14).toInt();
+    t.valid  = true;
+  }
+  msg.time = packPagerTime(t);
 
-  resetInboxMemory();
+  return true;
+}
 
+// Read an old text inbox file (plain lines or text journal records).
+// Only used once for migration, the file is rewritten in binary afterwards.
+void loadInboxText(File& f) {
   while (f.available()) {
     String line = f.readStringUntil('\n');
     line.trim();
@@ -514,62 +1715,133 @@ void loadInboxFromFS() {
       continue;
     }
 
-    int p1 = line.indexOf('|');
-    int p2 = (p1 >= 0) ? line.indexOf('|', p1 + 1) : -1;
-    int p3 = (p2 >= 0) ? line.indexOf('|', p2 + 1) : -1;
+    char kind = line[0];
 
-    if (p1 < 0 || p2 < 0 || p3 < 0) {
-      Serial.println(F("[FS] Malformed line in inbox file, skipping"));
+    if (kind == '@') {
+      // Ring position header, not needed with slot-tagged records
       continue;
     }
 
-    String sAddr = line.substring(0, p1);
-    String sRic  = line.substring(p1 + 1, p2);
-    String sTime = line.substring(p2 + 1, p3);
-    String sText = line.substring(p3 + 1);
+    if (kind == '-') {
+      int slot = line.substring(1).toInt();
+      if (slot >= 0 && slot < INBOX_SIZE) {
+        restoreDeleteSlot(slot);
+      }
+      continue;
+    }
 
     PageMessage msg;
-    msg.addr    = (uint32_t)sAddr.toInt();
-    msg.ricName = sRic;
-    msg.text    = sText;
-    msg.valid   = true;
-
-    if (sTime != "-" && sTime.length() >= 14) {
-      msg.time.year   = sTime.substring(0, 4).toInt();
-      msg.time.month  = sTime.substring(4, 6).toInt();
-      msg.time.day    = sTime.substring(6, 8).toInt();
-      msg.time.hour   = sTime.substring(8, 10).toInt();
-      msg.time.minute = sTime.substring(10, 12).toInt();
-      msg.time.second = sTime.substring(12, 14).toInt();
-      msg.time.valid  = true;
-    } else {
-      msg.time.valid = false;
+    String      text;
+
+    if (kind == '+') {
+      int p0   = line.indexOf('|');
+      int slot = (p0 > 1) ? line.substring(1, p0).toInt() : -1;
+
+      if (slot < 0 || slot >= INBOX_SIZE || !parseInboxTextRecord(line.substring(p0 + 1), msg, text)) {
+        Serial.println(F("[FS] Malformed record in inbox file, skipping"));
+        continue;
+      }
+
+      restoreSlotMessage(slot, msg, text.c_str(), text.length());
+      continue;
     }
 
-    restorePushMessage(msg);
+    if (!parseInboxTextRecord(line, msg, text)) {
+      Serial.println(F("[FS] Malformed line in inbox file, skipping"));
+      continue;
+    }
 
-    // We stop if we reach the maximum inbox size
-    if (inboxCount >= INBOX_SIZE) {
-      break;
+    restorePushMessage(msg, text.c_str(), text.length());
+  }
+}
+
+// Load inbox messages from LittleFS into RAM (replays the journal)
+void loadInboxFromFS() {
+  if (!storageOk) {
+    return;
+  }
+
+  if (!LittleFS.exists(INBOX_FILE_PATH)) {
+    Serial.println(F("[FS] No inbox file found, starting with empty inbox"));
+    resetInboxMemory();
+    return;
+  }
+
+  File f = LittleFS.open(INBOX_FILE_PATH, FILE_READ);
+  if (!f) {
+    Serial.println(F("[FS] Failed to open inbox file for reading"));
+    resetInboxMemory();
+    return;
+  }
+
+  Serial.println(F("[FS] Loading inbox from LittleFS"));
+
+  unsigned long startMillis = millis();
+
+  resetInboxMemory();
+  inboxJournalBytes = f.size();
+
+  bool    rewrite = false;
+  uint8_t hdr[INBOX_FILE_HEADER_LEN];
+  bool    binary  = f.read(hdr, sizeof(hdr)) == sizeof(hdr) && inboxIsFileHeader(hdr);
+
+  if (binary && (hdr[3] == INBOX_FORMAT_VERSION || hdr[3] == INBOX_FORMAT_PLAIN)) {
+    if (!loadInboxBinary(f, hdr[3])) {
+      Serial.print(F("[FS] Corrupt or torn record at offset "));
+      Serial.print((unsigned long)f.position());
+      Serial.println(F(", dropping the rest of the journal"));
+      rewrite = true;
+    }
+    if (hdr[3] == INBOX_FORMAT_PLAIN) {
+      Serial.println(F("[FS] Converting inbox file to packed text"));
+      rewrite = true;
     }
+  } else if (binary) {
+    Serial.print(F("[FS] Unsupported inbox format version "));
+    Serial.println(hdr[3]);
+    rewrite = true;
+  } else {
+    Serial.println(F("[FS] Migrating text inbox file to binary format"));
+    f.seek(0);
+    loadInboxText(f);
+    rewrite = true;
   }
 
   f.close();
 
-  // Set inboxCurrent to the newest message (last one we pushed)
-  inboxTotal = inboxCount;
-  if (inboxCount > 0) {
-    int newest = (inboxWriteIndex - 1 + INBOX_SIZE) % INBOX_SIZE;
-    inboxCurrent = newest;
-  }
+  // Set inboxCurrent to the newest message
+  inboxSelectNewest();
 
   Serial.print(F("[FS] Restored "));
-  Serial.print(inboxCount);
-  Serial.println(F(" messages from LittleFS"));
+  Serial.print(inboxRing.count);
+  Serial.print(F(" messages from LittleFS in "));
+  Serial.print(millis() - startMillis);
+  Serial.println(F(" ms"));
+
+  // Converted or damaged files are rewritten right away so that new
+  // journal records are never appended behind unreadable data.
+  if (rewrite) {
+    saveInboxToFS();
+  } else if (inboxJournalBytes > INBOX_JOURNAL_COMPACT_BYTES) {
+    inboxCompactPending = true;
+  }
 }
-
 // Initialize LittleFS storage and load inbox
-void storageInit() {
+// Locks and an empty inbox; enough for the receiver to run before the
+// file system is mounted
+void storageInitMemory() {
+  inboxMutex   = xSemaphoreCreateMutex();
+  persistMutex = xSemaphoreCreateMutex();
+
+  // Empty inbox with all slots on the free list, also used if storage fails
+  resetInboxMemory();
+
+  // RICs of config.h until the subscription file is read
+  ricTableFromConfig(ricTables[0]);
+}
+
+// Mount LittleFS and restore the inbox from it
+void storageMount() {
   Serial.print(F("[FS] Initializing LittleFS... "));
   if (!LittleFS.begin()) {
     Serial.println(F("failed, trying to format..."));
@@ -578,6 +1850,7 @@ void storageInit() {
     if (!LittleFS.begin(true)) {
       Serial.println(F("[FS] Formatting LittleFS failed, disabling storage"));
       storageOk = false;
+      inboxReady = true;
       return;
     } else {
       Serial.println(F("[FS] LittleFS formatted successfully"));
@@ -588,323 +1861,796 @@ void storageInit() {
 
   storageOk = true;
 
-  // Optional: if we want to start with a clean inbox after formatting,
-  // we can check if the file exists and, if not, create an empty one.
+  // Recover from a compaction that was interrupted by a reset:
+  // if the old file is still there, the snapshot may be incomplete and is dropped,
+  // otherwise the snapshot was complete and only the rename is missing.
+  if (LittleFS.exists(INBOX_TMP_PATH)) {
+    if (LittleFS.exists(INBOX_FILE_PATH)) {
+      LittleFS.remove(INBOX_TMP_PATH);
+    } else {
+      LittleFS.rename(INBOX_TMP_PATH, INBOX_FILE_PATH);
+    }
+  }
+
+  ricTableLoad();  // before the inbox, restored pages look up their RIC
   loadInboxFromFS();
+  historyLoad();
+  rxStatsLoad();
+  offsetCalLoad();
+  inboxReady = true;
 }
 
+void storageInit() {
+  storageInitMemory();
+  storageMount();
+}
 
-// Store a message in the ring buffer inbox[] and persist it
-void storeMessage(uint32_t addr, const String &ricName, const String &text) {
-  PageMessage &msg = inbox[inboxWriteIndex];
-  msg.addr         = addr;
-  msg.ricName      = ricName;
-  msg.text         = text;
-  msg.valid        = true;
-
-  if (pagerTime.valid) {
-    msg.time = pagerTime;
-  } else {
-    msg.time.year   = 0;
-    msg.time.month  = 0;
-    msg.time.day    = 0;
-    msg.time.hour   = 0;
-    msg.time.minute = 0;
-    msg.time.second = 0;
-    msg.time.valid  = false;
-  }
+// Store a message in the inbox ring and persist it.
+// Returns the slot the message was stored in.
+int storeMessage(uint32_t addr, uint8_t ricIndex, const char* text, size_t textLen) {
+  PROFILE_SCOPE(PROF_STORE);
+  inboxLock();
 
-  int storedIndex = inboxWriteIndex;
+  PageMessage msg;
+  msg.addr     = addr;
+  msg.ricIndex = ricIndex;
 
-  // Advance write index (ring buffer)
-  inboxWriteIndex = (inboxWriteIndex + 1) % INBOX_SIZE;
+  msg.time     = pagerClock.valid ? packPagerTime(pagerLocalTime()) : 0;
 
-  if (inboxCount < INBOX_SIZE) {
-    inboxCount++;
+  // Free slot, or the oldest message's slot when the inbox is full;
+  // the oldest message then moves on to the history
+  if (inboxRing.count == INBOX_SIZE) {
+    historyQueueEvicted(inboxRing.order.head);
   }
+  int storedIndex = inboxRingPush(inboxRing, msg, text, textLen);
+  inboxLayoutSlot(storedIndex);
+  rxStats.n[RX_STAT_BYTES_STORED] += inboxRing.msg[storedIndex].textLen;
+
+  // Newest message becomes the current one
+  inboxSelectNewest();
 
-  // Update inbox status
-  inboxTotal   = inboxCount;
-  inboxCurrent = storedIndex;  // newest message becomes the current one
+  // Queue for LittleFS (written behind by the persistence task)
+  persistStoredMessage(storedIndex);
+
+  inboxUnlock();
 
   Serial.print(F("[Inbox] Stored message #"));
   Serial.print(storedIndex);
   Serial.print(F(" (total="));
-  Serial.print(inboxCount);
+  Serial.print(inboxRing.count);
   Serial.println(F(")"));
 
-  // Persist the entire inbox to LittleFS
-  saveInboxToFS();
-
   // Set reminder flag: we have at least one new/unacknowledged message
-  newMessagePending        = true;
-  lastReminderBlinkMillis  = millis();
+  newMessagePending = true;
+
+  return storedIndex;
 }
 
 // Debug helper: dump complete inbox to serial
 void dumpInboxToSerial() {
   Serial.println(F("====== INBOX DUMP ======"));
-  for (int i = 0; i < INBOX_SIZE; i++) {
-    if (!inbox[i].valid) {
-      continue;
-    }
+  for (int i = inboxRing.order.head; i != INBOX_NIL; i = inboxRing.next[i]) {
     Serial.print('#');
     Serial.print(i);
     Serial.print(F(" RIC="));
-    Serial.print(inbox[i].addr);
+    Serial.print(inboxRing.msg[i].addr);
     Serial.print(F(" ("));
-    Serial.print(inbox[i].ricName);
+    Serial.print(ricNameAt(inboxRing.msg[i].ricIndex));
     Serial.print(F(") "));
-    if (inbox[i].time.valid) {
+    PagerTime t;
+    unpackPagerTime(inboxRing.msg[i].time, t);
+    if (t.valid) {
       Serial.print('[');
-      Serial.print(inbox[i].time.day);
+      Serial.print(t.day);
       Serial.print('.');
-      Serial.print(inbox[i].time.month);
+      Serial.print(t.month);
       Serial.print('.');
-      Serial.print(inbox[i].time.year % 100);
+      Serial.print(t.year % 100);
       Serial.print(' ');
-      Serial.print(inbox[i].time.hour);
+      Serial.print(t.hour);
       Serial.print(':');
-      Serial.print(inbox[i].time.minute);
+      Serial.print(t.minute);
       Serial.print(']');
     } else {
       Serial.print("[no time]");
     }
+    char text[INBOX_TEXT_MAX + 1];
+    textUnpack(text, inboxRing.text[i], 0, inboxRing.msg[i].textLen);
     Serial.print(F(" -> "));
-    Serial.println(inbox[i].text);
+    Serial.println(text);
   }
   Serial.println(F("========================"));
 }
 
 void deleteCurrentMessage() {
-  if (inboxCount == 0) {
+  if (inboxInHistory) {
+    Serial.println(F("[History] History pages are read-only"));
+    return;
+  }
+  if (inboxRing.count == 0) {
     return;
   }
 
-  if (inboxCurrent < 0 || inboxCurrent >= INBOX_SIZE || !inbox[inboxCurrent].valid) {
+  if (inboxCurrent < 0 || inboxCurrent >= INBOX_SIZE || !inboxRing.msg[inboxCurrent].valid) {
     return;
   }
 
+  inboxLock();
+
   int oldIdx = inboxCurrent;
+  int newer  = inboxRing.next[oldIdx];
+  int older  = inboxRing.prev[oldIdx];
+
+  // Aktuelle Nachricht aus der Reihenfolge entfernen
+  inboxRingUnlink(inboxRing, oldIdx);
+
+  // Neue aktuelle Position: die nächst jüngere Nachricht, sonst die ältere
+  if (newer != INBOX_NIL) {
+    inboxCurrent = newer;             // Position bleibt gleich
+  } else if (older != INBOX_NIL) {
+    inboxCurrent = older;
+    inboxCurrentPos--;
+  } else {
+    inboxCurrent    = 0;
+    inboxCurrentPos = 0;
+  }
 
-  // Aktuelle Nachricht ungültig machen
-  inbox[oldIdx].valid = false;
+  // Änderungen in LittleFS speichern (Tombstone, asynchron)
+  persistDeletedMessage(oldIdx);
 
-  // Inbox neu zählen und neue aktuelle Position wählen
-  int newCount = 0;
-  int newCurrent = -1;
-  int bestDist = INBOX_SIZE + 1;
-
-  for (int i = 0; i < INBOX_SIZE; ++i) {
-    if (!inbox[i].valid) {
-      continue;
-    }
-    newCount++;
-
-    // möglichst nahe an der alten Position bleiben
-    int dist = abs(i - oldIdx);
-    if (dist < bestDist) {
-      bestDist = dist;
-      newCurrent = i;
-    }
-  }
-
-  inboxCount = newCount;
-  inboxTotal = inboxCount;
-
-  if (inboxCount == 0) {
-    inboxCurrent = 0;
-  } else if (newCurrent >= 0) {
-    inboxCurrent = newCurrent;
-  }
-
-  // Änderungen in LittleFS speichern
-  saveInboxToFS();
+  inboxUnlock();
 
   Serial.print(F("[Inbox] Deleted message at index "));
   Serial.print(oldIdx);
   Serial.print(F(", remaining="));
-  Serial.println(inboxCount);
+  Serial.println(inboxRing.count);
 }
 void deleteAllMessages() {
   Serial.println(F("[Inbox] Deleting all messages"));
 
   // RAM-Inbox zurücksetzen
+  inboxLock();
   resetInboxMemory();
 
-  // Reminder zurücksetzen
-  newMessagePending    = false;
-  reminderPulseActive  = false;
-  digitalWrite(LED, LOW);
+  // Datei im Flash löschen (übernimmt der Persistenz-Task)
+  persistRequestClear();
+  historyRequestClear();
+  inboxUnlock();
 
-  // Datei im Flash löschen
-  if (storageOk && LittleFS.exists(INBOX_FILE_PATH)) {
-    LittleFS.remove(INBOX_FILE_PATH);
-    Serial.println(F("[FS] Inbox file removed"));
-  } else {
-    // alternativ könnten wir eine leere Inbox speichern:
-    // saveInboxToFS();
-    Serial.println(F("[FS] No inbox file to remove"));
-  }
+  // Reminder zurücksetzen
+  newMessagePending = false;
+  notifyReminderSync();
 }
 
 // -----------------------------------------------------------------------------
-// Time message parsing (DAPNET time RICs)
+// RIC subscription file (LittleFS)
+//
+// RIC_TABLE_PATH holds one entry per line in the text form of ric_table.h:
+//   # RIC,function,name,ringtone,priority
+//   1040,*,EMERGENCY,0,3
+//   65009,A,IND,2,1
+// Without the file the ric[] entries of config.h are used. "rics add" and
+// "rics del" on the console change the table and rewrite the file.
 // -----------------------------------------------------------------------------
+const char*  RIC_TABLE_TMP_PATH = "/rics.tmp";
+const size_t RIC_LINE_MAX       = 48;
 
-// Parse time from DAPNET string (RIC 216/224, format "YYYYMMDDHHMMSS251203200600")
-void handleTimeMessage(uint32_t addr, const String &str) {
-  // We currently evaluate only RIC 216 and 224 with the pattern "YYYYMMDDHHMMSS"
-  if (addr == 216 || addr == 224) {
-    int idx = str.indexOf("YYYYMMDDHHMMSS");
-    if (idx >= 0 && str.length() >= idx + 14 + 12) {
-      String d = str.substring(idx + 14, idx + 14 + 12);
-      int yy   = d.substring(0, 2).toInt();
-      int mm   = d.substring(2, 4).toInt();
-      int dd   = d.substring(4, 6).toInt();
-      int hh   = d.substring(6, 8).toInt();
-      int mi   = d.substring(8, 10).toInt();
-      int ss   = d.substring(10, 12).toInt();
-
-      pagerTime.year   = 2000 + yy;
-      pagerTime.month  = mm;
-      pagerTime.day    = dd;
-      pagerTime.hour   = hh;
-      pagerTime.minute = mi;
-      pagerTime.second = ss;
-      pagerTime.valid  = true;
-
-      // Convert from UTC to local time
-      addMinutesToPagerTime(timeOffsetMinutes);
-
-      lastTimeUpdateMillis = millis();
-
-      Serial.print(F("[Time] Set (local) from addr "));
-      Serial.print(addr);
-      Serial.print(F(": "));
-      Serial.print(pagerTime.day);
-      Serial.print('.');
-      Serial.print(pagerTime.month);
-      Serial.print('.');
-      Serial.print(pagerTime.year);
-      Serial.print(' ');
-      Serial.print(pagerTime.hour);
-      Serial.print(':');
-      Serial.println(pagerTime.minute);
-    } else {
-      Serial.println(F("[Time] Time pattern found but string too short"));
+// Make next the table in use. Stored pages keep their subscription: the
+// entry index of each one is looked up again in the new table.
+void ricTablePublish(RicTable& next) {
+  const RicTable& prev = ricTable();
+
+  inboxLock();
+  for (int i = 0; i < INBOX_SIZE; ++i) {
+    PageMessage& msg = inboxRing.msg[i];
+    if (!msg.valid || msg.ricIndex >= prev.count) {
+      continue;
     }
+    const RicEntry& old = prev.entries[msg.ricIndex];
+    uint8_t         idx = ricTableFindExact(next, old.addr, old.function);
+    if (idx == RIC_NOT_FOUND) {
+      idx = ricTableMatch(next, msg.addr, RIC_FUNCTION_UNKNOWN);
+    }
+    msg.ricIndex = idx;
   }
+  ricActive.store(&next, std::memory_order_release);
+  historyCacheReset(historyCache);  // cached bodies refer to the old indices
+  inboxUnlock();
+}
 
-  // Optional later:
-  // - addr == 208 / 2000 (XTIME / #ZEIT)
-  // - addr == 2504 (HHMMSS   DDMMYY)
+void printRicTable() {
+  const RicTable& t = ricTable();
+  Serial.print(F("[RIC] "));
+  Serial.print(t.count);
+  Serial.print(F(" entries, last frame "));
+  Serial.print(t.lastFrame);
+  Serial.println(RIC_DROP_UNSUBSCRIBED ? F(", other pages dropped") : F(", other pages logged"));
+
+  char line[RIC_LINE_MAX];
+  for (int i = 0; i < t.count; ++i) {
+    ricTableFormatLine(t.entries[i], line, sizeof(line));
+    Serial.print(F("[RIC] "));
+    Serial.println(line);
+  }
 }
 
-// Simple software clock based on millis()
-void tickPagerClock() {
-  if (!pagerTime.valid) {
+// Load RIC_TABLE_PATH (after LittleFS is mounted). Malformed lines are
+// reported and skipped; without the file the current table stays.
+void ricTableLoad() {
+  // A rewrite interrupted after the old file was removed
+  if (!LittleFS.exists(RIC_TABLE_PATH) && LittleFS.exists(RIC_TABLE_TMP_PATH)) {
+    LittleFS.rename(RIC_TABLE_TMP_PATH, RIC_TABLE_PATH);
+  }
+
+  File f = LittleFS.open(RIC_TABLE_PATH, FILE_READ);
+  if (!f) {
+    Serial.print(F("[RIC] No "));
+    Serial.print(RIC_TABLE_PATH);
+    Serial.print(F(", "));
+    Serial.print(ricTable().count);
+    Serial.println(F(" RICs from config.h"));
     return;
   }
 
-  unsigned long now = millis();
+  RicTable& next = ricSpare();
+  ricTableReset(next);
 
-  // Catch up missing second ticks
-  while (now - lastTimeUpdateMillis >= 1000) {
-    lastTimeUpdateMillis += 1000;
-    pagerTime.second++;
-
-    if (pagerTime.second >= 60) {
-      pagerTime.second = 0;
-      pagerTime.minute++;
-    }
-    if (pagerTime.minute >= 60) {
-      pagerTime.minute = 0;
-      pagerTime.hour++;
-    }
-    if (pagerTime.hour >= 24) {
-      pagerTime.hour = 0;
-      // Advance date (simple month logic, no leap years)
-      pagerTime.day++;
-      int daysInMonth = 31;
-      switch (pagerTime.month) {
-        case 4:
-        case 6:
-        case 9:
-        case 11:
-          daysInMonth = 30;
-          break;
-        case 2:
-          daysInMonth = 28;  // no leap year handling here
-          break;
-        default:
-          daysInMonth = 31;
-          break;
+  char line[RIC_LINE_MAX];
+  int  lineNo  = 0;
+  int  skipped = 0;
+  while (f.available()) {
+    size_t n = f.readBytesUntil('\n', line, sizeof(line) - 1);
+    line[n]  = '\0';
+    lineNo++;
+
+    RicEntry e;
+    int      r = ricTableParseLine(line, e);
+    if (r == 0) {
+      continue;
+    }
+    if (r < 0 || e.ringtone >= RINGTONE || ricTableAdd(next, e) == RIC_NOT_FOUND) {
+      skipped++;
+      Serial.print(F("[RIC] Skipped line "));
+      Serial.println(lineNo);
+    }
+  }
+  f.close();
+
+  ricTablePublish(next);
+  Serial.print(F("[RIC] Loaded "));
+  Serial.print(next.count);
+  Serial.print(F(" entries from "));
+  Serial.print(RIC_TABLE_PATH);
+  if (skipped > 0) {
+    Serial.print(F(", skipped "));
+    Serial.print(skipped);
+  }
+  Serial.println();
+}
+
+// Rewrite RIC_TABLE_PATH from the table in use (loop(), console changes)
+void ricTableSave() {
+  if (!storageOk) {
+    return;
+  }
+  xSemaphoreTake(persistMutex, portMAX_DELAY);
+
+  File f = LittleFS.open(RIC_TABLE_TMP_PATH, FILE_WRITE);
+  if (!f) {
+    xSemaphoreGive(persistMutex);
+    Serial.println(F("[RIC] Failed to open RIC file for writing"));
+    return;
+  }
+  f.println(F("# RIC,function,name,ringtone,priority"));
+  const RicTable& t = ricTable();
+  char            line[RIC_LINE_MAX];
+  for (int i = 0; i < t.count; ++i) {
+    ricTableFormatLine(t.entries[i], line, sizeof(line));
+    f.println(line);
+  }
+  f.close();
+
+  LittleFS.remove(RIC_TABLE_PATH);
+  bool ok = LittleFS.rename(RIC_TABLE_TMP_PATH, RIC_TABLE_PATH);
+  rxStats.n[RX_STAT_FLASH_WRITES]++;
+  xSemaphoreGive(persistMutex);
+
+  if (!ok) {
+    Serial.println(F("[RIC] Failed to replace RIC file"));
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Inbox history (LittleFS, index in RAM)
+//
+// A page pushed out of the full RAM inbox is queued by storeMessage() and
+// appended to a history segment by the persistence task. Segment files:
+//   'P' 'G' 'H' <version> generation(4)   then inbox 'A' records (slot 0)
+// The inbox view continues below the oldest RAM message into the history;
+// bodies are read when a page is shown and kept in an LRU cache.
+// -----------------------------------------------------------------------------
+const char* const HISTORY_PATHS[INBOX_HISTORY_SEGMENTS] = { "/history0.log", "/history1.log" };
+const char*       HISTORY_TMP_PATH   = "/history.tmp";
+const size_t      HISTORY_HEADER_LEN = 8;
+const size_t      HISTORY_RECORD_MAX = INBOX_ADD_RECORD_MAX;
+const int         HISTORY_QUEUE_SIZE = 8;
+
+// An evicted page, encoded while it is still in the RAM inbox
+struct HistoryPending {
+  uint32_t addr;
+  uint32_t packedTime;
+  uint8_t  textLen;
+  uint16_t recordLen;
+  uint8_t  record[HISTORY_RECORD_MAX];
+};
+
+// A page body read back from flash
+struct HistoryBody {
+  PageMessage msg;
+  uint8_t     text[INBOX_TEXT_PACKED];
+  TextLayout  layout;
+};
+
+HistoryBody    historyBodies[INBOX_HISTORY_CACHE];
+HistoryPending historyQueue[HISTORY_QUEUE_SIZE];
+bool           historyReady = false;  // index restored from LittleFS
+uint32_t       historyLost  = 0;      // evicted while the queue was full
+
+// Queue the oldest RAM message before storeMessage() reuses its slot.
+// Caller holds inboxMutex.
+void historyQueueEvicted(int slot) {
+  if (!storageOk) {
+    return;
+  }
+  if (historyQueueCount >= HISTORY_QUEUE_SIZE) {
+    historyLost++;
+    return;
+  }
+
+  const PageMessage& msg = inboxRing.msg[slot];
+  HistoryPending&    p   = historyQueue[historyQueueCount++];
+  p.addr       = msg.addr;
+  p.packedTime = msg.time;
+  p.textLen    = msg.textLen;
+  p.recordLen  = (uint16_t)inboxEncodeRecord(p.record, INBOX_REC_ADD, 0, &msg, ricNameAt(msg.ricIndex),
+                                             inboxRing.text[slot]);
+  persistNotify();
+}
+
+// Forget the history ("Del All"). Caller holds inboxMutex.
+void historyRequestClear() {
+  historyReset(inboxHistory);
+  historyCacheReset(historyCache);
+  historyQueueCount   = 0;
+  historyClearPending = true;
+}
+
+void historyEncodeHeader(uint8_t* hdr, uint32_t generation) {
+  hdr[0] = 'P';
+  hdr[1] = 'G';
+  hdr[2] = 'H';
+  hdr[3] = INBOX_FORMAT_VERSION;
+  putLe32(hdr + 4, generation);
+}
+
+// Append the queued pages. Caller holds persistMutex.
+void historyFlushLocked() {
+  if (!storageOk || !historyReady) {
+    return;
+  }
+
+  static HistoryPending p;  // too large for the task stack
+
+  // Files are only touched with inboxMutex released
+  inboxLock();
+  bool clear          = historyClearPending;
+  historyClearPending = false;
+  inboxUnlock();
+  if (clear) {
+    for (const char* path : HISTORY_PATHS) {
+      if (LittleFS.exists(path)) {
+        LittleFS.remove(path);
       }
-      if (pagerTime.day > daysInMonth) {
-        pagerTime.day = 1;
-        pagerTime.month++;
-        if (pagerTime.month > 12) {
-          pagerTime.month = 1;
-          pagerTime.year++;
-        }
+    }
+  }
+
+  inboxLock();
+  while (historyQueueCount > 0) {
+    p = historyQueue[0];
+    historyQueueCount--;
+    memmove(historyQueue, historyQueue + 1, historyQueueCount * sizeof(HistoryPending));
+
+    // First page ever, or the segment is full: start the other one over
+    bool     fresh          = inboxHistory.segmentBytes == 0 || historySegmentFull(inboxHistory);
+    uint32_t prevGeneration = inboxHistory.generation;
+    if (fresh) {
+      uint8_t seg = inboxHistory.segmentBytes == 0 ? inboxHistory.segment : inboxHistory.segment ^ 1;
+      historySelectSegment(inboxHistory, seg, inboxHistory.generation + 1, HISTORY_HEADER_LEN);
+    }
+    historyAppend(inboxHistory, p.addr, p.textLen, p.packedTime, p.recordLen);
+    uint8_t  seg        = inboxHistory.segment;
+    uint32_t generation = inboxHistory.generation;
+    inboxUnlock();
+
+    bool ok;
+    File f = LittleFS.open(HISTORY_PATHS[seg], fresh ? FILE_WRITE : FILE_APPEND);
+    ok     = (bool)f;
+    if (fresh && ok) {
+      uint8_t hdr[HISTORY_HEADER_LEN];
+      historyEncodeHeader(hdr, generation);
+      ok = f.write(hdr, sizeof(hdr)) == sizeof(hdr);
+    }
+    ok = ok && f.write(p.record, p.recordLen) == p.recordLen;
+    if (f) {
+      f.close();
+    }
+    rxStats.n[RX_STAT_FLASH_WRITES]++;
+
+    inboxLock();
+    if (!ok) {
+      historyDropNewest(inboxHistory, p.recordLen);
+      if (fresh && inboxHistory.segment == seg && inboxHistory.generation == generation) {
+        // The segment file has no valid header: the next page starts the
+        // same segment again, under the generation it was meant to get
+        // (not if "Del All" reset the index meanwhile)
+        inboxHistory.generation   = prevGeneration;
+        inboxHistory.segmentBytes = 0;
       }
+      Serial.println(F("[History] Failed to append to the history"));
+    }
+  }
+  inboxUnlock();
+}
+
+// Index one segment file; returns the length of its intact part.
+// The scan stops at a torn record or when the segment is full.
+uint32_t historyScanSegment(File& f) {
+  uint8_t  rec[INBOX_RECORD_MAX];
+  uint32_t good = HISTORY_HEADER_LEN;
+
+  while (!historySegmentFull(inboxHistory)) {
+    size_t got    = f.read(rec, INBOX_RECORD_HDR_LEN);
+    size_t recLen = (got == INBOX_RECORD_HDR_LEN) ? inboxRecordLength(rec) : 0;
+    if (recLen == 0) {
+      break;
+    }
+    size_t restLen = recLen - INBOX_RECORD_HDR_LEN;
+    if (f.read(rec + INBOX_RECORD_HDR_LEN, restLen) != restLen) {
+      break;
     }
+    InboxRecord r;
+    if (!inboxDecodeRecord(rec, recLen, r) || r.type != INBOX_REC_ADD) {
+      break;
+    }
+    inboxLock();
+    historyAppend(inboxHistory, r.addr, (uint8_t)r.textLen, r.packedTime, recLen);
+    inboxUnlock();
+    good += recLen;
+  }
+  return good;
+}
+
+// Cut a torn tail off the segment that is appended to (tmp copy + rename),
+// so new records do not end up behind it
+void historyRepairSegment(const char* path, uint32_t good) {
+  File in  = LittleFS.open(path, FILE_READ);
+  File out = LittleFS.open(HISTORY_TMP_PATH, FILE_WRITE);
+  if (!in || !out) {
+    return;
+  }
+  uint8_t  buf[INBOX_RECORD_MAX];
+  uint32_t left = good;
+  while (left > 0) {
+    size_t n = in.read(buf, min<uint32_t>(left, sizeof(buf)));
+    if (n == 0) {
+      break;
+    }
+    out.write(buf, n);
+    left -= n;
+  }
+  in.close();
+  out.close();
+  LittleFS.remove(path);
+  LittleFS.rename(HISTORY_TMP_PATH, path);
+  Serial.println(F("[History] Torn record removed"));
+}
+
+// Rebuild the RAM index from both segments (after LittleFS is mounted).
+// inboxMutex is only held per index update, pages keep being stored meanwhile.
+void historyLoad() {
+  uint32_t generation[INBOX_HISTORY_SEGMENTS] = {};
+  bool     present[INBOX_HISTORY_SEGMENTS]    = {};
+
+  for (int seg = 0; seg < INBOX_HISTORY_SEGMENTS; ++seg) {
+    if (!LittleFS.exists(HISTORY_PATHS[seg])) {
+      continue;
+    }
+    File f = LittleFS.open(HISTORY_PATHS[seg], FILE_READ);
+    if (!f) {
+      continue;
+    }
+    uint8_t hdr[HISTORY_HEADER_LEN];
+    present[seg]    = f.read(hdr, sizeof(hdr)) == sizeof(hdr) && hdr[0] == 'P' && hdr[1] == 'G' &&
+                      hdr[2] == 'H' && hdr[3] == INBOX_FORMAT_VERSION;
+    generation[seg] = getLe32(hdr + 4);
+    f.close();
+  }
+
+  inboxLock();
+  historyReset(inboxHistory);
+  historyCacheReset(historyCache);
+  inboxUnlock();
+
+  // Older generation first, the newer one is appended to
+  int order[INBOX_HISTORY_SEGMENTS] = { 0, 1 };
+  if (present[0] && present[1] && generation[1] < generation[0]) {
+    order[0] = 1;
+    order[1] = 0;
+  }
+  for (int seg : order) {
+    if (!present[seg]) {
+      continue;
+    }
+    File f = LittleFS.open(HISTORY_PATHS[seg], FILE_READ);
+    f.seek(HISTORY_HEADER_LEN);
+    inboxLock();
+    historySelectSegment(inboxHistory, (uint8_t)seg, generation[seg], HISTORY_HEADER_LEN);
+    inboxUnlock();
+    uint32_t good = historyScanSegment(f);
+    uint32_t size = f.size();
+    f.close();
+    if (good < size && seg == order[1]) {
+      historyRepairSegment(HISTORY_PATHS[seg], good);
+    }
+  }
+  historyReady = true;
+
+  Serial.print(F("[History] "));
+  Serial.print(inboxHistory.count);
+  Serial.println(F(" pages in flash"));
+}
+
+// Body of a history page, from the cache or read from flash (loop()).
+// nullptr if the page is gone or cannot be read.
+const HistoryBody* historyBody(uint32_t seq) {
+  int slot = historyCacheLookup(historyCache, seq);
+  if (slot >= 0) {
+    return &historyBodies[slot];
+  }
+
+  inboxLock();
+  const HistoryEntry* e = historyFind(inboxHistory, seq);
+  HistoryEntry        entry;
+  if (e != nullptr) {
+    entry = *e;
   }
+  inboxUnlock();
+  if (e == nullptr) {
+    return nullptr;
+  }
+
+  uint8_t rec[HISTORY_RECORD_MAX];
+  size_t  len = 0;
+  xSemaphoreTake(persistMutex, portMAX_DELAY);
+  File f = LittleFS.open(HISTORY_PATHS[historySegment(entry)], FILE_READ);
+  if (f) {
+    f.seek(entry.offset);
+    len = f.read(rec, sizeof(rec));
+    f.close();
+  }
+  xSemaphoreGive(persistMutex);
+
+  size_t      recLen = (len >= INBOX_RECORD_HDR_LEN) ? inboxRecordLength(rec) : 0;
+  InboxRecord r;
+  if (recLen == 0 || recLen > len || !inboxDecodeRecord(rec, recLen, r) || r.addr != historyAddr(entry)) {
+    Serial.println(F("[History] Failed to read a page"));
+    return nullptr;
+  }
+
+  slot              = historyCacheInsert(historyCache, seq);
+  HistoryBody& body = historyBodies[slot];
+  body.msg.addr     = r.addr;
+  body.msg.ricIndex = ricIndexFor(r.addr, r.ricName, r.ricLen);
+  body.msg.textLen  = (uint8_t)min(r.textLen, (size_t)INBOX_TEXT_MAX);
+  body.msg.valid    = true;
+  body.msg.time     = r.packedTime;
+  memcpy(body.text, r.packedText, TEXT_PACKED_LEN(body.msg.textLen));
+
+  char text[INBOX_TEXT_MAX + 1];
+  textUnpack(text, body.text, 0, body.msg.textLen);
+  layoutText(text, body.msg.textLen, body.layout);
+  return &body;
+}
+
+void printHistoryStats() {
+  Serial.print(F("[History] pages="));
+  Serial.print(inboxHistory.count);
+  Serial.print(F("/"));
+  Serial.print(INBOX_HISTORY_MAX);
+  Serial.print(F(" index="));
+  Serial.print((unsigned long)sizeof(inboxHistory));
+  Serial.print(F("B cacheHits="));
+  Serial.print(historyCache.hits);
+  Serial.print(F(" cacheMisses="));
+  Serial.print(historyCache.misses);
+  Serial.print(F(" lost="));
+  Serial.println(historyLost);
 }
 
 // -----------------------------------------------------------------------------
-// Status bar (clock + inbox info)
+// Time message parsing (DAPNET time RICs)
 // -----------------------------------------------------------------------------
 
-// Draw the top status bar with clock (left) and inbox position (right)
-void drawClockBar() {
-  // Clear status bar area
-  display.fillRect(0, 0, SCREEN_W, STATUS_BAR_HEIGHT, BLACK);
-  display.setTextSize(1);
-  display.setTextColor(WHITE);
+// UTC now (pagerClock.valid must be set)
+PagerEpoch clockUtcNow() {
+  return pagerClockNow(pagerClock, esp_timer_get_time());
+}
+
+// Local time now. The date fields are computed again only when the second
+// has changed, the offset follows TIME_ZONE_DST_RULE.
+const PagerTime& pagerLocalTime() {
+  static PagerTime  local    = {};
+  static PagerEpoch localUtc = 0;
+
+  PagerEpoch utc = clockUtcNow();
+  if (!local.valid || utc != localUtc) {
+    PROFILE_SCOPE(PROF_CLOCK);
+    int64_t t = (int64_t)utc + pagerUtcOffsetMinutes(utc, TIME_ZONE_OFFSET_MINUTES, TIME_ZONE_DST_RULE) * 60;
+    pagerTimeFromEpoch(t > 0 ? (PagerEpoch)t : 0, local);
+    localUtc = utc;
+  }
+  return local;
+}
+
+// Set the clock from a time beacon, see parseTimeMessage() for the RICs and
+// formats. str must be NUL-terminated, len is its length.
+void handleTimeMessage(uint32_t addr, const char* str, size_t len) {
+  if (!isTimeBeaconRic(addr)) {
+    return;
+  }
+
+  TimeBeacon        beacon;
+  TimeMessageResult result = parseTimeMessage(addr, str, len, beacon);
+  if (result == TIME_MSG_NONE) {
+    return;
+  }
+  if (result == TIME_MSG_SHORT) {
+    Serial.println(F("[Time] Time pattern found but string too short"));
+    return;
+  }
+  if (result == TIME_MSG_BAD) {
+    Serial.println(F("[Time] Time pattern malformed, ignored"));
+    return;
+  }
+  if (!pagerTimeInRange(beacon.time)) {
+    Serial.println(F("[Time] Time out of range, ignored"));
+    return;
+  }
 
+  PagerEpoch utc = pagerTimeToEpoch(beacon.time);
+  if (beacon.local) {
+    utc = pagerLocalToUtc(utc, TIME_ZONE_OFFSET_MINUTES, TIME_ZONE_DST_RULE);
+  }
+  PagerClockSync sync = pagerClockSync(pagerClock, esp_timer_get_time(), utc, beacon.resolution, TIME_STEP_LIMIT_S);
+
+  if (sync == PAGER_CLOCK_IN_SYNC) {
+    return;
+  }
+  if (sync == PAGER_CLOCK_SLEWING) {
+    Serial.print(F("[Time] Addr "));
+    Serial.print(addr);
+    Serial.print(F(": slewing by "));
+    Serial.print(pagerClock.lastErrorMs);
+    Serial.println(F(" ms"));
+    return;
+  }
+
+  const PagerTime& local  = pagerLocalTime();
+  int              offset = pagerUtcOffsetMinutes(utc, TIME_ZONE_OFFSET_MINUTES, TIME_ZONE_DST_RULE);
+  Serial.print(F("[Time] Set (local) from addr "));
+  Serial.print(addr);
+  Serial.print(F(": "));
+  Serial.print(local.day);
+  Serial.print('.');
+  Serial.print(local.month);
+  Serial.print('.');
+  Serial.print(local.year);
+  Serial.print(' ');
+  Serial.print(local.hour);
+  Serial.print(':');
+  Serial.print(local.minute);
+  Serial.print(F(" (UTC"));
+  Serial.print(offset >= 0 ? '+' : '-');
+  Serial.print(abs(offset));
+  Serial.println(F(" min)"));
+}
+
+void printClockStats() {
+  Serial.print(F("[Time] valid="));
+  Serial.print(pagerClock.valid ? 1 : 0);
+  Serial.print(F(" beacons="));
+  Serial.print(pagerClock.syncs);
+  Serial.print(F(" steps="));
+  Serial.print(pagerClock.steps);
+  Serial.print(F(" lastError="));
+  Serial.print(pagerClock.lastErrorMs);
+  Serial.println(F("ms"));
+}
+
+// -----------------------------------------------------------------------------
+// Status bar (clock + inbox info)
+// -----------------------------------------------------------------------------
+
+// Format the status bar texts from the current clock and inbox state
+void formatClockBar(StatusBarText& bar) {
   // Left: date + time
-  display.setCursor(0, 0);
-  if (pagerTime.valid) {
-    char timeBuf[20];
-    snprintf(timeBuf, sizeof(timeBuf), "%02d.%02d.%02d %02d:%02d",
-             pagerTime.day,
-             pagerTime.month,
-             pagerTime.year % 100,
-             pagerTime.hour,
-             pagerTime.minute);
-    display.print(timeBuf);
+  if (pagerClock.valid) {
+    const PagerTime& now = pagerLocalTime();
+    snprintf(bar.left, sizeof(bar.left), "%02d.%02d.%02d %02d:%02d",
+             now.day,
+             now.month,
+             now.year % 100,
+             now.hour,
+             now.minute);
+  } else {
+    snprintf(bar.left, sizeof(bar.left), "No Time");
+  }
+
+  // Right: inbox "x/n" (chronological position among all messages,
+  // history pages first)
+  int total = inboxHistory.count + inboxRing.count;
+  if (total > 0) {
+    int pos = inboxInHistory ? (int)(inboxHistorySeq - inboxHistory.firstSeq) + 1
+                             : inboxHistory.count + inboxCurrentPos;
+    snprintf(bar.right, sizeof(bar.right), "%d/%d", pos, total);
   } else {
-    display.print(F("No Time"));
+    bar.right[0] = '\0';
   }
+}
 
-  // Right: inbox "x/n" (logical position among all valid messages)
-  if (inboxCount > 0) {
-    int logicalPos = 0;
-    int seen       = 0;
+// Would drawClockBar() change anything on screen?
+bool clockBarChanged() {
+  StatusBarText bar;
+  formatClockBar(bar);
+  return strcmp(bar.left, statusBarShown.left) != 0 ||
+         strcmp(bar.right, statusBarShown.right) != 0;
+}
 
-    for (int i = 0; i < INBOX_SIZE; ++i) {
-      if (!inbox[i].valid) {
-        continue;
-      }
-      ++seen;
-      if (i == inboxCurrent) {
-        logicalPos = seen;
-        break;
-      }
-    }
+// Draw the top status bar with clock (left) and inbox position (right).
+// Only the character cells that differ from the previous bar are marked
+// dirty, so a minute change costs a few columns of I2C traffic.
+void drawClockBar() {
+  StatusBarText bar;
+  formatClockBar(bar);
+
+  // Clear status bar area
+  display.fillRect(0, 0, SCREEN_W, STATUS_BAR_HEIGHT, BLACK);
+
+  blitText(0, 0, bar.left);
 
-    char inboxBuf[12];
-    snprintf(inboxBuf, sizeof(inboxBuf), "%d/%d", logicalPos, inboxCount);
+  // Right-aligned, fixed 6 px cells with the built-in font
+  int rightX = SCREEN_W - textWidth(strlen(bar.right));
+  blitTextRight(0, bar.right);
 
-    int16_t x1, y1;
-    uint16_t w, h;
-    display.getTextBounds(inboxBuf, 0, 0, &x1, &y1, &w, &h);
+  // Dirty cells on the left: every position where the old and new text differ
+  size_t oldLen = strlen(statusBarShown.left);
+  size_t newLen = strlen(bar.left);
+  for (size_t i = 0; i < max(oldLen, newLen); ++i) {
+    char oldC = (i < oldLen) ? statusBarShown.left[i] : ' ';
+    char newC = (i < newLen) ? bar.left[i] : ' ';
+    if (oldC != newC) {
+      displayMarkDirty(i * FONT_W, 0, FONT_W, FONT_H);
+    }
+  }
 
-    display.setCursor(SCREEN_W - w, 0);
-    display.print(inboxBuf);
+  // Right side: from the leftmost of the old/new text to the edge
+  if (strcmp(bar.right, statusBarShown.right) != 0) {
+    int oldX = SCREEN_W - textWidth(strlen(statusBarShown.right));
+    int x    = min(oldX, rightX);
+    displayMarkDirty(x, 0, SCREEN_W - x, FONT_H);
   }
+
+  statusBarShown = bar;
 }
 
 // -----------------------------------------------------------------------------
@@ -926,9 +2672,12 @@ void pocsagInit() {
     }
   }
 
+  // Frequency error measurement at every preamble, for the offset calibration
+  radio.setAFCAGCTrigger(RADIOLIB_SX127X_RX_TRIGGER_PREAMBLE_DETECT);
+
   // Initialize Pager client
   Serial.print(F("[Pager] Initializing ... "));
-  state = pager.begin(frequency + offset, 1200);
+  state = pager.begin(frequency + offset, rxBitRate);
   if (state == RADIOLIB_ERR_NONE) {
     Serial.println(F("success!"));
   } else {
@@ -956,533 +2705,3325 @@ void pocsagStartRx() {
 }
 
 // -----------------------------------------------------------------------------
-// Display init & startup screen
-// -----------------------------------------------------------------------------
+// Radio receive task and page queue
 // -----------------------------------------------------------------------------
-// Display init
-// -----------------------------------------------------------------------------
-void displayInit() {
-  if (!display.begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS)) {
-    Serial.println(F("SSD1306 allocation failed"));
-    while (true) {
-      // Halt
-    }
-  }
 
-  display.clearDisplay();
-  display.display();
+// One decoded page, handed from the radio task to loop()
+struct RxPage {
+  uint32_t addr;
+  uint8_t  function;  // 0-3 = A-D, RIC_FUNCTION_UNKNOWN if the tracker missed it
+  uint8_t  len;
+  char     text[INBOX_TEXT_MAX + 1];
+};
 
-  displayIsOn             = true;
-  displayLastActiveMillis = millis();
+// Bounded single-producer/single-consumer queue: the radio task only moves
+// rxQueueHead, loop() only moves rxQueueTail, so no lock is needed.
+static_assert((RX_QUEUE_SIZE & (RX_QUEUE_SIZE - 1)) == 0, "RX_QUEUE_SIZE must be a power of two");
+
+RxPage                rxQueue[RX_QUEUE_SIZE];
+std::atomic<uint32_t> rxQueueHead(0);
+std::atomic<uint32_t> rxQueueTail(0);
+std::atomic<uint32_t> rxQueueDropped(0);  // pages lost because loop() fell behind
+
+// Burst counters, written by the radio task only
+struct RxDrainStats {
+  std::atomic<uint32_t> passes;         // drain passes with data
+  std::atomic<uint32_t> decoded;        // pages decoded successfully
+  std::atomic<uint32_t> budgetHits;     // passes that stopped at RX_DRAIN_BUDGET
+  std::atomic<uint32_t> backlogMax;     // most POCSAG batches buffered at pass start
+  std::atomic<uint32_t> passMax;        // most pages decoded in one pass
+  std::atomic<uint32_t> queueDepthMax;  // most pages waiting for loop()
+};
+
+RxDrainStats rxDrainStats;
+
+void statMax(std::atomic<uint32_t>& stat, uint32_t value) {
+  if (value > stat.load(std::memory_order_relaxed)) {
+    stat.store(value, std::memory_order_relaxed);
+  }
 }
 
-/// Startup screen: simple DAPNET logo (left) + "DAPNET" text + version + battery
-void drawStartupScreen() {
-  display.clearDisplay();
+TaskHandle_t radioTaskHandle = nullptr;
 
-  // Simple icon on the left
-  display.drawCircle(14, 38, 12, WHITE);
-  display.drawCircle(20, 18, 6, WHITE);
-  display.drawCircle(38, 26, 8, WHITE);
+// RadioLib 5.6 PagerClient::readData() does not report the function bits, so
+// the codeword tracker logs every address codeword it sees (addr << 2 | bits)
+// and the radio task pairs each decoded page with the oldest matching entry.
+const uint32_t RX_ADDR_LOG_SIZE = 16;
 
-  display.drawLine(20, 18, 38, 26, WHITE);
-  display.drawLine(20, 18, 14, 38, WHITE);
-  display.drawLine(14, 38, 38, 26, WHITE);
+struct RxAddrLog {
+  volatile uint32_t words[RX_ADDR_LOG_SIZE];
+  volatile uint32_t head;  // bit interrupt only
+  uint32_t          tail;  // radio task only
+};
 
-  // "DAPNET" text on the right
-  display.setTextSize(2);
-  display.setTextColor(WHITE);
-  display.setCursor(52, 20);
-  display.print("DAPNET");
+RxAddrLog rxAddrLog;
 
-  // Version string below
-  display.setTextSize(1);
-  display.setCursor(52, 38);
-  display.print(FW_VERSION);
+void rxAddrLogPush(uint32_t addr, uint8_t function) {
+  uint32_t head = rxAddrLog.head;
+  rxAddrLog.words[head % RX_ADDR_LOG_SIZE] = (addr << 2) | function;
+  rxAddrLog.head = head + 1;
+}
 
-  // Battery voltage at the bottom
-#if defined(ESP32)
-  display.setCursor(0, 54);  // bottom line of 64px display
-  display.print(F("Bat: "));
-  display.print(batteryVoltage, 2);
-  display.print(F("V"));
-#endif
+// Function bits of a decoded page (radio task)
+uint8_t rxAddrLogFunction(uint32_t addr) {
+  uint32_t head = rxAddrLog.head;
+  if (head - rxAddrLog.tail > RX_ADDR_LOG_SIZE) {
+    rxAddrLog.tail = head - RX_ADDR_LOG_SIZE;  // overrun: the oldest are gone
+  }
+  for (uint32_t i = rxAddrLog.tail; i != head; ++i) {
+    uint32_t word = rxAddrLog.words[i % RX_ADDR_LOG_SIZE];
+    if ((word >> 2) == addr) {
+      rxAddrLog.tail = i + 1;
+      return (uint8_t)(word & 3);
+    }
+  }
+  return RIC_FUNCTION_UNKNOWN;
+}
 
-  display.display();
+// Producer: next free entry, or nullptr if the queue is full
+RxPage* rxQueueReserve() {
+  uint32_t head = rxQueueHead.load(std::memory_order_relaxed);
+  uint32_t tail = rxQueueTail.load(std::memory_order_acquire);
+  if (head - tail >= RX_QUEUE_SIZE) {
+    return nullptr;
+  }
+  return &rxQueue[head % RX_QUEUE_SIZE];
 }
 
+// Producer: publish the entry returned by rxQueueReserve()
+void rxQueueCommit() {
+  uint32_t head = rxQueueHead.load(std::memory_order_relaxed);
+  rxQueueHead.store(head + 1, std::memory_order_release);
 
+  statMax(rxDrainStats.queueDepthMax, head + 1 - rxQueueTail.load(std::memory_order_relaxed));
 
-// -----------------------------------------------------------------------------
-// Button handling
-// -----------------------------------------------------------------------------
+  // loop() sleeps until something happens
+  schedWakeLoop();
+}
 
-// We assume buttons are wired to GND and use the internal pull-up resistors.
-void buttonsInit() {
-  pinMode(BTN_UP,    INPUT_PULLUP);
-  pinMode(BTN_ENTER, INPUT_PULLUP);
-  pinMode(BTN_DOWN,  INPUT_PULLUP);
+// Consumer: oldest queued page, or nullptr if the queue is empty
+RxPage* rxQueuePeek() {
+  uint32_t tail = rxQueueTail.load(std::memory_order_relaxed);
+  uint32_t head = rxQueueHead.load(std::memory_order_acquire);
+  if (tail == head) {
+    return nullptr;
+  }
+  return &rxQueue[tail % RX_QUEUE_SIZE];
 }
 
-struct ButtonState {
+// Consumer: release the entry returned by rxQueuePeek()
+void rxQueuePop() {
+  uint32_t tail = rxQueueTail.load(std::memory_order_relaxed);
+  rxQueueTail.store(tail + 1, std::memory_order_release);
+}
+
+// Decode one page from the RadioLib buffer into the queue
+bool radioDecodeOne() {
+  static RxPage scratch;  // used when the queue is full, so the data is still consumed
+
+  RxPage*  page = rxQueueReserve();
+  RxPage*  dst  = page ? page : &scratch;
+  size_t   len  = INBOX_TEXT_MAX;
+  uint32_t addr = 0;
+
+  int state;
+  {
+    PROFILE_SCOPE(PROF_READ_DATA);
+    state = pager.readData((uint8_t*)dst->text, &len, &addr);
+  }
+
+  if (state != RADIOLIB_ERR_NONE) {
+    rxStatsCountFailure(state);
+    Serial.print(F("[Pager] Decoding failed, code "));
+    Serial.println(state);
+    return false;
+  }
+
+  rxCount->n[RX_STAT_DECODED]++;
+
+  uint8_t function = rxAddrLogFunction(addr);
+  if (!isTimeBeaconRic(addr) && ricTableMatch(ricTable(), addr, function) == RIC_NOT_FOUND) {
+    rxCount->n[RX_STAT_UNSUBSCRIBED]++;
+    if (RIC_DROP_UNSUBSCRIBED && !replayActive()) {
+      return true;  // consumed, never queued (replays check every page)
+    }
+  }
+
+  dst->addr      = addr;
+  dst->function  = function;
+  dst->len       = (uint8_t)len;
+  dst->text[len] = '\0';
+
+  if (page) {
+    rxQueueCommit();
+  } else {
+    rxQueueDropped.fetch_add(1, std::memory_order_relaxed);
+  }
+  return true;
+}
+
+// Decode every complete page that is buffered, up to RX_DRAIN_BUDGET.
+// Returns true if the budget ran out with data still waiting.
+bool radioDrain() {
+  size_t backlog = pager.available();
+  statMax(rxDrainStats.backlogMax, backlog);
+  rxDrainStats.passes.fetch_add(1, std::memory_order_relaxed);
+
+  uint32_t decoded = 0;
+  int      tries   = 0;
+
+  // Wait for at least 2 POCSAG batches to fit short/medium messages
+  while (tries < RX_DRAIN_BUDGET && pager.available() >= 2) {
+    if (radioDecodeOne()) {
+      decoded++;
+    }
+    tries++;
+  }
+
+  rxDrainStats.decoded.fetch_add(decoded, std::memory_order_relaxed);
+  statMax(rxDrainStats.passMax, decoded);
+
+  if (tries >= RX_DRAIN_BUDGET && pager.available() >= 2) {
+    rxDrainStats.budgetHits.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+  return false;
+}
+
+// Print the burst counters (used to size RX_QUEUE_SIZE / RX_DRAIN_BUDGET)
+void printRxDrainStats() {
+  Serial.print(F("[Pager] Drain: passes="));
+  Serial.print(rxDrainStats.passes.load());
+  Serial.print(F(" decoded="));
+  Serial.print(rxDrainStats.decoded.load());
+  Serial.print(F(" budgetHits="));
+  Serial.print(rxDrainStats.budgetHits.load());
+  Serial.print(F(" backlogMax="));
+  Serial.print(rxDrainStats.backlogMax.load());
+  Serial.print(F(" passMax="));
+  Serial.print(rxDrainStats.passMax.load());
+  Serial.print(F(" queueMax="));
+  Serial.print(rxDrainStats.queueDepthMax.load());
+  Serial.print('/');
+  Serial.print(RX_QUEUE_SIZE);
+  Serial.print(F(" dropped="));
+  Serial.println(rxQueueDropped.load());
+}
+
+// -----------------------------------------------------------------------------
+// Frame-slot duty cycling (RX_DUTY_CYCLE)
+//
+// A POCSAG batch is a sync codeword followed by 8 frames of 2 codewords; a RIC
+// only ever starts a page in frame (RIC & 7). Our bit interrupt feeds RadioLib
+// as usual and additionally follows the codeword boundaries in real time. Once
+// the last frame that can hold one of our RICs (or a time beacon) is over and
+// no page for us is still running, the radio task puts the SX1278 to sleep
+// and wakes it RX_DUTY_WAKE_MARGIN_BITS before the next batch sync. Only the
+// tail of a batch is skipped: RadioLib derives the frame number of an address
+// from its distance to the last sync word, so the frames in front of ours
+// must still be received.
+// The codeword tracker always runs (also without RX_DUTY_CYCLE): it counts
+// batches, idle batches and sync losses for the RX statistics.
+// -----------------------------------------------------------------------------
+const uint32_t BATCH_BITS = 32 * (1 + 2 * 8);  // sync + 8 frames
+
+// Time beacon RICs (TIME_BEACON_RICS, time_message.h) are always of interest
+bool isTimeBeaconRic(uint32_t addr) {
+  for (uint32_t beacon : TIME_BEACON_RICS) {
+    if (beacon == addr) {
+      return true;
+    }
+  }
+  return false;
+}
+
+struct DutyCycleState {
+  // Real-time codeword tracking, written by the bit interrupt
+  volatile uint32_t shift;          // last 32 received bits
+  volatile uint8_t  bitCount;       // bits of the current codeword
+  volatile uint8_t  wordIdx;        // codeword index after the sync word (0..15)
+  volatile bool     inSync;         // codeword boundaries known
+  volatile bool     pageActive;     // a page for one of our RICs is being received
+  volatile int64_t  syncMicros;     // esp_timer time of the last batch sync
+  volatile bool     sleepRequest;   // ISR → radio task: rest of the batch is not needed
+  volatile int64_t  wakeMicros;     // when to be listening again
+  volatile bool     batchIdle;      // only idle codewords so far in this batch
+  bool              enabled;        // sleeping allowed (RX_DUTY_CYCLE)
+
+  // Configuration and bookkeeping, radio task only
+  bool     awaitSync;      // woke up, expecting the next batch sync
+  int64_t  awaitDeadline;  // give up and stay in continuous RX after this
+  uint32_t batchMicros;    // batch duration at the current bit rate
+  uint32_t marginMicros;   // wake-up margin in front of the sync word
+  uint32_t delayMicros;    // bits reach the tracker this late (correction stage)
+
+  // Statistics
+  uint32_t sleeps;         // batch tails slept through
+  uint32_t syncMisses;     // woke up but the expected sync word did not come
+  int64_t  sleptMicros;    // total time the SX1278 was asleep
+  int64_t  startMicros;    // when duty cycling started
+};
+
+DutyCycleState duty;
+
+// Is a page for one of our subscriptions or a time beacon?
+bool dutyRicOfInterest(uint32_t addr, uint8_t function) {
+  if (ricTableMatch(ricTable(), addr, function) != RIC_NOT_FOUND) {
+    return true;
+  }
+  for (uint32_t beacon : TIME_BEACON_RICS) {
+    if (beacon == addr) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// One complete codeword at duty.wordIdx within the batch
+void dutyOnCodeword(uint32_t cw) {
+  if (duty.wordIdx >= 16) {
+    // Position of the next batch sync word
+    rxCount->n[RX_STAT_BATCHES]++;
+    if (duty.batchIdle) {
+      rxCount->n[RX_STAT_IDLE_BATCHES]++;
+    }
+
+    if (cw == RADIOLIB_PAGER_FRAME_SYNC_CODE_WORD) {
+      duty.wordIdx    = 0;
+      duty.batchIdle  = true;
+      duty.syncMicros = esp_timer_get_time() - duty.delayMicros;
+    } else {
+      duty.inSync     = false;  // end of transmission (or lost bit sync)
+      duty.pageActive = false;
+      rxCount->n[RX_STAT_SYNC_LOSSES]++;
+    }
+    return;
+  }
+
+  uint8_t frame = duty.wordIdx / 2;
+
+  if (cw == RADIOLIB_PAGER_IDLE_CODE_WORD) {
+    duty.pageActive = false;
+  } else if ((cw & 0x80000000UL) == 0) {
+    // Address codeword: 18 address bits, the low 3 bits are the frame number,
+    // then the 2 function bits
+    uint32_t addr     = (((cw >> 13) & 0x3FFFFUL) << 3) | frame;
+    uint8_t  function = (uint8_t)((cw >> 11) & 3);
+    rxAddrLogPush(addr, function);
+    duty.pageActive = dutyRicOfInterest(addr, function);
+    duty.batchIdle  = false;
+  } else {
+    duty.batchIdle  = false;
+  }
+  // Message codewords continue whatever page is running
+
+  duty.wordIdx++;
+
+  if (duty.enabled && !duty.pageActive && !duty.sleepRequest &&
+      duty.wordIdx >= 2 * (ricTable().lastFrame + 1) && duty.wordIdx < 16) {
+    duty.wakeMicros   = duty.syncMicros + duty.batchMicros - duty.marginMicros;
+    duty.sleepRequest = true;
+    if (radioTaskHandle) {
+      BaseType_t woken = pdFALSE;
+      vTaskNotifyGiveFromISR(radioTaskHandle, &woken);
+      if (woken) {
+        portYIELD_FROM_ISR();
+      }
+    }
+  }
+}
+
+// Preamble hunting for the auto bit rate (BAUDRATE 0), written by the bit
+// interrupt while the SX1278 samples at POCSAG_HUNT_BIT_RATE
+struct RateHuntState {
+  volatile bool      active;    // detector armed
+  volatile uint16_t  detected;  // ISR -> radio task: bit rate of a preamble
+  uint8_t            lastBit;
+  uint16_t           samples;   // samples since the last level change
+  PocsagRateDetector det;
+};
+
+RateHuntState rateHunt;
+
+void rateHuntBit(uint8_t bit) {
+  if (!rateHunt.active) {
+    return;
+  }
+  if (bit == rateHunt.lastBit) {
+    if (rateHunt.samples < 0xFFFF) {
+      rateHunt.samples++;
+    }
+    return;
+  }
+  rateHunt.lastBit = bit;
+
+  uint32_t intervalUs = (uint32_t)rateHunt.samples * 1000000UL / POCSAG_HUNT_BIT_RATE;
+  rateHunt.samples    = 1;
+  uint16_t rate       = pocsagRateDetectorEdge(rateHunt.det, intervalUs);
+  if (rate == 0) {
+    return;
+  }
+
+  rateHunt.active   = false;
+  rateHunt.detected = rate;
+  if (radioTaskHandle) {
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(radioTaskHandle, &woken);
+    if (woken) {
+      portYIELD_FROM_ISR();
+    }
+  }
+}
+
+// Follow the codeword boundaries of the received bit stream
+void rxTrackBit(uint8_t bit) {
+  uint32_t shift = (duty.shift << 1) | bit;
+  duty.shift     = shift;
+
+  if (!duty.inSync) {
+    if (shift == RADIOLIB_PAGER_FRAME_SYNC_CODE_WORD) {
+      duty.inSync     = true;
+      duty.bitCount   = 0;
+      duty.wordIdx    = 0;
+      duty.batchIdle  = true;
+      duty.syncMicros = esp_timer_get_time() - duty.delayMicros;
+      rxCount->n[RX_STAT_SYNCS]++;
+    }
+    return;
+  }
+
+  if (++duty.bitCount == 32) {
+    duty.bitCount = 0;
+    dutyOnCodeword(shift);
+  }
+}
+
+// A bit as RadioLib and the tracker would have seen it from DIO2
+void rxDeliverBit(uint8_t bit) {
+  radio.feedBit(bit);
+  rxTrackBit(bit);
+}
+
+#if POCSAG_BCH_ENABLE
+// Codeword correction stage between DIO2 and RadioLib. Every bit leaves a
+// 32-bit window one codeword after it arrived; when the window holds a
+// complete codeword it is corrected in place, an (errored) sync word is
+// replaced by the clean one, so PagerClient and the tracker see both fixed.
+struct BchStage {
+  uint32_t window;
+  bool     inSync;
+  uint8_t  bitCount;
+  uint8_t  wordIdx;  // POCSAG_BATCH_WORDS: sync word expected
+};
+
+BchStage bch;
+
+void bchStageReset() {
+  bch.window = 0;
+  bch.inSync = false;
+}
+
+void bchStageBit(uint8_t bit) {
+  uint8_t out = bch.window >> 31;
+  bch.window  = (bch.window << 1) | bit;
+  rxDeliverBit(out);
+
+  if (!bch.inSync) {
+    if (pocsagIsSyncWord(bch.window, POCSAG_SYNC_HUNT_ERRORS)) {
+      if (bch.window != POCSAG_SYNC_WORD) {
+        rxCount->n[RX_STAT_FEC_SYNCS]++;
+      }
+      bch.window   = POCSAG_SYNC_WORD;
+      bch.inSync   = true;
+      bch.bitCount = 0;
+      bch.wordIdx  = 0;
+    }
+    return;
+  }
+
+  if (++bch.bitCount < 32) {
+    return;
+  }
+  bch.bitCount = 0;
+
+  if (bch.wordIdx == POCSAG_BATCH_WORDS) {
+    if (pocsagIsSyncWord(bch.window, POCSAG_SYNC_BATCH_ERRORS)) {
+      if (bch.window != POCSAG_SYNC_WORD) {
+        rxCount->n[RX_STAT_FEC_SYNCS]++;
+      }
+      bch.window  = POCSAG_SYNC_WORD;
+      bch.wordIdx = 0;
+    } else {
+      bch.inSync = false;  // end of transmission: pass the noise on as it is
+    }
+    return;
+  }
+
+  int fixed = pocsagCorrectCodeword(bch.window);
+  if (fixed > 0) {
+    rxCount->n[RX_STAT_FEC_WORDS]++;
+    rxCount->n[RX_STAT_FEC_BITS] += fixed;
+  } else if (fixed < 0) {
+    rxCount->n[RX_STAT_FEC_FAILED]++;
+  }
+  bch.wordIdx++;
+}
+#endif
+
+// Received (or replayed) bit into the decoding chain
+void rxInputBit(uint8_t bit) {
+#if POCSAG_BCH_ENABLE
+  bchStageBit(bit);
+#else
+  rxDeliverBit(bit);
+#endif
+}
+
+// Bit clock interrupt (DIO1) replacing RadioLib's own handler. DIO2 is
+// sampled once, the same level goes to the rate hunt, RadioLib and the
+// tracker. Like PagerClient's handler it runs from flash (the chain calls
+// into RadioLib and PagerCore) through the Arduino GPIO interrupt service,
+// which is not IRAM-safe: while LittleFS writes or erases flash the
+// interrupt waits, the bits of that time are lost and the tracker picks up
+// again at the next batch sync word.
+void pagerBitIsr() {
+  uint8_t bit = digitalRead(LORA_DIO2) ? 1 : 0;
+  rateHuntBit(bit);
+  rxInputBit(bit);
+}
+
+// Bit timing of the tracker and the duty cycling
+void rxTrackerSetBitRate(uint16_t bitRate) {
+  duty.batchMicros  = (uint32_t)((uint64_t)BATCH_BITS * 1000000UL / bitRate);
+  duty.marginMicros = (uint32_t)((uint64_t)RX_DUTY_WAKE_MARGIN_BITS * 1000000UL / bitRate);
+  duty.delayMicros  = POCSAG_BCH_ENABLE ? (uint32_t)(32 * 1000000UL / bitRate) : 0;
+}
+
+// Set up duty cycling for the current bit rate. The last frame of interest
+// comes from the RIC table, so a reloaded table takes effect at once.
+void dutyCycleInit(uint16_t bitRate) {
+  uint8_t lastFrame = ricTable().lastFrame;
+
+  duty.startMicros  = esp_timer_get_time();
+  rxTrackerSetBitRate(bitRate);
+  duty.enabled      = true;
+
+  Serial.print(F("[Pager] Duty cycling: last frame of interest "));
+  Serial.print(lastFrame);
+  Serial.print(F(", up to "));
+  Serial.print((7 - lastFrame) * 100 / 8);
+  Serial.println(F("% of each batch asleep"));
+}
+
+// Take over the bit interrupt: RadioLib still gets every bit, the codeword
+// tracker follows batches for the RX statistics and the duty cycling
+void rxTrackerStart() {
+#if POCSAG_BCH_ENABLE
+  bchStageReset();
+#endif
+  radio.setDirectAction(pagerBitIsr);
+}
+
+// Print the duty cycle figures: receiver on-time and the estimated SX1278
+// current against continuous RX (datasheet values, see RX_CURRENT_MA)
+void printDutyCycleStats() {
+  int64_t total = esp_timer_get_time() - duty.startMicros;
+  if (total <= 0) {
+    return;
+  }
+
+  float asleep    = (float)duty.sleptMicros / (float)total;
+  float currentMa = RX_CURRENT_MA * (1.0f - asleep) + RX_SLEEP_CURRENT_MA * asleep;
+
+  Serial.print(F("[Pager] Duty: sleeps="));
+  Serial.print(duty.sleeps);
+  Serial.print(F(" syncMisses="));
+  Serial.print(duty.syncMisses);
+  Serial.print(F(" asleep="));
+  Serial.print(asleep * 100.0f, 1);
+  Serial.print(F("% radio~"));
+  Serial.print(currentMa, 2);
+  Serial.print(F("mA (continuous "));
+  Serial.print(RX_CURRENT_MA, 2);
+  Serial.println(F("mA)"));
+}
+
+// Radio task side: sleep through the rest of the batch if the ISR asked for it
+void dutyCycleService() {
+  int64_t now = esp_timer_get_time();
+
+  // Expected sync word did not come: stay in continuous RX until it does
+  if (duty.awaitSync) {
+    if (duty.inSync) {
+      duty.awaitSync = false;
+    } else if (now > duty.awaitDeadline) {
+      duty.awaitSync = false;
+      duty.syncMisses++;
+    }
+  }
+
+  if (!duty.sleepRequest) {
+    return;
+  }
+  duty.sleepRequest = false;
+
+  int64_t sleepMicros = duty.wakeMicros - now;
+  if (sleepMicros < (int64_t)RX_DUTY_MIN_SLEEP_MS * 1000) {
+    return;
+  }
+
+  radio.sleep();
+#if CONFIG_PM_ENABLE
+  if (radioPmLock) {
+    esp_pm_lock_release(radioPmLock);  // nothing to clock in: light sleep is fine
+  }
+#endif
+
+  vTaskDelay(pdMS_TO_TICKS(sleepMicros / 1000));
+
+#if CONFIG_PM_ENABLE
+  if (radioPmLock) {
+    esp_pm_lock_acquire(radioPmLock);
+  }
+#endif
+
+  // Back to continuous RX; both RadioLib and our tracker hunt for the sync word
+  duty.inSync = false;
+#if POCSAG_BCH_ENABLE
+  bchStageReset();
+#endif
+  radio.receiveDirect();
+  radio.dropSync();
+
+  int64_t woke       = esp_timer_get_time();
+  duty.sleptMicros  += woke - now;
+  duty.awaitSync     = true;
+  duty.awaitDeadline = woke + 2 * (int64_t)duty.marginMicros;
+  duty.sleeps++;
+
+  if (duty.sleeps % 1000 == 0) {
+    printDutyCycleStats();
+  }
+}
+
+// -----------------------------------------------------------------------------
+// RF replay harness
+// -----------------------------------------------------------------------------
+#if RF_REPLAY_ENABLE
+// Replay runs on the radio task: the SX1278 is put into standby and the
+// stream is fed bit by bit, on the air-time schedule, into RadioLib's
+// direct-mode buffer and our codeword tracker. PagerClient, the radio queue
+// and the page routing then run exactly as for received pages; replayed
+// pages are scored instead of stored.
+const int      REPLAY_MAX_PAGES    = 256;
+const size_t   REPLAY_FILE_CHUNK   = 256;
+const uint32_t REPLAY_DRAIN_MS     = 500;  // after the last bit, queue and loop catch up
+
+enum ReplayPhase : uint8_t {
+  REPLAY_IDLE,
+  REPLAY_STARTING,  // loop -> radio task: session is set up
+  REPLAY_RUNNING,
+  REPLAY_DRAINING,
+  REPLAY_DONE       // radio task -> loop: print the report
+};
+
+struct ReplaySession {
+  std::atomic<uint8_t> phase{REPLAY_IDLE};
+  std::atomic<bool>    stopRequest{false};
+  bool                 fromFile;
+  File                 file;
+  uint32_t             bitRate;
+  uint32_t             totalBits;
+  uint32_t             fedBits;
+  int64_t              startMicros;
+  int64_t              drainUntil;
+  bool                 dutyWasEnabled;
+  ReplayChannel        channel;
+  uint8_t              chunk[REPLAY_FILE_CHUNK];
+  uint32_t             chunkBase;  // bit index of chunk[0]
+  uint32_t             chunkBits;
+  ReplayMatcher        matcher;
+  RxStatsCounters      stats;  // counted instead of rxStats while the run lasts
+};
+
+ReplaySession replay;
+uint8_t       replayBits[RF_REPLAY_BUFFER_BYTES];
+ReplayExpect  replayExpect[REPLAY_MAX_PAGES];
+
+bool replayActive() {
+  return replay.phase.load(std::memory_order_acquire) != REPLAY_IDLE;
+}
+
+// Next stream bit, from RAM or from the file in chunks
+uint8_t replayStreamBit(uint32_t index) {
+  if (!replay.fromFile) {
+    return bitBufferGet(replayBits, index);
+  }
+  if (index >= replay.chunkBase + replay.chunkBits) {
+    size_t got       = replay.file.read(replay.chunk, sizeof(replay.chunk));
+    replay.chunkBase = index;
+    replay.chunkBits = got * 8;
+    if (got == 0) {
+      replay.totalBits = index;  // file shorter than its header says
+      return 0;
+    }
+  }
+  return bitBufferGet(replay.chunk, index - replay.chunkBase);
+}
+
+// Radio task side: feed all bits that are due by now
+void replayService() {
+  switch (replay.phase.load(std::memory_order_acquire)) {
+    case REPLAY_STARTING:
+      radio.standby();  // no bit clock from the SX1278 while we feed
+      radio.dropSync();
+      duty.inSync           = false;
+#if POCSAG_BCH_ENABLE
+      bchStageReset();
+#endif
+      replay.dutyWasEnabled = duty.enabled;
+      duty.enabled          = false;  // dutyOnCodeword must not notify from task context
+      replay.stats          = {};
+      rxCount               = &replay.stats;  // replay must not show up in the RX statistics
+      replay.fedBits        = 0;
+      replay.chunkBase      = 0;
+      replay.chunkBits      = 0;
+      replay.startMicros    = esp_timer_get_time();
+      replay.phase.store(REPLAY_RUNNING, std::memory_order_release);
+      break;
+
+    case REPLAY_RUNNING: {
+      int64_t  elapsed = esp_timer_get_time() - replay.startMicros;
+      uint64_t due     = (uint64_t)elapsed * replay.bitRate / 1000000ULL;
+      while (replay.fedBits < due && replay.fedBits < replay.totalBits) {
+        uint8_t bit = replayStreamBit(replay.fedBits);
+        if (replay.fedBits >= replay.totalBits) {
+          break;  // short file
+        }
+        rxInputBit(replayChannelBit(replay.channel, bit));
+        replay.fedBits++;
+      }
+      if (replay.fedBits >= replay.totalBits || replay.stopRequest.load(std::memory_order_relaxed)) {
+        replay.drainUntil = esp_timer_get_time() +
+                            replayBitsToMicros(2 * POCSAG_BATCH_BITS, replay.bitRate) +
+                            (int64_t)REPLAY_DRAIN_MS * 1000;
+        replay.phase.store(REPLAY_DRAINING, std::memory_order_release);
+      }
+      break;
+    }
+
+    case REPLAY_DRAINING:
+      if (esp_timer_get_time() < replay.drainUntil) {
+        break;
+      }
+      if (replay.fromFile) {
+        replay.file.close();
+      }
+      duty.inSync  = false;
+      duty.enabled = replay.dutyWasEnabled;
+      rxCount      = &rxStats;
+      pocsagStartRx();
+      rxTrackerStart();
+      replay.phase.store(REPLAY_DONE, std::memory_order_release);
+      schedWakeLoop();
+      break;
+
+    default:
+      break;
+  }
+}
+
+bool replayFeeding() {
+  uint8_t phase = replay.phase.load(std::memory_order_acquire);
+  return phase == REPLAY_STARTING || phase == REPLAY_RUNNING || phase == REPLAY_DRAINING;
+}
+
+// Loop side: hand the prepared session to the radio task
+void replayStart(const ReplayImpairment& imp) {
+  replayChannelInit(replay.channel, imp);
+  replay.stopRequest.store(false, std::memory_order_relaxed);
+  replay.phase.store(REPLAY_STARTING, std::memory_order_release);
+  if (radioTaskHandle) {
+    xTaskNotifyGive(radioTaskHandle);
+  }
+
+  Serial.print(F("[Replay] "));
+  Serial.print(replay.matcher.count);
+  Serial.print(F(" pages, "));
+  Serial.print(replay.totalBits);
+  Serial.print(F(" bits at "));
+  Serial.print(replay.bitRate);
+  Serial.print(F(" bps, "));
+  Serial.print((uint32_t)(replayBitsToMicros(replay.totalBits, replay.bitRate) / 1000));
+  Serial.println(F(" ms air time"));
+}
+
+// Synthetic stream for the subscribed RICs
+bool replayStartSynthetic(uint16_t pages, uint32_t bitRate, const ReplayImpairment& imp) {
+  static uint32_t rics[RIC_TABLE_MAX];
+  const RicTable& table    = ricTable();
+  int             ricCount = 0;
+  for (int i = 0; i < table.count; i++) {
+    rics[ricCount++] = table.entries[i].addr;
+  }
+  if (ricCount == 0 || pages == 0 || !replayBitRateSupported(bitRate)) {
+    return false;
+  }
+
+  ReplayScenario sc = {};
+  sc.pages          = pages;
+  sc.pagesPerBurst  = 4;
+  sc.gapBits        = 300;
+  sc.rics           = rics;
+  sc.ricCount       = ricCount;
+  sc.seed           = imp.seed;
+
+  BitBuffer bits;
+  bitBufferInit(bits, replayBits, sizeof(replayBits));
+  int built = replayBuildScenario(sc, bits, replayExpect, REPLAY_MAX_PAGES);
+  if (built < pages) {
+    Serial.print(F("[Replay] Buffer holds only "));
+    Serial.print(built);
+    Serial.println(F(" pages"));
+  }
+
+  replay.fromFile  = false;
+  replay.bitRate   = bitRate;
+  replay.totalBits = bits.bits;
+  replayMatcherInit(replay.matcher, replayExpect, built);
+  replayStart(imp);
+  return true;
+}
+
+// Recorded stream from LittleFS (format in rf_replay.h)
+bool replayStartFile(const char* path, const ReplayImpairment& imp) {
+  File f = LittleFS.open(path, FILE_READ);
+  if (!f) {
+    Serial.print(F("[Replay] Cannot open "));
+    Serial.println(path);
+    return false;
+  }
+
+  uint8_t  hdr[REPLAY_FILE_HEADER_LEN];
+  uint16_t bitRate, pages;
+  uint32_t bits;
+  if (f.read(hdr, sizeof(hdr)) != sizeof(hdr) ||
+      !replayDecodeFileHeader(hdr, bitRate, pages, bits) || !replayBitRateSupported(bitRate)) {
+    Serial.println(F("[Replay] Not a replay file"));
+    f.close();
+    return false;
+  }
+
+  // Pages beyond REPLAY_MAX_PAGES are still played, they count as spurious
+  int kept = 0;
+  for (uint16_t i = 0; i < pages; i++) {
+    uint8_t entry[REPLAY_FILE_PAGE_LEN];
+    if (f.read(entry, sizeof(entry)) != sizeof(entry)) {
+      Serial.println(F("[Replay] Truncated page table"));
+      f.close();
+      return false;
+    }
+    if (kept < REPLAY_MAX_PAGES) {
+      replayDecodeExpect(entry, replayExpect[kept++]);
+    }
+  }
+
+  replay.file      = f;
+  replay.fromFile  = true;
+  replay.bitRate   = bitRate;
+  replay.totalBits = bits;
+  replayMatcherInit(replay.matcher, replayExpect, kept);
+  replayStart(imp);
+  return true;
+}
+
+// Loop side: score a decoded page against the stream
+void replayOnPage(uint32_t addr, const char* text, size_t len) {
+  uint8_t phase = replay.phase.load(std::memory_order_acquire);
+  if (phase != REPLAY_RUNNING && phase != REPLAY_DRAINING) {
+    return;
+  }
+  int idx = replayMatchPage(replay.matcher, addr, text, len);
+  if (idx >= 0) {
+    // Air time of the page's last bit to here: decode, queue and loop latency
+    int64_t sent = replay.startMicros +
+                   (int64_t)replayBitsToMicros(replay.matcher.expect[idx].endBit, replay.bitRate);
+    int64_t now  = esp_timer_get_time();
+    replayRecordLatency(replay.matcher, now > sent ? (uint32_t)(now - sent) : 0);
+  }
+}
+
+void replayPrintReport() {
+  const ReplayStats& s   = replay.matcher.stats;
+  uint32_t           air = (uint32_t)(replayBitsToMicros(replay.fedBits, replay.bitRate) / 1000);
+
+  Serial.print(F("[Replay] Done: "));
+  Serial.print(replay.fedBits);
+  Serial.print(F(" bits in "));
+  Serial.print(air);
+  Serial.print(F(" ms, "));
+  Serial.print(replay.channel.errors);
+  Serial.println(F(" bit errors injected"));
+
+  Serial.print(F("[Replay] Pages: "));
+  Serial.print(s.expected);
+  Serial.print(F(" sent, "));
+  Serial.print(s.intact);
+  Serial.print(F(" intact, "));
+  Serial.print(s.corrupted);
+  Serial.print(F(" corrupted, "));
+  Serial.print(s.lost);
+  Serial.print(F(" lost, "));
+  Serial.print(s.spurious);
+  Serial.println(F(" spurious"));
+
+  Serial.print(F("[Replay] Decoded "));
+  Serial.print(air > 0 ? (s.intact + s.corrupted) * 1000.0f / air : 0.0f, 2);
+  Serial.print(F(" pages/s, latency avg "));
+  Serial.print(s.latencyCount > 0 ? (uint32_t)(s.latencySumUs / s.latencyCount / 1000) : 0);
+  Serial.print(F(" ms, max "));
+  Serial.print(s.latencyMaxUs / 1000);
+  Serial.println(F(" ms"));
+}
+
+// Called from loop(): report a finished run
+void handleReplay() {
+  if (replay.phase.load(std::memory_order_acquire) != REPLAY_DONE) {
+    return;
+  }
+  replayMatcherFinish(replay.matcher);
+  replayPrintReport();
+  replay.phase.store(REPLAY_IDLE, std::memory_order_release);
+}
+#else
+inline bool replayActive() {
+  return false;
+}
+#endif
+
+// -----------------------------------------------------------------------------
+// Channel scan & bit rate detection
+// -----------------------------------------------------------------------------
+// Hunting: with auto rate the SX1278 samples at POCSAG_HUNT_BIT_RATE and the
+// bit interrupt times the preamble; a detected rate is switched to at once,
+// so the rest of the 576-bit preamble covers the retune. With a scan list
+// the receiver hops every SCAN_DWELL_MS until a batch sync arrives, and
+// stays until RX_SCAN_HOLD_MS after the last one.
+enum RxScanPhase : uint8_t {
+  SCAN_HUNT,     // waiting for a preamble or a sync word
+  SCAN_CONFIRM,  // rate detected and set, waiting for the sync word
+  SCAN_LOCKED
+};
+
+struct RxScanState {
+  bool        enabled;
+  bool        autoRate;
+  float       channels[SCANNUMBER];
+  int         channelCount;
+  int         channel;
+  RxScanPhase phase;
+  int64_t     deadline;   // hop (hunting) or give up (confirming)
+  int64_t     lockStart;  // preamble detected, or channel tuned with a fixed rate
+  uint32_t    syncsSeen;  // RX_STAT_SYNCS at the last check
+
+  // Statistics
+  uint32_t hops;
+  uint32_t detections;
+  uint32_t falseDetections;  // rate detected, no sync followed
+  uint32_t locks;
+  uint32_t lockLastMs;
+  uint32_t lockMinMs;
+  uint32_t lockMaxMs;
+  uint64_t lockSumMs;
+};
+
+RxScanState scan;
+
+void rateHuntArm() {
+  rateHunt.active   = false;
+  rateHunt.detected = 0;
+  rateHunt.lastBit  = 0;
+  rateHunt.samples  = 0;
+  pocsagRateDetectorReset(rateHunt.det);
+  rateHunt.active   = true;
+}
+
+// Reconfigure the SX1278 for a channel and bit rate, RX continues at once
+void radioTune(float freq, uint16_t bitRate) {
+  rateHunt.active = false;
+  radio.standby();
+
+  int state = pager.begin(freq + offset, bitRate);
+  if (state == RADIOLIB_ERR_NONE) {
+    state = radio.setRxBandwidth(pocsagRxBandwidthKHz(bitRate));
+  }
+  if (state == RADIOLIB_ERR_NONE) {
+    state = pager.startReceive(LORA_DIO2, 200, 0);
+  }
+  if (state != RADIOLIB_ERR_NONE) {
+    Serial.print(F("[Scan] Tuning failed, code "));
+    Serial.println(state);
+  }
+
+  frequency = freq;
+  if (bitRate != rxBitRate) {
+    rxBitRate = bitRate;
+    rxTrackerSetBitRate(bitRate);
+  }
+  duty.inSync = false;
+  rxTrackerStart();
+}
+
+// Back to hunting on the current channel
+void rxScanHunt(int64_t now) {
+  scan.phase     = SCAN_HUNT;
+  scan.deadline  = now + (int64_t)SCAN_DWELL_MS * 1000;
+  scan.lockStart = now;
+  if (scan.autoRate) {
+    if (rxBitRate != POCSAG_HUNT_BIT_RATE) {
+      radioTune(scan.channels[scan.channel], POCSAG_HUNT_BIT_RATE);
+    }
+    rateHuntArm();
+  }
+}
+
+void rxScanLocked() {
+  uint32_t ms = (uint32_t)(max<int64_t>(duty.syncMicros - scan.lockStart, 0) / 1000);
+  scan.phase      = SCAN_LOCKED;
+  scan.lockLastMs = ms;
+  scan.lockMinMs  = (scan.locks == 0) ? ms : min(scan.lockMinMs, ms);
+  scan.lockMaxMs  = max(scan.lockMaxMs, ms);
+  scan.lockSumMs += ms;
+  scan.locks++;
+
+  Serial.print(F("[Scan] Locked on "));
+  Serial.print(frequency, 5);
+  Serial.print(F(" MHz at "));
+  Serial.print(rxBitRate);
+  Serial.print(F(" bps in "));
+  Serial.print(ms);
+  Serial.println(F(" ms"));
+}
+
+void rxScanInit() {
+  scan.channelCount = 0;
+  for (int i = 0; i < SCANNUMBER; i++) {
+    if (scanFrequency[i] > 0) {
+      scan.channels[scan.channelCount++] = scanFrequency[i];
+    }
+  }
+  if (scan.channelCount < 2) {
+    scan.channels[0]  = frequency;
+    scan.channelCount = 1;
+  }
+  scan.autoRate = (BAUDRATE == 0);
+  scan.enabled  = scan.autoRate || scan.channelCount > 1;
+  if (!scan.enabled) {
+    return;
+  }
+
+  Serial.print(F("[Scan] "));
+  Serial.print(scan.channelCount);
+  Serial.print(F(" channel(s), "));
+  Serial.print(SCAN_DWELL_MS);
+  Serial.print(F(" ms dwell, bit rate "));
+  if (scan.autoRate) {
+    Serial.println(F("auto"));
+  } else {
+    Serial.println(rxBitRate);
+  }
+
+  scan.channel   = 0;
+  scan.syncsSeen = rxStats.n[RX_STAT_SYNCS];
+  radioTune(scan.channels[0], POCSAG_BIT_RATE);
+  rxScanHunt(esp_timer_get_time());
+}
+
+// Radio task side: hop, switch rates and track the lock
+void rxScanService() {
+  if (!scan.enabled) {
+    return;
+  }
+
+  int64_t  now     = esp_timer_get_time();
+  uint32_t syncs   = rxStats.n[RX_STAT_SYNCS];
+  bool     newSync = syncs != scan.syncsSeen;
+  scan.syncsSeen   = syncs;
+
+  switch (scan.phase) {
+    case SCAN_HUNT: {
+      uint16_t rate = rateHunt.detected;
+      if (newSync) {
+        rateHunt.active = false;
+        rxScanLocked();
+      } else if (rate != 0) {
+        // Lock-on time counts from the first preamble edge that was timed
+        rateHunt.detected = 0;
+        scan.detections++;
+        scan.lockStart = now - (int64_t)POCSAG_RATE_DETECT_EDGES * 1000000 / rate;
+        if (rate != rxBitRate) {
+          radioTune(scan.channels[scan.channel], rate);
+        }
+        scan.syncsSeen = rxStats.n[RX_STAT_SYNCS];
+        scan.phase     = SCAN_CONFIRM;
+        scan.deadline  = now + (int64_t)(POCSAG_PREAMBLE_BITS + 2 * POCSAG_BATCH_BITS) * 1000000 / rate;
+      } else if (now >= scan.deadline && scan.channelCount > 1) {
+        if (rateHunt.active && rateHunt.det.run >= 4) {
+          scan.deadline = now + 50000;  // a preamble is being timed, let it finish
+          break;
+        }
+        scan.channel = (scan.channel + 1) % scan.channelCount;
+        scan.hops++;
+        radioTune(scan.channels[scan.channel], rxBitRate);
+        rxScanHunt(now);
+      }
+      break;
+    }
+
+    case SCAN_CONFIRM:
+      if (newSync) {
+        rxScanLocked();
+      } else if (now >= scan.deadline) {
+        scan.falseDetections++;
+        rxScanHunt(now);
+      }
+      break;
+
+    case SCAN_LOCKED:
+      if (!newSync && now - duty.syncMicros > (int64_t)RX_SCAN_HOLD_MS * 1000) {
+        rxScanHunt(now);
+      }
+      break;
+  }
+}
+
+void printRxScanStats() {
+  if (!scan.enabled) {
+    return;
+  }
+  Serial.print(F("[Scan] "));
+  Serial.print(frequency, 5);
+  Serial.print(F(" MHz, "));
+  Serial.print(rxBitRate);
+  Serial.print(F(" bps, "));
+  Serial.print(scan.phase == SCAN_LOCKED ? F("locked") : F("hunting"));
+  Serial.print(F(", hops "));
+  Serial.print(scan.hops);
+  Serial.print(F(", rate detections "));
+  Serial.print(scan.detections);
+  Serial.print(F(" ("));
+  Serial.print(scan.falseDetections);
+  Serial.println(F(" without sync)"));
+
+  Serial.print(F("[Scan] Locks "));
+  Serial.print(scan.locks);
+  Serial.print(F(", lock-on last "));
+  Serial.print(scan.lockLastMs);
+  Serial.print(F(" ms, min "));
+  Serial.print(scan.lockMinMs);
+  Serial.print(F(" ms, avg "));
+  Serial.print(scan.locks > 0 ? (uint32_t)(scan.lockSumMs / scan.locks) : 0);
+  Serial.print(F(" ms, max "));
+  Serial.print(scan.lockMaxMs);
+  Serial.println(F(" ms"));
+}
+
+// -----------------------------------------------------------------------------
+// Frequency error sampling (radio task side of the offset calibration)
+// -----------------------------------------------------------------------------
+// The SX1278 measures the frequency error (FEI) when it detects a preamble.
+// The radio task reads it once per acquired sync word; the loop pairs it
+// with the page that follows, so only known traffic is used.
+struct RxFeiSample {
+  std::atomic<uint32_t> seq{0};  // bumped for every new reading
+  volatile int32_t      hz = 0;  // positive: carrier above the tuned frequency
+  uint32_t              syncsSeen = 0;
+};
+
+RxFeiSample rxFei;
+
+void rxFeiService() {
+  uint32_t syncs = rxStats.n[RX_STAT_SYNCS];
+  if (syncs == rxFei.syncsSeen) {
+    return;
+  }
+  rxFei.syncsSeen = syncs;
+  rxFei.hz        = (int32_t)lroundf(radio.getFrequencyError());
+  rxFei.seq.fetch_add(1, std::memory_order_release);
+}
+
+// Queue a retune for the radio task
+void radioQueueRetune(float newFrequency, float newOffset) {
+  radioRetuneFrequency = newFrequency;
+  radioRetuneOffset    = newOffset;
+  radioRetunePending.store(true, std::memory_order_release);
+  if (radioTaskHandle) {
+    xTaskNotifyGive(radioTaskHandle);
+  }
+}
+
+// Apply a console retune: frequency and offset only change if the SX1278
+// accepts them, RX continues on the old channel otherwise
+void radioApplyRetune() {
+  float newFrequency = radioRetuneFrequency;
+  float newOffset    = radioRetuneOffset;
+
+  radio.standby();
+  int state = radio.setFrequency(newFrequency + newOffset);
+  if (state == RADIOLIB_ERR_NONE) {
+    frequency = newFrequency;
+    offset    = newOffset;
+    Serial.print(F("[Pager] Retuned to "));
+    Serial.print(frequency + offset, 5);
+    Serial.println(F(" MHz"));
+  } else {
+    Serial.print(F("[Pager] Retune failed, code "));
+    Serial.println(state);
+  }
+
+  duty.inSync = false;
+  pocsagStartRx();
+  rxTrackerStart();
+}
+
+// Radio task: owns the receiver, so decoding never waits for display or flash I/O
+void radioTask(void* arg) {
+  (void)arg;
+
+  // Start RX from this task, so the DIO interrupt runs on the same core
+  // as the code reading the RadioLib bit buffer
+  pocsagStartRx();
+  rxTrackerStart();
+
+  Serial.print(F("[Boot] Listening after "));
+  Serial.print((uint32_t)(esp_timer_get_time() / 1000));
+  Serial.println(F(" ms"));
+
+#if RX_DUTY_CYCLE
+  dutyCycleInit(rxBitRate);
+#endif
+  rxScanInit();
+
+  while (true) {
+    if (radioRetunePending.load(std::memory_order_acquire)) {
+      radioRetunePending.store(false, std::memory_order_relaxed);
+      radioApplyRetune();
+    }
+
+#if RF_REPLAY_ENABLE
+    replayService();
+#endif
+
+    if (pager.available() >= 2) {
+      // Burst: drain what is buffered, then give lower-priority tasks on
+      // this core one tick before continuing with the rest
+      radioDrain();
+      vTaskDelay(1);
+#if RF_REPLAY_ENABLE
+    } else if (replayFeeding()) {
+      ulTaskNotifyTake(pdTRUE, 1);  // feed the replay stream every tick
+#endif
+    } else {
+      // The duty cycle ISR notifies us when the rest of a batch can be skipped
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(RADIO_TASK_POLL_MS));
+    }
+
+    if (!replayActive()) {
+#if RX_DUTY_CYCLE
+      dutyCycleService();
+#endif
+      rxScanService();
+      rxFeiService();
+    }
+  }
+}
+
+void radioTaskStart() {
+  xTaskCreatePinnedToCore(radioTask, "radio", 4096, nullptr,
+                          RADIO_TASK_PRIORITY, &radioTaskHandle, RADIO_TASK_CORE);
+}
+
+// -----------------------------------------------------------------------------
+// Display init & startup screen
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+// Display init
+// -----------------------------------------------------------------------------
+void displayInit() {
+  if (!display.begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS)) {
+    Serial.println(F("SSD1306 allocation failed"));
+    while (true) {
+      // Halt
+    }
+  }
+
+  display.clearDisplay();
+  display.cp437(true);  // correct code page 437 glyph positions (umlauts)
+  displayFlushAll();
+
+  Serial.print(F("[Display] I2C clock "));
+  Serial.print(OLED_I2C_CLOCK / 1000);
+  Serial.println(F(" kHz"));
+
+  displayIsOn             = true;
+  displayLastActiveMillis = millis();
+}
+
+/// Startup screen: simple DAPNET logo (left) + "DAPNET" text + version + battery
+void drawStartupScreen() {
+  display.clearDisplay();
+
+  // Simple icon on the left
+  display.drawCircle(14, 38, 12, WHITE);
+  display.drawCircle(20, 18, 6, WHITE);
+  display.drawCircle(38, 26, 8, WHITE);
+
+  display.drawLine(20, 18, 38, 26, WHITE);
+  display.drawLine(20, 18, 14, 38, WHITE);
+  display.drawLine(14, 38, 38, 26, WHITE);
+
+  // "DAPNET" text on the right
+  display.setTextSize(2);
+  display.setTextColor(WHITE);
+  display.setCursor(52, 20);
+  display.print("DAPNET");
+
+  // Version string below
+  display.setTextSize(1);
+  display.setCursor(52, 38);
+  display.print(FW_VERSION);
+
+  // Battery voltage at the bottom
+#if defined(ESP32)
+  display.setCursor(0, 54);  // bottom line of 64px display
+  display.print(F("Bat: "));
+  display.print(batteryVoltage, 2);
+  display.print(F("V"));
+#endif
+
+  displayFlushAll();
+}
+
+
+
+// -----------------------------------------------------------------------------
+// Button handling
+//
+// Button edges are caught by a GPIO interrupt and queued with their timestamp;
+// loop() debounces them (a button is stable once no edge arrived for
+// DEBOUNCE_MS) and turns them into events. The scheduler timer TIMER_BUTTONS
+// covers the debounce, long-press and repeat deadlines, so nothing is polled.
+//   UP/DOWN: event on press, held → repeated at an accelerating rate
+//   ENTER:   short press on release, held for LONG_PRESS_MS → long press
+// -----------------------------------------------------------------------------
+
+enum ButtonId {
+  BUTTON_UP,
+  BUTTON_ENTER,
+  BUTTON_DOWN,
+  BUTTON_COUNT
+};
+
+struct ButtonState {
   uint8_t       pin;
+  bool          repeats;          // hold-to-repeat (otherwise long press)
   bool          lastStableState;  // HIGH = not pressed (pull-up)
-  unsigned long lastChange;
+  bool          settling;         // edge seen, waiting for the contacts to settle
+  unsigned long lastChange;       // last raw edge
+  unsigned long pressedAt;        // start of the current press
+  unsigned long nextRepeat;       // next repeat event while held
+  uint16_t      repeatCount;      // repeats fired during the current press
+  bool          longFired;        // long press already reported for this press
+};
+
+const unsigned long DEBOUNCE_MS         = 30;
+const unsigned long LONG_PRESS_MS       = 800;
+const unsigned long REPEAT_DELAY_MS     = 400;  // hold time before the first repeat
+const unsigned long REPEAT_START_MS     = 250;  // first repeat interval ...
+const unsigned long REPEAT_MIN_MS       = 50;   // ... shrinking by 1/8 per repeat down to this
+
+ButtonState buttons[BUTTON_COUNT] = {
+  { BTN_UP,    true,  HIGH, false, 0, 0, 0, 0, false },
+  { BTN_ENTER, false, HIGH, false, 0, 0, 0, 0, false },
+  { BTN_DOWN,  true,  HIGH, false, 0, 0, 0, 0, false },
+};
+
+// Edge queue: GPIO interrupt → loop()
+struct ButtonEdge {
+  uint8_t       button;
+  unsigned long millis;
+};
+
+const uint8_t       BUTTON_EDGE_QUEUE_SIZE = 16;  // power of two
+ButtonEdge          buttonEdges[BUTTON_EDGE_QUEUE_SIZE];
+volatile uint8_t    buttonEdgeHead = 0;  // written by the interrupt
+volatile uint8_t    buttonEdgeTail = 0;  // written by loop()
+
+// Level wake-up armed on the pin instead of the edge interrupt (powerArmWakeup())
+volatile bool buttonWakeArmed[BUTTON_COUNT];
+
+void IRAM_ATTR buttonEdgeIsr(void* arg) {
+  uint8_t id = (uint8_t)(uintptr_t)arg;
+
+  // First interrupt of an armed pin: back to edges before the level fires
+  // again (register access only, flash may be off here)
+  if (buttonWakeArmed[id]) {
+    gpio_ll_wakeup_disable(&GPIO, (gpio_num_t)buttons[id].pin);
+    gpio_ll_set_intr_type(&GPIO, (gpio_num_t)buttons[id].pin, GPIO_INTR_ANYEDGE);
+    buttonWakeArmed[id] = false;
+  }
+
+  uint8_t head = buttonEdgeHead;
+  uint8_t next = (head + 1) & (BUTTON_EDGE_QUEUE_SIZE - 1);
+
+  // On overflow the edge is dropped; the debounce still reads the pin level
+  if (next != buttonEdgeTail) {
+    buttonEdges[head].button = id;
+    buttonEdges[head].millis = millis();
+    buttonEdgeHead           = next;
+  }
+
+  schedWakeFromIsr();
+}
+
+// We assume buttons are wired to GND and use the internal pull-up resistors.
+void buttonsInit() {
+  for (int i = 0; i < BUTTON_COUNT; ++i) {
+    pinMode(buttons[i].pin, INPUT_PULLUP);
+    attachInterruptArg(digitalPinToInterrupt(buttons[i].pin), buttonEdgeIsr,
+                       (void*)(uintptr_t)i, CHANGE);
+  }
+}
+
+// Short press (or repeat) of a button in the current mode
+void buttonPressEvent(int id) {
+  if (rxStatsPageActive) {
+    rxStatsPageButton(id);
+  } else if (inboxMenuActive) {
+    // Menü aktiv: Up/Down navigieren, Enter bestätigt
+    if (id == BUTTON_UP)    onMenuUpPressed();
+    if (id == BUTTON_ENTER) onMenuEnterPressed();
+    if (id == BUTTON_DOWN)  onMenuDownPressed();
+  } else {
+    // Normalmodus: Nachrichten blättern / Inbox anzeigen
+    if (id == BUTTON_UP)    onUpPressed();
+    if (id == BUTTON_ENTER) onEnterPressed();
+    if (id == BUTTON_DOWN)  onDownPressed();
+  }
+}
+
+// Button held for LONG_PRESS_MS (only buttons without repeat)
+void buttonLongPressEvent(int id) {
+  if (id != BUTTON_ENTER || rxStatsPageActive) {
+    return;
+  }
+
+  if (inboxMenuActive) {
+    // Hidden: hold ENTER in the inbox menu for the RX statistics
+    inboxMenuActive = false;
+    rxStatsPageOpen();
+  } else {
+    onEnterLongPressed();
+  }
+}
+
+// Stable level change after debouncing
+void buttonStableChange(ButtonState& btn, int id, unsigned long now) {
+  if (btn.lastStableState == LOW) {
+    // Pressed
+    btn.pressedAt   = now;
+    btn.longFired   = false;
+    btn.repeatCount = 0;
+    btn.nextRepeat  = now + REPEAT_DELAY_MS;
+    if (btn.repeats) {
+      buttonPressEvent(id);
+    }
+  } else if (!btn.repeats && !btn.longFired) {
+    // Released before the long-press threshold
+    buttonPressEvent(id);
+  }
+}
+
+void handleButtons() {
+  unsigned long now = millis();
+
+  // Collect the queued edges
+  while (buttonEdgeTail != buttonEdgeHead) {
+    const ButtonEdge& edge = buttonEdges[buttonEdgeTail];
+    ButtonState&      btn  = buttons[edge.button];
+    btn.lastChange         = edge.millis;
+    btn.settling           = true;
+    buttonEdgeTail         = (buttonEdgeTail + 1) & (BUTTON_EDGE_QUEUE_SIZE - 1);
+  }
+
+  for (int id = 0; id < BUTTON_COUNT; ++id) {
+    ButtonState& btn = buttons[id];
+
+    // Debounce: accept the pin level once the contacts stayed quiet
+    if (btn.settling && now - btn.lastChange >= DEBOUNCE_MS) {
+      btn.settling = false;
+      bool level   = digitalRead(btn.pin);
+      if (level != btn.lastStableState) {
+        btn.lastStableState = level;
+        buttonStableChange(btn, id, now);
+      }
+    }
+
+    if (btn.lastStableState != LOW) {
+      continue;
+    }
+
+    // Held: long press or accelerating repeat
+    if (!btn.repeats) {
+      if (!btn.longFired && now - btn.pressedAt >= LONG_PRESS_MS) {
+        btn.longFired = true;
+        buttonLongPressEvent(id);
+      }
+    } else if ((long)(now - btn.nextRepeat) >= 0) {
+      unsigned long interval = REPEAT_START_MS;
+      for (uint16_t i = 0; i < btn.repeatCount && interval > REPEAT_MIN_MS; ++i) {
+        interval -= interval / 8;
+      }
+      btn.repeatCount++;
+      btn.nextRepeat = now + max(interval, REPEAT_MIN_MS);
+      buttonPressEvent(id);
+    }
+  }
+}
+
+// Earliest button deadline (debounce, long press, repeat); false if none
+bool buttonsNextDue(unsigned long& due) {
+  bool any = false;
+
+  for (const ButtonState& btn : buttons) {
+    unsigned long t;
+    if (btn.settling) {
+      t = btn.lastChange + DEBOUNCE_MS;
+    } else if (btn.lastStableState != LOW) {
+      continue;
+    } else if (btn.repeats) {
+      t = btn.nextRepeat;
+    } else if (!btn.longFired) {
+      t = btn.pressedAt + LONG_PRESS_MS;
+    } else {
+      continue;
+    }
+
+    if (!any || (long)(t - due) < 0) {
+      due = t;
+    }
+    any = true;
+  }
+
+  return any;
+}
+
+
+// -----------------------------------------------------------------------------
+// Screen drawing helpers
+// -----------------------------------------------------------------------------
+
+// DAPNET sends German umlauts in the ISO 646-DE positions of ASCII;
+// map them to the code page 437 glyphs of the built-in font
+uint8_t displayGlyph(char c) {
+  switch (c) {
+    case '{':  return 0x84;  // ä
+    case '|':  return 0x94;  // ö
+    case '}':  return 0x81;  // ü
+    case '~':  return 0xE1;  // ß
+    case '[':  return 0x8E;  // Ä
+    case '\\': return 0x99;  // Ö
+    case ']':  return 0x9A;  // Ü
+    default:   return (uint8_t)c;
+  }
+}
+
+// Body lines that fit on screen when the first one is drawn at y
+int textVisibleLines(int y) {
+  return (y <= SCREEN_H - FONT_H) ? (SCREEN_H - FONT_H - y) / FONT_H + 1 : 0;
+}
+
+// Draw the laid-out lines of text starting at firstLine, from y down to the
+// bottom of the screen, with a scroll bar in the free rightmost column
+void drawTextLines(const uint8_t* text, const TextLayout& layout, int firstLine, int y) {
+  int visible = textVisibleLines(y);
+
+  // Only the visible characters are unpacked
+  for (int line = firstLine; line < layout.lineCount && line < firstLine + visible; ++line) {
+    int lineY = y + (line - firstLine) * FONT_H;
+    for (uint8_t i = 0; i < layout.lineLen[line]; ++i) {
+      blitGlyph(i * FONT_W, lineY, displayGlyph(textCharAt(text, layout.lineStart[line] + i)));
+    }
+  }
+
+  if (layout.lineCount > visible) {
+    int track = SCREEN_H - y;
+    int thumb = max(2, track * visible / layout.lineCount);
+    int top   = y + (track - thumb) * firstLine / (layout.lineCount - visible);
+    display.drawFastVLine(SCREEN_W - 1, top, thumb, WHITE);
+  }
+}
+
+// Helper to draw a message including clock bar, header and wrapped text
+void drawMessageScreen(const char* header, int slot) {
+  markDisplayActivity();
+  inboxViewActive   = false;
+  rxStatsPageActive = false;  // a new page replaces the hidden stats page
+
+  if (!displayIsOn) {
+    return;
+  }
+
+  display.clearDisplay();
+  drawClockBar();
+  clearContentArea();
+
+  int y = STATUS_BAR_HEIGHT + 1;
+
+  // Header (RIC name)
+  blitText(0, y, header);
+  y += 10;
+
+  // Message text in TextSize 1 → maximum content per screen
+  drawTextLines(inboxRing.text[slot], inboxLayout[slot], 0, y);
+
+  displayFlushAll();
+}
+
+// Used when a new message is received (slot = where storeMessage() put it)
+void displayPage(const char* address, int slot) {
+  // address = RIC name
+  // We always wake the display for a new message.
+  // The regular power-save timeout will turn it off again.
+  displaySetOn(true);
+  drawMessageScreen(address, slot);
+}
+
+// Does the scroll position belong to the message in the inbox view?
+bool inboxScrollIsCurrent() {
+  if (inboxInHistory) {
+    return inboxScrollSlot == INBOX_SCROLL_HISTORY && inboxScrollSeq == inboxHistorySeq;
+  }
+  return inboxScrollSlot == inboxCurrent;
+}
+
+// Inbox view
+void displayInbox() {
+  // Any display activity resets the power-save timer
+  markDisplayActivity();
+
+  if (!displayIsOn) {
+    return;   // If display is off, do nothing (buttons will wake it)
+  }
+
+  display.clearDisplay();
+  drawClockBar();       // Draw top bar: date/time left, message index right
+  clearContentArea();   // Clear area below the status bar
+
+  int y = STATUS_BAR_HEIGHT + 2;
+
+  // ─────────────────────────────────────────────
+  // Ensure inboxCurrent (or the history page) points to a valid entry
+  // ─────────────────────────────────────────────
+  if (inboxInHistory ? historyFind(inboxHistory, inboxHistorySeq) == nullptr
+                     : inboxCurrent < 0 || inboxCurrent >= INBOX_SIZE || !inboxRing.msg[inboxCurrent].valid) {
+    inboxSelectNewest();
+  }
+
+  // ─────────────────────────────────────────────
+  // If no messages are stored, show a simple text
+  // ─────────────────────────────────────────────
+  if (!inboxInHistory && inboxRing.count == 0) {
+    blitText(0, y, "Inbox empty");
+    displayFlushAll();
+    inboxViewActive = false;
+    return;
+  }
+
+  // History pages are read from flash (or the cache)
+  const HistoryBody* body = inboxInHistory ? historyBody(inboxHistorySeq) : nullptr;
+  if (inboxInHistory && body == nullptr) {
+    blitText(0, y, "Page unreadable");
+    displayFlushAll();
+    inboxViewActive = false;
+    return;
+  }
+
+  const PageMessage& msg    = body ? body->msg : inboxRing.msg[inboxCurrent];
+  const uint8_t*     text   = body ? body->text : inboxRing.text[inboxCurrent];
+  const TextLayout&  layout = body ? body->layout : inboxLayout[inboxCurrent];
+
+  // ─────────────────────────────────────────────
+  // FIRST LINE under the status bar:
+  // Left  : Sender (RIC name)
+  // Right : Battery voltage, right-aligned (e.g. "4.05V")
+  // ─────────────────────────────────────────────
+
+#if defined(ESP32)
+  // Prepare battery voltage string
+  char batBuf[12];
+  snprintf(batBuf, sizeof(batBuf), "%.2fV", batteryVoltage);
+
+  // Right-aligned battery voltage
+  blitTextRight(y, batBuf);
+#endif
+
+  // Sender/ric name on the left side of the same line
+  char senderBuf[12];
+  blitText(0, y, inboxSenderLabel(msg, senderBuf, sizeof(senderBuf)));
+  y += 10;
+
+  // ─────────────────────────────────────────────
+  // SECOND LINE: Timestamp (if valid)
+  // ─────────────────────────────────────────────
+  PagerTime received;
+  unpackPagerTime(msg.time, received);
+  if (received.valid) {
+    char tbuf[20];
+    snprintf(tbuf, sizeof(tbuf), "%02d.%02d.%02d %02d:%02d",
+             received.day,
+             received.month,
+             received.year % 100,
+             received.hour,
+             received.minute);
+
+    blitText(0, y, tbuf);
+    y += 10;
+  }
+
+  // ─────────────────────────────────────────────
+  // MESSAGE BODY: cached word-wrap layout, scrolled by Up/Down
+  // ─────────────────────────────────────────────
+  if (!inboxScrollIsCurrent()) {
+    inboxScrollSlot = inboxInHistory ? INBOX_SCROLL_HISTORY : inboxCurrent;
+    inboxScrollSeq  = inboxHistorySeq;
+    inboxScrollLine = 0;
+  }
+
+  int maxFirst    = max(0, layout.lineCount - textVisibleLines(y));
+  inboxScrollLine = min(inboxScrollLine, maxFirst);
+
+  drawTextLines(text, layout, inboxScrollLine, y);
+
+  displayFlushAll();
+  inboxViewActive = true;
+}
+
+// Body lines of the inbox view for msg (header line, optional timestamp)
+int inboxBodyLines(const PageMessage& msg) {
+  int y = STATUS_BAR_HEIGHT + 2 + 10;
+  if (msg.time != 0) {
+    y += 10;
+  }
+  return textVisibleLines(y);
+}
+
+// Scroll the message in the inbox view by delta lines.
+// Returns false if it is already at that end (or not on screen).
+bool inboxScroll(int delta) {
+  if (!inboxViewActive || !displayIsOn || !inboxScrollIsCurrent()) {
+    return false;
+  }
+
+  const HistoryBody* body = inboxInHistory ? historyBody(inboxHistorySeq) : nullptr;
+  if (inboxInHistory ? body == nullptr : inboxRing.count == 0) {
+    return false;
+  }
+
+  const PageMessage& msg       = body ? body->msg : inboxRing.msg[inboxCurrent];
+  int                lineCount = body ? body->layout.lineCount : inboxLayout[inboxCurrent].lineCount;
+  int                first     = inboxScrollLine + delta;
+  int                last      = lineCount - inboxBodyLines(msg);
+
+  if (first < 0 || first > max(0, last)) {
+    return false;
+  }
+
+  inboxScrollLine = first;
+  displayInbox();
+  return true;
+}
+
+// Show next newer message (wraps around to the oldest one).
+// The newest history page is followed by the oldest RAM message.
+void inboxShowNext() {
+  if (inboxRing.count == 0 && inboxHistory.count == 0) {
+    return;
+  }
+
+  if (inboxInHistory) {
+    if (historyFind(inboxHistory, inboxHistorySeq) == nullptr) {
+      inboxSelectNewest();
+    } else if (inboxHistorySeq + 1 != historyEndSeq(inboxHistory)) {
+      inboxHistorySeq++;
+    } else if (inboxRing.count > 0) {
+      inboxInHistory  = false;
+      inboxCurrent    = inboxRing.order.head;
+      inboxCurrentPos = 1;
+    } else {
+      inboxHistorySeq = inboxHistory.firstSeq;
+    }
+  } else if (!inboxRing.msg[inboxCurrent].valid) {
+    inboxSelectNewest();
+  } else if (inboxRing.next[inboxCurrent] != INBOX_NIL) {
+    inboxCurrent = inboxRing.next[inboxCurrent];
+    inboxCurrentPos++;
+  } else if (inboxHistory.count > 0) {
+    inboxSelectHistory(inboxHistory.firstSeq);
+  } else {
+    inboxCurrent    = inboxRing.order.head;
+    inboxCurrentPos = 1;
+  }
+
+  displayInbox();
+}
+void displayInboxMenu() {
+  markDisplayActivity();
+  inboxViewActive = false;
+
+  if (!displayIsOn) {
+    return;
+  }
+
+  display.clearDisplay();
+  drawClockBar();
+  clearContentArea();
+
+  int y = STATUS_BAR_HEIGHT + 4;
+
+  blitText(0, y, "Inbox Menu");
+  y += 10;
+
+  for (int i = 0; i < INBOX_MENU_ITEM_COUNT; ++i) {
+    if (i == inboxMenuIndex) {
+      blitGlyph(0, y, '>');   // Markierung für die aktuelle Auswahl
+    }
+    blitText(textWidth("> "), y, INBOX_MENU_ITEMS[i]);
+    y += 10;
+  }
+
+  displayFlushAll();
+}
+
+// Show older message (wraps around to the newest one).
+// The oldest RAM message is followed by the newest history page.
+void inboxShowPrev() {
+  if (inboxRing.count == 0 && inboxHistory.count == 0) {
+    return;
+  }
+
+  if (inboxInHistory) {
+    if (historyFind(inboxHistory, inboxHistorySeq) != nullptr && inboxHistorySeq != inboxHistory.firstSeq) {
+      inboxHistorySeq--;
+    } else {
+      inboxSelectNewest();
+    }
+  } else if (!inboxRing.msg[inboxCurrent].valid) {
+    inboxSelectNewest();
+  } else if (inboxRing.prev[inboxCurrent] != INBOX_NIL) {
+    inboxCurrent = inboxRing.prev[inboxCurrent];
+    inboxCurrentPos--;
+  } else if (inboxHistory.count > 0) {
+    inboxSelectHistory(historyEndSeq(inboxHistory) - 1);
+  } else {
+    inboxSelectNewest();
+  }
+
+  displayInbox();
+}
+
+// -----------------------------------------------------------------------------
+// Buzzer and LED notification (esp_timer driven)
+//
+// Each ringtone's melody and LED blink pattern is built once into a step list
+// (notify_player.h), the reminder pulse is a looping one. An esp_timer plays
+// them: its callback puts one step out on the LEDC buzzer channel and the LED
+// pin and arms itself for the step's duration. loop() only starts a ring or
+// switches the reminder, so its stalls no longer stretch tones or blinks and
+// it needs no notification timers. A PM lock keeps light sleep (which stops
+// the LEDC clock) away while a tone sounds; rests and reminder waits sleep.
+// -----------------------------------------------------------------------------
+
+void notifyOutput(const NotifyStep* step) {
+  uint16_t freq = step ? step->freqHz : 0;
+  if (freq != notifyFreqHz) {
+#if CONFIG_PM_ENABLE
+    if (notifyPmLock && notifyFreqHz == 0) {
+      esp_pm_lock_acquire(notifyPmLock);
+    } else if (notifyPmLock && freq == 0) {
+      esp_pm_lock_release(notifyPmLock);
+    }
+#endif
+    ledcWriteTone(NOTIFY_LEDC_CHANNEL, freq);
+    notifyFreqHz = freq;
+  }
+  digitalWrite(LED, step && step->led ? HIGH : LOW);
+}
+
+// esp_timer task: next step, or everything off
+void notifyTimerCallback(void* arg) {
+  (void)arg;
+  PROFILE_SCOPE(PROF_NOTIFY);
+
+  NotifyStep step;
+  portENTER_CRITICAL(&notifyMux);
+  bool playing = notifyPlayerNext(notifyPlayer, step);
+  portEXIT_CRITICAL(&notifyMux);
+
+  notifyOutput(playing ? &step : nullptr);
+  if (playing) {
+    esp_timer_start_once(notifyTimer, (uint64_t)step.ms * 1000ULL);
+  }
+}
+
+// The player was changed: cut the running step short. Should the callback be
+// running right now, it either finds the new state or its own restart fails
+// because this one is armed.
+void notifyKick() {
+  esp_timer_stop(notifyTimer);
+  esp_timer_start_once(notifyTimer, 0);
+}
+
+void notifyInit() {
+  for (int i = 0; i < RINGTONE; ++i) {
+    notifyBuildRing(notifyRings[i], beepTones[i], NOTENUMBER, NOTIFY_STEP_MS, NOTIFY_LED_STEPS);
+  }
+  notifyBuildReminder(notifyReminderPattern, REMINDER_INTERVAL_MS, REMINDER_PULSE_MS);
+  notifyPlayerReset(notifyPlayer);
+
+  ledcSetup(NOTIFY_LEDC_CHANNEL, 2000, 10);
+  ledcAttachPin(BUZZER, NOTIFY_LEDC_CHANNEL);
+  ledcWrite(NOTIFY_LEDC_CHANNEL, 0);
+
+#if CONFIG_PM_ENABLE
+  esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "notify", &notifyPmLock);
+#endif
+
+  esp_timer_create_args_t args = {};
+  args.callback                = notifyTimerCallback;
+  args.dispatch_method         = ESP_TIMER_TASK;
+  args.name                    = "notify";
+  esp_timer_create(&args, &notifyTimer);
+}
+
+void ringBuzzer(int ringToneChoice, uint8_t priority) {
+  PROFILE_SCOPE(PROF_RING);
+  if (priority == RIC_PRIORITY_SILENT || ringToneChoice < 0 || ringToneChoice >= RINGTONE) {
+    return;
+  }
+
+  // A lower priority page does not cut a running notification short
+  portENTER_CRITICAL(&notifyMux);
+  bool started = notifyPlayerRing(notifyPlayer, &notifyRings[ringToneChoice], priority);
+  portEXIT_CRITICAL(&notifyMux);
+
+  if (started) {
+    notifyKick();
+  }
+}
+
+// New message reminder (LED pulse every 30s until acknowledged): hand
+// newMessagePending to the player once it has changed. While a ring plays the
+// reminder waits; it starts its 30 s over when the ring ends.
+void notifyReminderSync() {
+  if (newMessagePending == notifyReminderOn) {
+    return;
+  }
+  notifyReminderOn = newMessagePending;
+
+  portENTER_CRITICAL(&notifyMux);
+  notifyPlayerReminder(notifyPlayer, notifyReminderOn ? &notifyReminderPattern : nullptr);
+  bool ringing = notifyPlayerRinging(notifyPlayer);
+  portEXIT_CRITICAL(&notifyMux);
+
+  if (!ringing) {
+    notifyKick();  // start the wait, or switch a pulse off at once
+  }
+}
+
+void printNotifyStats() {
+  portENTER_CRITICAL(&notifyMux);
+  NotifyPlayer n = notifyPlayer;
+  portEXIT_CRITICAL(&notifyMux);
+
+  Serial.print(F("[Notify] rings="));
+  Serial.print(n.rings);
+  Serial.print(F(" preempted="));
+  Serial.print(n.preempted);
+  Serial.print(F(" refused="));
+  Serial.print(n.refused);
+  Serial.print(F(" reminder="));
+  Serial.println(n.reminder ? F("on") : F("off"));
+}
+
+// -----------------------------------------------------------------------------
+// Button event handlers
+// -----------------------------------------------------------------------------
+
+void onUpPressed() {
+  // Any key press acknowledges pending messages
+  newMessagePending = false;
+
+  // Scroll up inside the message, at its top one message "up" (older message)
+  if (inboxScroll(-1)) {
+    markDisplayActivity();
+    return;
+  }
+  markDisplayActivity();
+  inboxShowPrev();
+}
+
+void onDownPressed() {
+  newMessagePending = false;
+
+  // Scroll down inside the message, at its end one message "down" (newer message)
+  if (inboxScroll(1)) {
+    markDisplayActivity();
+    return;
+  }
+  markDisplayActivity();
+  inboxShowNext();
+}
+void onMenuUpPressed() {
+  newMessagePending = false;
+  markDisplayActivity();
+
+  if (!inboxMenuActive) return;
+
+  inboxMenuIndex--;
+  if (inboxMenuIndex < 0) {
+    inboxMenuIndex = INBOX_MENU_ITEM_COUNT - 1;
+  }
+  displayInboxMenu();
+}
+
+void onMenuDownPressed() {
+  newMessagePending = false;
+  markDisplayActivity();
+
+  if (!inboxMenuActive) return;
+
+  inboxMenuIndex++;
+  if (inboxMenuIndex >= INBOX_MENU_ITEM_COUNT) {
+    inboxMenuIndex = 0;
+  }
+  displayInboxMenu();
+}
+
+void onMenuEnterPressed() {
+  newMessagePending = false;
+  markDisplayActivity();
+
+  if (!inboxMenuActive) return;
+
+  switch (inboxMenuIndex) {
+    case 0: // Del Msg
+      deleteCurrentMessage();
+      inboxMenuActive = false;
+      displayInbox();
+      break;
+
+    case 1: // Del All
+      deleteAllMessages();
+      inboxMenuActive = false;
+      displayInbox();
+      break;
+
+    case 2: // Cancel
+    default:
+      inboxMenuActive = false;
+      displayInbox();
+      break;
+  }
+}
+
+void onEnterPressed() {
+  // Jede Taste quittiert das Reminder-Blinken
+  newMessagePending = false;
+  markDisplayActivity();
+
+  // Kurzer Druck: Inbox anzeigen (weckt auch das Display)
+  displayInbox();
+}
+
+void onEnterLongPressed() {
+  newMessagePending = false;
+  markDisplayActivity();
+
+  // Wenn keine Nachrichten vorhanden sind, macht ein Lösch-Menü keinen Sinn
+  if (inboxRing.count == 0 && inboxHistory.count == 0) {
+    displayInbox();
+    return;
+  }
+
+  // Inbox-Menü öffnen
+  inboxMenuActive = true;
+  inboxMenuIndex  = 0;
+  displayInboxMenu();
+}
+
+// -----------------------------------------------------------------------------
+// Event scheduler & power management
+//
+// loop() no longer spins: after each pass it arms one timer per pending piece
+// of timed work and blocks on a task notification until the earliest of them
+// is due, a button edge arrives (GPIO interrupt) or the radio task queued a page.
+// While every task is blocked, the idle task lets the chip enter light sleep;
+// buttons and DIO2 are configured as light-sleep wake-up sources.
+// -----------------------------------------------------------------------------
+enum SchedTimer {
+  TIMER_CLOCK_BAR,  // status bar refresh
+  TIMER_DISPLAY,    // display power-save timeout
+  TIMER_BUTTONS,    // debounce, long press, repeat
+  TIMER_BATTERY,    // next battery sample
+  TIMER_STATS,      // RX statistics minute tick / save
+  TIMER_CONSOLE,    // inbox export waiting for TX buffer space
+  TIMER_COUNT
 };
 
-const unsigned long DEBOUNCE_MS = 30;
+struct SchedTimerSlot {
+  bool          armed;
+  unsigned long due;  // millis()
+};
 
-ButtonState btnUp    = { BTN_UP,    HIGH, 0 };
-ButtonState btnEnter = { BTN_ENTER, HIGH, 0 };
-ButtonState btnDown  = { BTN_DOWN,  HIGH, 0 };
+SchedTimerSlot schedTimers[TIMER_COUNT];
+TaskHandle_t   loopTaskHandle = nullptr;
 
-void processButton(ButtonState &btn, void (*onPress)()) {
-  bool          raw = digitalRead(btn.pin);
-  unsigned long now = millis();
+void schedAt(SchedTimer t, unsigned long due) {
+  schedTimers[t].armed = true;
+  schedTimers[t].due   = due;
+}
 
-  if (raw != btn.lastStableState && (now - btn.lastChange) > DEBOUNCE_MS) {
-    btn.lastChange      = now;
-    btn.lastStableState = raw;
+void schedCancel(SchedTimer t) {
+  schedTimers[t].armed = false;
+}
 
-    // FALLING edge: HIGH -> LOW => button pressed
-    if (raw == LOW) {
-      onPress();
-    }
+// Wake loop() from another task
+void schedWakeLoop() {
+  if (loopTaskHandle) {
+    xTaskNotifyGive(loopTaskHandle);
   }
 }
 
-void handleButtons() {
-  if (inboxMenuActive) {
-    // Menü aktiv: Up/Down navigieren, Enter bestätigt
-    processButton(btnUp,    onMenuUpPressed);
-    processButton(btnEnter, onMenuEnterPressed);
-    processButton(btnDown,  onMenuDownPressed);
+// Wake loop() from an interrupt (button edges)
+void IRAM_ATTR schedWakeFromIsr() {
+  BaseType_t woken = pdFALSE;
+  if (loopTaskHandle) {
+    vTaskNotifyGiveFromISR(loopTaskHandle, &woken);
+  }
+  if (woken) {
+    portYIELD_FROM_ISR();
+  }
+}
+
+// Derive the timers from the current state (called at the end of each pass)
+void schedArmTimers() {
+  if (pagerClock.valid && displayIsOn) {
+    schedAt(TIMER_CLOCK_BAR, lastClockDrawMillis + 1001);
   } else {
-    // Normalmodus: Nachrichten blättern / Inbox anzeigen
-    processButton(btnUp,    onUpPressed);
-    processButton(btnEnter, onEnterPressed);
-    processButton(btnDown,  onDownPressed);
+    schedCancel(TIMER_CLOCK_BAR);
+  }
+
+  if (displayIsOn && displayTimeoutSeconds > 0) {
+    schedAt(TIMER_DISPLAY, displayLastActiveMillis + (unsigned long)displayTimeoutSeconds * 1000UL + 1);
+  } else {
+    schedCancel(TIMER_DISPLAY);
+  }
+
+  schedAt(TIMER_STATS, rxStatsNextDue());
+
+  unsigned long consoleDue;
+  if (consoleNextDue(consoleDue)) {
+    schedAt(TIMER_CONSOLE, consoleDue);
+  } else {
+    schedCancel(TIMER_CONSOLE);
+  }
+
+#if defined(ESP32)
+  schedAt(TIMER_BATTERY, batteryLastSampleMillis + batterySampleInterval());
+#endif
+
+  // Debounce settling, long press and repeat while a button is held
+  // (not before the inbox is restored: the edges wait, the restore wakes us)
+  unsigned long buttonsDue;
+  if (inboxReady && buttonsNextDue(buttonsDue)) {
+    schedAt(TIMER_BUTTONS, buttonsDue);
+  } else {
+    schedCancel(TIMER_BUTTONS);
+  }
+}
+
+// Block until the earliest timer is due or an event arrives
+void schedWaitForEvent() {
+  unsigned long now  = millis();
+  unsigned long wait = SCHED_MAX_SLEEP_MS;
+
+  for (int i = 0; i < TIMER_COUNT; ++i) {
+    if (!schedTimers[i].armed) {
+      continue;
+    }
+    long left = (long)(schedTimers[i].due - now);
+    if (left <= 0) {
+      return;  // already due
+    }
+    if ((unsigned long)left < wait) {
+      wait = (unsigned long)left;
+    }
+  }
+
+  powerArmWakeup();
+  ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(wait));
+  powerDisarmWakeup();
+}
+
+// Light sleep only wakes on GPIO levels, and a pin has one interrupt type:
+// the buttons' edge interrupts are switched to low level (pressed) only
+// while loop() blocks. A button already held stays on edges, its debounce
+// and repeat timers keep loop() awake anyway. An armed pin that goes low
+// puts itself back to edges in buttonEdgeIsr().
+void powerArmWakeup() {
+#if CONFIG_PM_ENABLE
+  for (int i = 0; i < BUTTON_COUNT; ++i) {
+    if (digitalRead(buttons[i].pin) == HIGH) {
+      buttonWakeArmed[i] = true;
+      gpio_wakeup_enable((gpio_num_t)buttons[i].pin, GPIO_INTR_LOW_LEVEL);
+    }
+  }
+#endif
+}
+
+void powerDisarmWakeup() {
+#if CONFIG_PM_ENABLE
+  for (int i = 0; i < BUTTON_COUNT; ++i) {
+    // Same steps as the interrupt's, so it does not matter who is first
+    if (buttonWakeArmed[i]) {
+      gpio_wakeup_disable((gpio_num_t)buttons[i].pin);
+      gpio_set_intr_type((gpio_num_t)buttons[i].pin, GPIO_INTR_ANYEDGE);
+      buttonWakeArmed[i] = false;
+    }
   }
+#endif
 }
 
+// Wake-up sources and automatic light sleep
+void powerInit() {
+  loopTaskHandle = xTaskGetCurrentTaskHandle();
+
+#if CONFIG_PM_ENABLE
+  // Buttons wake through powerArmWakeup(). DIO2 is no wake source: in direct
+  // mode it toggles on noise; the radio task's own timer ends a duty-cycle
+  // sleep.
+  esp_sleep_enable_gpio_wakeup();
+
+  // Continuous RX clocks bits in through DIO1 interrupts, which light sleep
+  // would miss: the receiver keeps this lock while it is listening
+  esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "radio", &radioPmLock);
+  esp_pm_lock_acquire(radioPmLock);
+
+  esp_pm_config_esp32_t pm;
+  pm.max_freq_mhz       = 80;
+  pm.min_freq_mhz       = 80;  // no DFS, UART and I2C clocks stay put
+  pm.light_sleep_enable = LIGHT_SLEEP_ENABLE;
+
+  esp_err_t err = esp_pm_configure(&pm);
+  Serial.print(F("[PM] Light sleep "));
+  Serial.println(err == ESP_OK ? F("enabled") : F("not available in this build"));
+#endif
+}
 
 // -----------------------------------------------------------------------------
-// Screen drawing helpers
+// RX statistics
+//
+// Rolling rates come from one-minute snapshots of the monotonic counters over
+// the last hour. Totals are saved to LittleFS by the persistence task every
+// RX_STATS_SAVE_MS (and with the low-battery flush), viewable over serial and
+// on a hidden OLED page (inbox menu open → hold ENTER; UP/DOWN page, ENTER
+// closes).
 // -----------------------------------------------------------------------------
+const char*    RX_STATS_PATH     = "/rxstats.bin";
+const char*    RX_STATS_TMP_PATH = "/rxstats.tmp";
+const uint8_t  RX_STATS_VERSION  = 5;
+const int      RX_RATE_MINUTES   = 60;
+
+// Per-minute deltas of decoded/failed pages for the rolling rates
+struct RxRateWindow {
+  uint16_t      decoded[RX_RATE_MINUTES];
+  uint16_t      failed[RX_RATE_MINUTES];
+  uint8_t       next;
+  uint8_t       filled;
+  uint32_t      lastDecoded;
+  uint32_t      lastFailed;
+  unsigned long lastTickMillis;
+  unsigned long lastSaveMillis;
+};
 
-// Helper to draw a message including clock bar, header and wrapped text
-void drawMessageScreen(const String &header, const String &text) {
-  markDisplayActivity();
+RxRateWindow rxRates = {};
 
-  if (!displayIsOn) {
+// Add one fail code table into another (codes that do not fit count as "other")
+void rxStatsMergeFailures(RxStatsCounters& total, const RxStatsCounters& add) {
+  for (const RxFailCode& a : add.fail) {
+    if (a.count == 0) {
+      continue;
+    }
+    bool merged = false;
+    for (RxFailCode& t : total.fail) {
+      if (t.count == 0) {
+        t.code = a.code;
+      }
+      if (t.code == a.code) {
+        t.count += a.count;
+        merged   = true;
+        break;
+      }
+    }
+    if (!merged) {
+      total.n[RX_STAT_FAIL_OTHER] += a.count;
+    }
+  }
+}
+
+// Add one RIC count table into another. When it is full, an entry that is no
+// longer subscribed makes room; with none of those the counts are dropped.
+void rxStatsMergeRics(RxStatsCounters& total, const RxStatsCounters& add) {
+  const RicTable& rics = ricTable();
+
+  for (const RxRicCount& a : add.ricPages) {
+    uint32_t count = a.count;  // count before key, see rxStatsCountRic()
+    if (count == 0) {
+      continue;
+    }
+
+    RxRicCount* slot  = nullptr;
+    RxRicCount* stale = nullptr;
+    for (RxRicCount& t : total.ricPages) {
+      if (t.count == 0 || (t.addr == a.addr && t.function == a.function)) {
+        slot = &t;
+        break;
+      }
+      if (stale == nullptr && ricTableFindExact(rics, t.addr, t.function) == RIC_NOT_FOUND) {
+        stale = &t;
+      }
+    }
+    if (slot == nullptr && stale != nullptr) {
+      slot        = stale;
+      slot->count = 0;
+    }
+    if (slot != nullptr) {
+      slot->addr      = a.addr;
+      slot->function  = a.function;
+      slot->count    += count;
+    }
+  }
+}
+
+// Totals over all boots: persisted base + this session
+void rxStatsTotals(RxStatsCounters& total) {
+  rxStats.backlogMax   = rxDrainStats.backlogMax.load(std::memory_order_relaxed);
+  rxStats.queueDropped = rxQueueDropped.load(std::memory_order_relaxed);
+
+  total = rxStatsBase;
+  for (int i = 0; i < RX_STAT_COUNT; ++i) {
+    total.n[i] += rxStats.n[i];
+  }
+  rxStatsMergeRics(total, rxStats);
+  rxStatsMergeFailures(total, rxStats);
+  total.backlogMax    = max(total.backlogMax, rxStats.backlogMax);
+  total.queueDropped += rxStats.queueDropped;
+}
+
+// Pages decoded / failed during the last hour (or since boot, if shorter)
+void rxStatsLastHour(uint32_t& decoded, uint32_t& failed) {
+  decoded = rxStats.n[RX_STAT_DECODED] - rxRates.lastDecoded;  // current minute
+  failed  = rxStats.n[RX_STAT_FAILED] - rxRates.lastFailed;
+  for (int i = 0; i < rxRates.filled; ++i) {
+    decoded += rxRates.decoded[i];
+    failed  += rxRates.failed[i];
+  }
+}
+
+// Restore the totals of earlier boots (after LittleFS is mounted)
+void rxStatsLoad() {
+  // A rewrite interrupted after the old file was removed
+  if (!LittleFS.exists(RX_STATS_PATH) && LittleFS.exists(RX_STATS_TMP_PATH)) {
+    LittleFS.rename(RX_STATS_TMP_PATH, RX_STATS_PATH);
+  }
+
+  File f = LittleFS.open(RX_STATS_PATH, FILE_READ);
+  if (!f) {
     return;
   }
 
-  display.clearDisplay();
-  drawClockBar();
-  clearContentArea();
+  uint8_t         hdr[6];
+  RxStatsCounters saved;
+  uint8_t         crcBuf[4];
 
-  display.setTextColor(WHITE);
+  bool ok = f.read(hdr, sizeof(hdr)) == sizeof(hdr) &&
+            hdr[0] == 'R' && hdr[1] == 'X' && hdr[2] == 'S' && hdr[3] == RX_STATS_VERSION &&
+            getLe16(hdr + 4) == sizeof(saved) &&
+            f.read((uint8_t*)&saved, sizeof(saved)) == sizeof(saved) &&
+            f.read(crcBuf, sizeof(crcBuf)) == sizeof(crcBuf) &&
+            getLe32(crcBuf) == crc32Update(0, (const uint8_t*)&saved, sizeof(saved));
+  f.close();
 
-  int y = STATUS_BAR_HEIGHT + 1;
+  if (!ok) {
+    // Other build (RICNUMBER, layout) or damaged: start counting from zero
+    Serial.println(F("[Stats] Saved statistics not usable, starting fresh"));
+    return;
+  }
 
-  // Header (RIC name)
-  display.setTextSize(1);
-  display.setCursor(0, y);
-  display.print(header);
-  y += 10;
+  rxStatsBase = saved;
+  Serial.print(F("[Stats] Restored, boots="));
+  Serial.println(rxStatsBase.n[RX_STAT_BOOTS] + rxStats.n[RX_STAT_BOOTS]);
+}
 
-  // Message text in TextSize 1 → maximum content per screen
-  const int maxCharsPerLine = 21;  // ~128px / 6px per character
-  int       len             = text.length();
-  int       pos             = 0;
+// Write the totals to RX_STATS_TMP_PATH and swap it in, so a write torn by a
+// brown-out (the low-battery flush) keeps the previous totals. Caller holds
+// persistMutex.
+void rxStatsSave() {
+  rxStatsSavePending = false;
+  if (!storageOk) {
+    return;
+  }
 
-  while (pos < len && y <= SCREEN_H - 8) {
-    int    remaining = len - pos;
-    int    lineLen   = (remaining > maxCharsPerLine) ? maxCharsPerLine : remaining;
-    String line      = text.substring(pos, pos + lineLen);
+  RxStatsCounters total;
+  rxStats.n[RX_STAT_FLASH_WRITES]++;  // count this write as well
+  rxStatsTotals(total);
 
-    display.setCursor(0, y);
-    display.print(line);
+  uint8_t hdr[6] = { 'R', 'X', 'S', RX_STATS_VERSION, 0, 0 };
+  uint8_t crcBuf[4];
+  putLe16(hdr + 4, sizeof(total));
+  putLe32(crcBuf, crc32Update(0, (const uint8_t*)&total, sizeof(total)));
 
-    y += 8;  // TextSize-1 line height
-    pos += lineLen;
+  File f = LittleFS.open(RX_STATS_TMP_PATH, FILE_WRITE);
+  if (!f) {
+    Serial.println(F("[Stats] Failed to open statistics file"));
+    return;
+  }
+  bool ok = f.write(hdr, sizeof(hdr)) == sizeof(hdr) &&
+            f.write((const uint8_t*)&total, sizeof(total)) == sizeof(total) &&
+            f.write(crcBuf, sizeof(crcBuf)) == sizeof(crcBuf);
+  f.close();
+  if (!ok) {
+    Serial.println(F("[Stats] Failed to write statistics file"));
+    LittleFS.remove(RX_STATS_TMP_PATH);
+    return;
   }
 
-  display.display();
+  LittleFS.remove(RX_STATS_PATH);
+  if (!LittleFS.rename(RX_STATS_TMP_PATH, RX_STATS_PATH)) {
+    Serial.println(F("[Stats] Failed to replace statistics file"));
+  }
 }
 
-// Used when a new message is received
-void displayPage(const String &address, const String &text) {
-  // address = RIC name
-  // We always wake the display for a new message.
-  // The regular power-save timeout will turn it off again.
-  displaySetOn(true);
-  drawMessageScreen(address, text);
+// Text of one statistics line; pages of RX_STATS_PAGE_LINES lines.
+// Returns false past the last line of the page.
+const int RX_STATS_PAGES      = 5;
+const int RX_STATS_PAGE_LINES = 5;
+const char* const RX_STATS_PAGE_TITLES[RX_STATS_PAGES] = { "RX", "Link", "Storage", "RICs", "FEC" };
+
+bool rxStatsLine(const RxStatsCounters& t, int page, int line, char* buf, size_t len) {
+  uint32_t hourDecoded, hourFailed;
+  rxStatsLastHour(hourDecoded, hourFailed);
+
+  switch (page * RX_STATS_PAGE_LINES + line) {
+    case 0: snprintf(buf, len, "Decoded  %lu", (unsigned long)t.n[RX_STAT_DECODED]); return true;
+    case 1: snprintf(buf, len, "Failed   %lu", (unsigned long)t.n[RX_STAT_FAILED]); return true;
+    case 2: snprintf(buf, len, "1h pages %lu", (unsigned long)hourDecoded); return true;
+    case 3:
+      snprintf(buf, len, "1h fail  %lu.%lu%%",
+               (unsigned long)(hourFailed * 100 / max<uint32_t>(hourDecoded + hourFailed, 1)),
+               (unsigned long)(hourFailed * 1000 / max<uint32_t>(hourDecoded + hourFailed, 1) % 10));
+      return true;
+    case 4: snprintf(buf, len, "Beacons  %lu", (unsigned long)t.n[RX_STAT_TIME_BEACONS]); return true;
+
+    case 5: snprintf(buf, len, "Batches  %lu", (unsigned long)t.n[RX_STAT_BATCHES]); return true;
+    case 6:
+      snprintf(buf, len, "Idle     %lu%%",
+               (unsigned long)(t.n[RX_STAT_IDLE_BATCHES] * 100ULL / max<uint32_t>(t.n[RX_STAT_BATCHES], 1)));
+      return true;
+    case 7: snprintf(buf, len, "Syncs    %lu", (unsigned long)t.n[RX_STAT_SYNCS]); return true;
+    case 8: snprintf(buf, len, "SyncLost %lu", (unsigned long)t.n[RX_STAT_SYNC_LOSSES]); return true;
+    case 9: snprintf(buf, len, "Boots    %lu", (unsigned long)t.n[RX_STAT_BOOTS]); return true;
+
+    case 10: snprintf(buf, len, "Stored   %luB", (unsigned long)t.n[RX_STAT_BYTES_STORED]); return true;
+    case 11: snprintf(buf, len, "FlashWr  %lu", (unsigned long)t.n[RX_STAT_FLASH_WRITES]); return true;
+    case 12: snprintf(buf, len, "Dropped  %lu", (unsigned long)t.queueDropped); return true;
+    case 13: snprintf(buf, len, "Backlog  %lu", (unsigned long)t.backlogMax); return true;
+    case 14: {
+      // Error codes, most of them fit on one line
+      int pos = snprintf(buf, len, "Err");
+      for (const RxFailCode& f : t.fail) {
+        if (f.count != 0 && pos < (int)len) {
+          pos += snprintf(buf + pos, len - pos, " %ld:%lu", (long)f.code, (unsigned long)f.count);
+        }
+      }
+      if (t.n[RX_STAT_FAIL_OTHER] != 0 && pos < (int)len) {
+        snprintf(buf + pos, len - pos, " ?:%lu", (unsigned long)t.n[RX_STAT_FAIL_OTHER]);
+      }
+      return true;
+    }
+
+    case 20: snprintf(buf, len, "FixWords %lu", (unsigned long)t.n[RX_STAT_FEC_WORDS]); return true;
+    case 21: snprintf(buf, len, "FixBits  %lu", (unsigned long)t.n[RX_STAT_FEC_BITS]); return true;
+    case 22: snprintf(buf, len, "Uncorr   %lu", (unsigned long)t.n[RX_STAT_FEC_FAILED]); return true;
+    case 23: snprintf(buf, len, "FixSyncs %lu", (unsigned long)t.n[RX_STAT_FEC_SYNCS]); return true;
+    case 24:
+      snprintf(buf, len, "Fixed    %lu.%lu%%",
+               (unsigned long)(t.n[RX_STAT_FEC_WORDS] * 100ULL / max<uint32_t>(t.n[RX_STAT_BATCHES] * 16, 1)),
+               (unsigned long)(t.n[RX_STAT_FEC_WORDS] * 1000ULL / max<uint32_t>(t.n[RX_STAT_BATCHES] * 16, 1) % 10));
+      return true;
+
+    default:
+      break;
+  }
+
+  // RICs page: other traffic and duplicates, then the first table entries
+  if (page == 3) {
+    const RicTable& rics = ricTable();
+    if (line == 0) {
+      snprintf(buf, len, "Other    %lu", (unsigned long)t.n[RX_STAT_UNSUBSCRIBED]);
+      return true;
+    }
+    if (line == 1) {
+      snprintf(buf, len, "Dupes    %lu", (unsigned long)t.n[RX_STAT_DUPLICATES]);
+      return true;
+    }
+    int i = line - 2;
+    if (i < rics.count) {
+      const RicEntry& e = rics.entries[i];
+      snprintf(buf, len, "%-9.9s%lu", e.name, (unsigned long)rxStatsRicPages(t, e.addr, e.function));
+      return true;
+    }
+  }
+  return false;
 }
 
-// Inbox view
-void displayInbox() {
-  // Any display activity resets the power-save timer
+// Everything over serial
+void printRxStats() {
+  RxStatsCounters total;
+  rxStatsTotals(total);
+
+  char buf[40];
+  for (int page = 0; page < RX_STATS_PAGES; ++page) {
+    Serial.print(F("[Stats] "));
+    Serial.print(RX_STATS_PAGE_TITLES[page]);
+    Serial.print(':');
+    for (int line = 0; line < RX_STATS_PAGE_LINES; ++line) {
+      if (rxStatsLine(total, page, line, buf, sizeof(buf))) {
+        Serial.print(F(" | "));
+        Serial.print(buf);
+      }
+    }
+    Serial.println();
+  }
+}
+
+// Minute bookkeeping for the rolling rates and the periodic save (loop())
+void rxStatsTick() {
+  unsigned long now = millis();
+
+  if (now - rxRates.lastTickMillis >= 60000UL) {
+    rxRates.lastTickMillis += 60000UL;
+
+    uint32_t decoded = rxStats.n[RX_STAT_DECODED];
+    uint32_t failed  = rxStats.n[RX_STAT_FAILED];
+    rxRates.decoded[rxRates.next] = (uint16_t)min<uint32_t>(decoded - rxRates.lastDecoded, 0xFFFF);
+    rxRates.failed[rxRates.next]  = (uint16_t)min<uint32_t>(failed - rxRates.lastFailed, 0xFFFF);
+    rxRates.lastDecoded = decoded;
+    rxRates.lastFailed  = failed;
+    rxRates.next        = (rxRates.next + 1) % (RX_RATE_MINUTES - 1);  // + current minute = 1h
+    if (rxRates.filled < RX_RATE_MINUTES - 1) {
+      rxRates.filled++;
+    }
+  }
+
+  if (now - rxRates.lastSaveMillis >= RX_STATS_SAVE_MS) {
+    rxRates.lastSaveMillis = now;
+    rxStatsSavePending     = true;
+    persistNotify();
+    printRxStats();
+  }
+}
+
+// Next rxStatsTick() deadline for the scheduler
+unsigned long rxStatsNextDue() {
+  unsigned long rate = rxRates.lastTickMillis + 60000UL;
+  unsigned long save = rxRates.lastSaveMillis + RX_STATS_SAVE_MS;
+  return ((long)(rate - save) < 0) ? rate : save;
+}
+
+// Hidden status page
+bool rxStatsPageActive = false;
+int  rxStatsPage       = 0;
+
+void displayRxStatsPage() {
   markDisplayActivity();
+  inboxViewActive = false;
 
   if (!displayIsOn) {
-    return;   // If display is off, do nothing (buttons will wake it)
+    return;
   }
 
   display.clearDisplay();
-  drawClockBar();       // Draw top bar: date/time left, message index right
-  clearContentArea();   // Clear area below the status bar
+  drawClockBar();
+  clearContentArea();
 
-  display.setTextColor(WHITE);
-  display.setTextSize(1);
+  RxStatsCounters total;
+  rxStatsTotals(total);
 
-  int y = STATUS_BAR_HEIGHT + 2;
+  char buf[24];
+  int  y = STATUS_BAR_HEIGHT + 2;
 
-  // ─────────────────────────────────────────────
-  // If no messages are stored, show a simple text
-  // ─────────────────────────────────────────────
-  if (inboxCount == 0) {
-    display.setCursor(0, y);
-    display.print(F("Inbox empty"));
-    display.display();
-    return;
-  }
+  snprintf(buf, sizeof(buf), "Stats %s %d/%d", RX_STATS_PAGE_TITLES[rxStatsPage],
+           rxStatsPage + 1, RX_STATS_PAGES);
+  blitText(0, y, buf);
+  y += 10;
 
-  // ─────────────────────────────────────────────
-  // Ensure inboxCurrent points to a valid entry
-  // ─────────────────────────────────────────────
-  if (inboxCurrent < 0 || inboxCurrent >= INBOX_SIZE || !inbox[inboxCurrent].valid) {
-    for (int i = INBOX_SIZE - 1; i >= 0; --i) {
-      if (inbox[i].valid) {
-        inboxCurrent = i;
-        break;
-      }
+  for (int line = 0; line < RX_STATS_PAGE_LINES; ++line, y += FONT_H) {
+    if (rxStatsLine(total, rxStatsPage, line, buf, sizeof(buf))) {
+      blitText(0, y, buf);
     }
   }
 
-  PageMessage &msg = inbox[inboxCurrent];
+  displayFlushAll();
+}
 
-  // ─────────────────────────────────────────────
-  // FIRST LINE under the status bar:
-  // Left  : Sender (RIC name)
-  // Right : Battery voltage, right-aligned (e.g. "4.05V")
-  // ─────────────────────────────────────────────
+void rxStatsPageOpen() {
+  rxStatsPageActive = true;
+  rxStatsPage       = 0;
+  displayRxStatsPage();
+}
 
-#if defined(ESP32)
-  // Prepare battery voltage string
-  char batBuf[12];
-  snprintf(batBuf, sizeof(batBuf), "%.2fV", batteryVoltage);
+// Button on the stats page: UP/DOWN page through, ENTER back to the inbox
+void rxStatsPageButton(int id) {
+  if (id == BUTTON_UP) {
+    rxStatsPage = (rxStatsPage + RX_STATS_PAGES - 1) % RX_STATS_PAGES;
+    displayRxStatsPage();
+  } else if (id == BUTTON_DOWN) {
+    rxStatsPage = (rxStatsPage + 1) % RX_STATS_PAGES;
+    displayRxStatsPage();
+  } else {
+    rxStatsPageActive = false;
+    displayInbox();
+  }
+}
 
-  // Measure text width so we can right-align it
-  int16_t bx, by;
-  uint16_t bw, bh;
-  display.getTextBounds(batBuf, 0, 0, &bx, &by, &bw, &bh);
+// -----------------------------------------------------------------------------
+// Frequency offset calibration
+//
+// "cal" listens to known traffic (time beacons and our own RICs) and feeds
+// the frequency error of each of those transmissions into the calibrator;
+// every round's median is applied as a retune until the error is below
+// OFFSET_CAL_DONE_HZ, then the offset goes to LittleFS. In normal operation
+// the same samples track drift (temperature) and correct it in small steps.
+// Success rates are compared per offset setting: pages decoded vs. failed
+// and, with POCSAG_BCH_ENABLE, codewords that needed a correction.
+// -----------------------------------------------------------------------------
+const char*    OFFSET_PATH     = "/offset.bin";
+const char*    OFFSET_TMP_PATH = "/offset.tmp";
+const uint8_t  OFFSET_VERSION  = 1;
+
+struct RxQuality {
+  uint32_t decoded;
+  uint32_t failed;
+  uint32_t codewords;
+  uint32_t badCodewords;  // corrected or uncorrectable
+};
 
-  // Right-aligned battery voltage
-  display.setCursor(SCREEN_W - bw, y);
-  display.print(batBuf);
-#endif
+struct OffsetCalState {
+  bool             active;          // "cal" running
+  OffsetCalibrator cal;
+  OffsetDrift      drift;
+  uint32_t         feiSeqUsed;      // last rxFei reading paired with a page
+  float            offsetAtStart;   // MHz
+  uint32_t         driftCorrections;
+  bool             dirty;           // drift changed the offset since the last save
+  unsigned long    lastSaveMillis;
+  bool             reportAfter;     // print the success rate once enough pages came in
+
+  // Success rate of the previous and the current offset setting
+  RxQuality windowStart;
+  RxQuality before;
+};
 
-  // Sender/ric name on the left side of the same line
-  display.setCursor(0, y);
-  display.print(msg.ricName);
-  y += 10;
+OffsetCalState offsetCal;
 
-  // ─────────────────────────────────────────────
-  // SECOND LINE: Timestamp (if valid)
-  // ─────────────────────────────────────────────
-  if (msg.time.valid) {
-    char tbuf[20];
-    snprintf(tbuf, sizeof(tbuf), "%02d.%02d.%02d %02d:%02d",
-             msg.time.day,
-             msg.time.month,
-             msg.time.year % 100,
-             msg.time.hour,
-             msg.time.minute);
-
-    display.setCursor(0, y);
-    display.print(tbuf);
-    y += 10;
-  }
+void rxQualityNow(RxQuality& q) {
+  q.decoded      = rxStats.n[RX_STAT_DECODED];
+  q.failed       = rxStats.n[RX_STAT_FAILED];
+  q.codewords    = rxStats.n[RX_STAT_BATCHES] * POCSAG_BATCH_WORDS;
+  q.badCodewords = rxStats.n[RX_STAT_FEC_WORDS] + rxStats.n[RX_STAT_FEC_FAILED];
+}
 
-  // ─────────────────────────────────────────────
-  // MESSAGE BODY: 21 characters per line wrapping
-  // ─────────────────────────────────────────────
-  const int maxCharsPerLine = 21;
-  int       len             = msg.text.length();
-  int       pos             = 0;
+void rxQualitySince(const RxQuality& start, RxQuality& q) {
+  rxQualityNow(q);
+  q.decoded      -= start.decoded;
+  q.failed       -= start.failed;
+  q.codewords    -= start.codewords;
+  q.badCodewords -= start.badCodewords;
+}
 
-  // Draw the text line by line until we run out of screen space
-  while (pos < len && y <= SCREEN_H - 8) {
-    int    remaining = len - pos;
-    int    lineLen   = (remaining > maxCharsPerLine) ? maxCharsPerLine : remaining;
-    String line      = msg.text.substring(pos, pos + lineLen);
+void printRxQuality(const __FlashStringHelper* label, const RxQuality& q) {
+  Serial.print(F("[Cal] "));
+  Serial.print(label);
+  Serial.print(F(": "));
+  Serial.print(q.decoded * 100.0f / max<uint32_t>(q.decoded + q.failed, 1), 1);
+  Serial.print(F("% of "));
+  Serial.print(q.decoded + q.failed);
+  Serial.print(F(" pages decoded"));
+#if POCSAG_BCH_ENABLE
+  Serial.print(F(", "));
+  Serial.print(q.badCodewords * 100.0f / max<uint32_t>(q.codewords, 1), 2);
+  Serial.print(F("% codewords with bit errors"));
+#endif
+  Serial.println();
+}
 
-    display.setCursor(0, y);
-    display.print(line);
+// Retune by adjustHz; the current setting's success rate becomes "before"
+void offsetCalApply(int32_t adjustHz) {
+  float newOffset = offset + adjustHz / 1000000.0f;
+  rxQualitySince(offsetCal.windowStart, offsetCal.before);
+  rxQualityNow(offsetCal.windowStart);
+  radioQueueRetune(frequency, newOffset);
+
+  Serial.print(F("[Cal] Offset "));
+  Serial.print(offset, 6);
+  Serial.print(F(" -> "));
+  Serial.print(newOffset, 6);
+  Serial.print(F(" MHz ("));
+  Serial.print(adjustHz);
+  Serial.println(F(" Hz)"));
+}
 
-    y += 8;     // 8px line height for text size 1
-    pos += lineLen;
-  }
+void offsetCalStartMode() {
+  offsetCalStart(offsetCal.cal);
+  offsetCal.active        = true;
+  offsetCal.offsetAtStart = offset;
+  offsetCal.feiSeqUsed    = rxFei.seq.load(std::memory_order_acquire);  // older readings don't count
+  Serial.print(F("[Cal] Calibrating: waiting for "));
+  Serial.print(OFFSET_CAL_ROUND);
+  Serial.println(F(" transmissions per round (time beacons or own RICs)"));
+}
 
-  display.display();
+void offsetCalFinish() {
+  offsetCal.active      = false;
+  offsetCal.dirty       = false;
+  offsetSavePending = true;
+  offsetCal.reportAfter = true;
+  offsetDriftReset(offsetCal.drift);
+  persistNotify();
+
+  Serial.print(F("[Cal] Done after "));
+  Serial.print(offsetCal.cal.rounds);
+  Serial.print(F(" rounds: "));
+  Serial.print(offsetCal.cal.totalHz);
+  Serial.print(F(" Hz, residual "));
+  Serial.print(offsetCal.cal.lastMedian);
+  Serial.println(F(" Hz"));
+  printRxQuality(F("Before"), offsetCal.before);
 }
 
-// Show next newer message in the ring buffer
-void inboxShowNext() {
-  if (inboxCount == 0) {
-    return;
+// Loop side: a page to a known RIC arrived, use the reading of its preamble
+void offsetCalOnPage(uint32_t addr) {
+  bool known = isTimeBeaconRic(addr) || ricTableMatch(ricTable(), addr, RIC_FUNCTION_UNKNOWN) != RIC_NOT_FOUND;
+  uint32_t seq = rxFei.seq.load(std::memory_order_acquire);
+  if (!known || seq == offsetCal.feiSeqUsed || radioRetunePending.load(std::memory_order_relaxed)) {
+    return;  // one sample per transmission, none across a retune
+  }
+  offsetCal.feiSeqUsed = seq;
+  int32_t errorHz      = rxFei.hz;
+  int32_t adjustHz;
+
+  if (offsetCal.active) {
+    OffsetCalStep step = offsetCalSample(offsetCal.cal, errorHz, adjustHz);
+    if (step != OFFSET_CAL_WAIT && adjustHz != 0) {
+      offsetCalApply(adjustHz);
+    }
+    if (step == OFFSET_CAL_DONE) {
+      offsetCalFinish();
+    }
+  } else if (offsetDriftSample(offsetCal.drift, errorHz, adjustHz)) {
+    Serial.print(F("[Cal] Drift correction: "));
+    offsetCalApply(adjustHz);
+    offsetCal.driftCorrections++;
+    offsetCal.dirty = true;
   }
+}
 
-  int idx = inboxCurrent;
+// Called from loop(): deferred saves and the "after" report
+void handleOffsetCal() {
+  unsigned long now = millis();
+  if (offsetCal.dirty && now - offsetCal.lastSaveMillis >= OFFSET_SAVE_MS) {
+    offsetCal.dirty       = false;
+    offsetSavePending = true;
+    persistNotify();
+  }
 
-  for (int i = 0; i < INBOX_SIZE; ++i) {
-    idx = (idx + 1) % INBOX_SIZE;
-    if (inbox[idx].valid) {
-      inboxCurrent = idx;
-      displayInbox();
-      return;
+  if (offsetCal.reportAfter) {
+    RxQuality after;
+    rxQualitySince(offsetCal.windowStart, after);
+    if (after.decoded + after.failed >= OFFSET_REPORT_PAGES) {
+      offsetCal.reportAfter = false;
+      printRxQuality(F("After calibration"), after);
+      printRxQuality(F("Before calibration"), offsetCal.before);
     }
   }
-
-  // If nothing else was found, keep the current one
-  displayInbox();
 }
-void displayInboxMenu() {
-  markDisplayActivity();
 
-  if (!displayIsOn) {
-    return;
+void printOffsetCal() {
+  Serial.print(F("[Cal] Offset "));
+  Serial.print(offset, 6);
+  Serial.print(F(" MHz, drift "));
+  Serial.print(offsetDriftHz(offsetCal.drift));
+  Serial.print(F(" Hz ("));
+  Serial.print(offsetCal.drift.samples);
+  Serial.print(F(" samples), "));
+  Serial.print(offsetCal.driftCorrections);
+  Serial.println(F(" drift corrections"));
+  if (offsetCal.active) {
+    Serial.print(F("[Cal] Calibrating, round "));
+    Serial.print(offsetCal.cal.rounds + 1);
+    Serial.print(F(", "));
+    Serial.print(offsetCal.cal.count);
+    Serial.print(F("/"));
+    Serial.println(OFFSET_CAL_ROUND);
   }
 
-  display.clearDisplay();
-  drawClockBar();
-  clearContentArea();
-
-  display.setTextColor(WHITE);
-  display.setTextSize(1);
+  RxQuality now;
+  rxQualitySince(offsetCal.windowStart, now);
+  printRxQuality(F("Current offset"), now);
+  printRxQuality(F("Previous offset"), offsetCal.before);
+}
 
-  int y = STATUS_BAR_HEIGHT + 4;
+// Restore the calibrated offset (after LittleFS is mounted)
+void offsetCalLoad() {
+  rxQualityNow(offsetCal.windowStart);
 
-  display.setCursor(0, y);
-  display.print(F("Inbox Menu"));
-  y += 10;
+  // A rewrite interrupted after the old file was removed
+  if (!LittleFS.exists(OFFSET_PATH) && LittleFS.exists(OFFSET_TMP_PATH)) {
+    LittleFS.rename(OFFSET_TMP_PATH, OFFSET_PATH);
+  }
 
-  for (int i = 0; i < INBOX_MENU_ITEM_COUNT; ++i) {
-    display.setCursor(0, y);
-    if (i == inboxMenuIndex) {
-      display.print('>');   // Markierung für die aktuelle Auswahl
-    } else {
-      display.print(' ');
-    }
-    display.print(' ');
-    display.print(INBOX_MENU_ITEMS[i]);
-    y += 10;
+  File f = LittleFS.open(OFFSET_PATH, FILE_READ);
+  if (!f) {
+    return;
+  }
+  uint8_t buf[12];
+  bool    ok = f.read(buf, sizeof(buf)) == sizeof(buf) &&
+               buf[0] == 'O' && buf[1] == 'F' && buf[2] == 'S' && buf[3] == OFFSET_VERSION &&
+               getLe32(buf + 8) == crc32Update(0, buf + 4, 4);
+  f.close();
+  if (!ok) {
+    Serial.println(F("[Cal] Saved offset not usable, using config.h"));
+    return;
   }
 
-  display.display();
+  float saved = (int32_t)getLe32(buf + 4) / 1000000.0f;
+  Serial.print(F("[Cal] Restored offset "));
+  Serial.print(saved, 6);
+  Serial.println(F(" MHz"));
+  if (radioTaskHandle) {
+    radioQueueRetune(frequency, saved);  // fast boot: already listening
+  } else {
+    offset = saved;
+  }
 }
 
-// Show older message in the ring buffer
-void inboxShowPrev() {
-  if (inboxCount == 0) {
+// Write the offset to OFFSET_TMP_PATH and swap it in, so a torn write keeps
+// the previous calibration. Caller holds persistMutex.
+void offsetCalSave() {
+  offsetSavePending    = false;
+  offsetCal.lastSaveMillis = millis();
+  if (!storageOk) {
     return;
   }
 
-  int idx = inboxCurrent;
+  // The retune may still be queued: save what it will set
+  float   value = radioRetunePending.load(std::memory_order_acquire) ? radioRetuneOffset : offset;
+  uint8_t buf[12] = { 'O', 'F', 'S', OFFSET_VERSION };
+  putLe32(buf + 4, (uint32_t)(int32_t)lroundf(value * 1000000.0f));
+  putLe32(buf + 8, crc32Update(0, buf + 4, 4));
 
-  for (int i = 0; i < INBOX_SIZE; ++i) {
-    idx = (idx - 1 + INBOX_SIZE) % INBOX_SIZE;
-    if (inbox[idx].valid) {
-      inboxCurrent = idx;
-      displayInbox();
-      return;
-    }
+  File f = LittleFS.open(OFFSET_TMP_PATH, FILE_WRITE);
+  if (!f) {
+    Serial.println(F("[Cal] Failed to open offset file"));
+    return;
+  }
+  bool ok = f.write(buf, sizeof(buf)) == sizeof(buf);
+  f.close();
+  rxStats.n[RX_STAT_FLASH_WRITES]++;
+  if (!ok) {
+    Serial.println(F("[Cal] Failed to write offset file"));
+    LittleFS.remove(OFFSET_TMP_PATH);
+    return;
   }
 
-  // If nothing else was found, keep the current one
-  displayInbox();
+  LittleFS.remove(OFFSET_PATH);
+  if (!LittleFS.rename(OFFSET_TMP_PATH, OFFSET_PATH)) {
+    Serial.println(F("[Cal] Failed to replace offset file"));
+  }
 }
 
 // -----------------------------------------------------------------------------
-// Buzzer and LED notification (non-blocking)
+// Serial console
+//
+// Line commands (CR or LF terminated), parsed a character at a time from
+// loop(), so a slow terminal never holds up the other handlers:
+//   help | stats | dump | clear | export [baud]
+//   set-offset <MHz> | set-frequency <MHz>   (runtime only, config.h stays)
+//   cal | cal stop | cal status              (offset calibration, saved)
+//   rics | rics reload | rics add <ric>,<A-D|*>,<name>[,tone[,prio]] | rics del <ric>
+//   prof | prof reset                        (PROFILE_ENABLE builds)
+//
+// "export" switches the UART to CONSOLE_EXPORT_BAUD and streams the inbox
+// as binary frames, oldest first:
+//   0xA5 0x5A <record>
+// where <record> has the journal layout (type, slot, len16, payload, crc32).
+// An 'S' record (count16, uptime32) opens the stream, one 'A' record per
+// message follows and an 'E' record (count16) closes it. A frame is only
+// written once the TX buffer can take all of it, so other log lines never
+// end up inside a frame and loop() never waits for the UART.
 // -----------------------------------------------------------------------------
+const uint8_t CONSOLE_FRAME_SYNC0    = 0xA5;
+const uint8_t CONSOLE_FRAME_SYNC1    = 0x5A;
+const uint8_t CONSOLE_REC_START      = 'S';
+const uint8_t CONSOLE_REC_END        = 'E';
+const size_t  CONSOLE_FRAME_HDR_LEN  = 2;
+const size_t  CONSOLE_LINE_MAX       = 64;
+const unsigned long CONSOLE_EXPORT_POLL_MS = 2;  // retry while the TX buffer is full
+
+struct ConsoleExport {
+  bool     active;
+  uint32_t baud;
+  uint8_t  slots[INBOX_SIZE];  // snapshot of the chronological order
+  int      count;
+  int      next;               // -1 = start record pending, count = end record
+  uint16_t sent;
+  uint16_t skipped;            // deleted while the export was running
+  uint8_t  frame[CONSOLE_FRAME_HDR_LEN + INBOX_RECORD_MAX];
+  size_t   frameLen;           // 0 = next frame not built yet
+};
 
-void handleNotify() {
-  if (!notifyState.active) {
-    return;
-  }
+ConsoleExport consoleExport;
 
-  unsigned long now = millis();
-  if (now - notifyState.lastStepMillis < NOTIFY_STEP_MS) {
-    return;
-  }
+// Wrap a small non-message record (start/end) like the journal does
+size_t consoleBuildRecord(uint8_t* buf, uint8_t type, const uint8_t* payload, size_t len) {
+  buf[0] = type;
+  buf[1] = 0;
+  putLe16(buf + 2, (uint16_t)len);
+  memcpy(buf + INBOX_RECORD_HDR_LEN, payload, len);
 
-  notifyState.lastStepMillis = now;
+  size_t pos = INBOX_RECORD_HDR_LEN + len;
+  putLe32(buf + pos, crc32Update(0, buf, pos));
+  return pos + INBOX_RECORD_CRC_LEN;
+}
 
-  // LED blink pattern: toggle every step
-  if (notifyState.step < NOTIFY_LED_STEPS) {
-    if ((notifyState.step % 2) == 0) {
-      digitalWrite(LED, HIGH);
-    } else {
-      digitalWrite(LED, LOW);
+// Build the next frame of the export, false when the stream is complete
+bool consoleExportNextFrame() {
+  ConsoleExport& ex  = consoleExport;
+  uint8_t*       rec = ex.frame + CONSOLE_FRAME_HDR_LEN;
+  uint8_t        payload[6];
+  size_t         recLen = 0;
+
+  if (ex.next < 0) {
+    putLe16(payload, (uint16_t)ex.count);
+    putLe32(payload + 2, millis());
+    recLen  = consoleBuildRecord(rec, CONSOLE_REC_START, payload, 6);
+    ex.next = 0;
+  } else {
+    // Messages deleted since the snapshot are left out
+    while (ex.next < ex.count && recLen == 0) {
+      int slot = ex.slots[ex.next++];
+      inboxLock();
+      if (inboxRing.msg[slot].valid) {
+        recLen = buildInboxRecord(rec, INBOX_REC_ADD, slot, &inboxRing.msg[slot]);
+        ex.sent++;
+      } else {
+        ex.skipped++;
+      }
+      inboxUnlock();
     }
 
-    // Tone pattern for the first NOTENUMBER steps
-    if (notifyState.step < NOTENUMBER) {
-      int note = beepTones[notifyState.ringToneChoice][notifyState.step];
-      tone(BUZZER, note, 130); // 130ms non-blocking
+    if (recLen == 0) {
+      if (ex.next > ex.count) {
+        return false;  // end record already sent
+      }
+      putLe16(payload, ex.sent);
+      recLen  = consoleBuildRecord(rec, CONSOLE_REC_END, payload, 2);
+      ex.next = ex.count + 1;
     }
+  }
 
-    notifyState.step++;
-  } else {
-    // End of notification pattern
-    notifyState.active = false;
-    digitalWrite(LED, LOW);
+  ex.frame[0]  = CONSOLE_FRAME_SYNC0;
+  ex.frame[1]  = CONSOLE_FRAME_SYNC1;
+  ex.frameLen  = CONSOLE_FRAME_HDR_LEN + recLen;
+  return true;
+}
+
+void consoleExportStart(uint32_t baud) {
+  ConsoleExport& ex = consoleExport;
+
+  inboxLock();
+  ex.count = 0;
+  for (int i = inboxRing.order.head; i != INBOX_NIL; i = inboxRing.next[i]) {
+    ex.slots[ex.count++] = (uint8_t)i;
   }
+  inboxUnlock();
+
+  ex.baud     = baud;
+  ex.next     = -1;
+  ex.sent     = 0;
+  ex.skipped  = 0;
+  ex.frameLen = 0;
+  ex.active   = true;
+
+  Serial.print(F("[Console] Exporting "));
+  Serial.print(ex.count);
+  Serial.print(F(" messages at "));
+  Serial.print(baud);
+  Serial.println(F(" baud"));
+  Serial.flush();  // the announcement still goes out at the console rate
+  Serial.updateBaudRate(baud);
 }
 
-void ringBuzzer(int ringToneChoice) {
-  // Start non-blocking notification pattern
-  notifyState.active         = true;
-  notifyState.lastStepMillis = millis();
-  notifyState.step           = 0;
-  notifyState.ringToneChoice = ringToneChoice;
+void consoleExportFinish() {
+  ConsoleExport& ex = consoleExport;
+
+  Serial.flush();  // last frame out before the rate changes back
+  Serial.updateBaudRate(CONSOLE_BAUD);
+  ex.active = false;
+
+  Serial.print(F("[Console] Export done: "));
+  Serial.print(ex.sent);
+  Serial.print(F(" sent, "));
+  Serial.print(ex.skipped);
+  Serial.println(F(" deleted meanwhile"));
 }
 
-// -----------------------------------------------------------------------------
-// New message reminder (LED pulse every 30s until acknowledged)
-// -----------------------------------------------------------------------------
+// Push as many complete frames as the TX buffer takes right now
+void consoleExportService() {
+  ConsoleExport& ex = consoleExport;
 
-void handleNewMessageReminder() {
-  if (!newMessagePending) {
-    // No pending messages -> ensure LED is off if no notify is active
-    if (!notifyState.active && !reminderPulseActive) {
-      digitalWrite(LED, LOW);
+  while (ex.active) {
+    if (ex.frameLen == 0 && !consoleExportNextFrame()) {
+      consoleExportFinish();
+      return;
     }
-    return;
+    if ((size_t)Serial.availableForWrite() < ex.frameLen) {
+      return;  // TIMER_CONSOLE brings us back
+    }
+    Serial.write(ex.frame, ex.frameLen);
+    ex.frameLen = 0;
   }
+}
 
-  // While main notification is running, we do not run the reminder
-  if (notifyState.active) {
-    return;
+bool consoleNextDue(unsigned long& due) {
+  if (!consoleExport.active) {
+    return false;
   }
+  due = millis() + CONSOLE_EXPORT_POLL_MS;
+  return true;
+}
 
-  unsigned long now = millis();
+void consolePrintHelp() {
+  Serial.println(F("[Console] help | stats | dump | clear | export [baud]"));
+  Serial.println(F("[Console] set-offset <MHz> | set-frequency <MHz> | cal | cal stop | cal status"));
+  Serial.println(F("[Console] rics | rics reload | rics add <ric>,<A-D|*>,<name>[,tone[,prio]] | rics del <ric>"));
+#if PROFILE_ENABLE
+  Serial.println(F("[Console] prof | prof reset"));
+#endif
+#if RF_REPLAY_ENABLE
+  Serial.println(F("[Console] replay synth <pages> [bps] [berPpm] [burstEvery] [burstBits]"));
+  Serial.println(F("[Console] replay file <path> [berPpm] [burstEvery] [burstBits] | replay stop"));
+#endif
+}
 
-  if (reminderPulseActive) {
-    // We are currently in a short LED pulse
-    if (now >= reminderPulseEndMillis) {
-      digitalWrite(LED, LOW);
-      reminderPulseActive = false;
-    }
-  } else {
-    // Wait until interval elapsed, then start a new pulse
-    if (now - lastReminderBlinkMillis >= REMINDER_INTERVAL_MS) {
-      lastReminderBlinkMillis = now;
-      digitalWrite(LED, HIGH);
-      reminderPulseActive    = true;
-      reminderPulseEndMillis = now + REMINDER_PULSE_MS;
-    }
+// Parse a MHz argument, false if it is empty or not a number
+bool consoleParseMHz(const char* arg, float& value) {
+  char* end;
+  value = strtof(arg, &end);
+  return end != arg && *end == '\0';
+}
+
+#if RF_REPLAY_ENABLE
+// Optional unsigned number argument; advances arg past it
+uint32_t consoleNextNumber(char*& arg, uint32_t fallback) {
+  while (*arg == ' ') {
+    arg++;
   }
+  if (*arg == '\0') {
+    return fallback;
+  }
+  char*         end;
+  unsigned long value = strtoul(arg, &end, 10);
+  arg                 = end;
+  return (uint32_t)value;
 }
 
-// -----------------------------------------------------------------------------
-// Button event handlers
-// -----------------------------------------------------------------------------
+void consoleReplay(char* arg) {
+  char* sub = arg;
+  arg       = strchr(arg, ' ');
+  if (arg != nullptr) {
+    *arg++ = '\0';
+  } else {
+    arg = sub + strlen(sub);
+  }
 
-void onUpPressed() {
-  // Any key press acknowledges pending messages
-  newMessagePending = false;
+  if (strcmp(sub, "stop") == 0) {
+    replay.stopRequest.store(true, std::memory_order_relaxed);
+    return;
+  }
+  if (replayActive()) {
+    Serial.println(F("[Replay] Already running, use replay stop"));
+    return;
+  }
 
-  // One message "up" (older message)
-  markDisplayActivity();
-  inboxShowPrev();
+  bool ok = false;
+  if (strcmp(sub, "synth") == 0) {
+    uint32_t pages   = consoleNextNumber(arg, 0);
+    uint32_t bitRate = consoleNextNumber(arg, rxBitRate);
+    ReplayImpairment imp = {};
+    imp.berPpm           = consoleNextNumber(arg, 0);
+    imp.burstEveryBits   = consoleNextNumber(arg, 0);
+    imp.burstBits        = (uint16_t)consoleNextNumber(arg, 0);
+    imp.seed             = 42;  // same stream and same errors for every run
+    ok = pages <= 0xFFFF && replayStartSynthetic((uint16_t)pages, bitRate, imp);
+  } else if (strcmp(sub, "file") == 0) {
+    char* path = arg;
+    arg        = strchr(arg, ' ');
+    if (arg != nullptr) {
+      *arg++ = '\0';
+    } else {
+      arg = path + strlen(path);
+    }
+    ReplayImpairment imp = {};
+    imp.berPpm           = consoleNextNumber(arg, 0);
+    imp.burstEveryBits   = consoleNextNumber(arg, 0);
+    imp.burstBits        = (uint16_t)consoleNextNumber(arg, 0);
+    imp.seed             = 42;
+    ok = path[0] != '\0' && replayStartFile(path, imp);
+  }
+  if (!ok) {
+    Serial.println(F("[Replay] Usage: replay synth <pages> [bps] [berPpm] [burstEvery] [burstBits]"));
+  }
 }
+#endif
 
-void onDownPressed() {
-  newMessagePending = false;
+// RIC table changes, saved to RIC_TABLE_PATH right away
+void consoleRics(char* arg) {
+  if (*arg == '\0') {
+    printRicTable();
+    return;
+  }
+  if (!inboxReady) {
+    Serial.println(F("[RIC] Storage not ready yet"));
+    return;
+  }
+  if (strcmp(arg, "reload") == 0) {
+    ricTableLoad();
+    return;
+  }
 
-  // One message "down" (newer message)
-  markDisplayActivity();
-  inboxShowNext();
+  RicTable& next = ricSpare();
+  next           = ricTable();
+  bool changed   = false;
+  if (strncmp(arg, "add ", 4) == 0) {
+    RicEntry e;
+    changed = ricTableParseLine(arg + 4, e) == 1 && e.ringtone < RINGTONE &&
+              ricTableAdd(next, e) != RIC_NOT_FOUND;
+  } else if (strncmp(arg, "del ", 4) == 0) {
+    char*         end;
+    unsigned long addr = strtoul(arg + 4, &end, 10);
+    if (end != arg + 4 && *end == '\0') {
+      for (uint8_t f = 0; f <= RIC_FUNCTION_ANY; ++f) {
+        changed = ricTableRemove(next, (uint32_t)addr, f) || changed;
+      }
+    }
+  }
+  if (!changed) {
+    Serial.println(F("[RIC] Usage: rics add <ric>,<A-D|*>,<name>[,tone[,prio]] | rics del <ric>"));
+    return;
+  }
+
+  ricTablePublish(next);
+  ricTableSave();
+  printRicTable();
 }
-void onMenuUpPressed() {
-  newMessagePending = false;
-  markDisplayActivity();
 
-  if (!inboxMenuActive) return;
+void consoleExecute(char* line) {
+  char* arg = strchr(line, ' ');
+  if (arg != nullptr) {
+    *arg++ = '\0';
+    while (*arg == ' ') {
+      arg++;
+    }
+  } else {
+    arg = line + strlen(line);
+  }
 
-  inboxMenuIndex--;
-  if (inboxMenuIndex < 0) {
-    inboxMenuIndex = INBOX_MENU_ITEM_COUNT - 1;
+  float value;
+  if (line[0] == '\0') {
+    return;
+  } else if (strcmp(line, "help") == 0) {
+    consolePrintHelp();
+  } else if (strcmp(line, "stats") == 0) {
+    printRxStats();
+    printRxDrainStats();
+#if RX_DUTY_CYCLE
+    printDutyCycleStats();
+#endif
+    printRxScanStats();
+    printHistoryStats();
+    printClockStats();
+    printNotifyStats();
+  } else if (strcmp(line, "dump") == 0) {
+    dumpInboxToSerial();
+  } else if (strcmp(line, "clear") == 0) {
+    deleteAllMessages();
+    displayInbox();
+  } else if (strcmp(line, "export") == 0) {
+    long baud = (*arg != '\0') ? atol(arg) : CONSOLE_EXPORT_BAUD;
+    if (baud < 9600) {
+      Serial.println(F("[Console] export: bad baud rate"));
+    } else {
+      consoleExportStart((uint32_t)baud);
+    }
+  } else if (strcmp(line, "cal") == 0 && *arg == '\0') {
+    offsetCalStartMode();
+  } else if (strcmp(line, "cal") == 0 && strcmp(arg, "stop") == 0) {
+    offsetCal.active = false;
+    Serial.println(F("[Cal] Stopped"));
+  } else if (strcmp(line, "cal") == 0 && strcmp(arg, "status") == 0) {
+    printOffsetCal();
+  } else if (strcmp(line, "rics") == 0) {
+    consoleRics(arg);
+  } else if (strcmp(line, "set-offset") == 0 && consoleParseMHz(arg, value)) {
+    radioQueueRetune(frequency, value);
+  } else if (strcmp(line, "set-frequency") == 0 && consoleParseMHz(arg, value)) {
+    radioQueueRetune(value, offset);
+#if PROFILE_ENABLE
+  } else if (strcmp(line, "prof") == 0 && *arg == '\0') {
+    profDump();
+  } else if (strcmp(line, "prof") == 0 && strcmp(arg, "reset") == 0) {
+    profReset();
+    Serial.println(F("[Prof] reset"));
+#endif
+#if RF_REPLAY_ENABLE
+  } else if (strcmp(line, "replay") == 0) {
+    consoleReplay(arg);
+#endif
+  } else {
+    Serial.print(F("[Console] Unknown command: "));
+    Serial.println(line);
+    consolePrintHelp();
   }
-  displayInboxMenu();
 }
 
-void onMenuDownPressed() {
-  newMessagePending = false;
-  markDisplayActivity();
+// Called from loop(): run the export, then read whatever input has arrived
+void handleConsole() {
+  static char    line[CONSOLE_LINE_MAX];
+  static uint8_t lineLen = 0;
 
-  if (!inboxMenuActive) return;
+  if (consoleExport.active) {
+    consoleExportService();
+    return;  // commands wait until the UART is back at the console rate
+  }
 
-  inboxMenuIndex++;
-  if (inboxMenuIndex >= INBOX_MENU_ITEM_COUNT) {
-    inboxMenuIndex = 0;
+  while (Serial.available() > 0) {
+    char c = (char)Serial.read();
+    if (c != '\r' && c != '\n') {
+      if (lineLen < sizeof(line) - 1) {
+        line[lineLen++] = c;
+      }
+      continue;
+    }
+
+    line[lineLen] = '\0';
+    lineLen       = 0;
+    consoleExecute(line);
+    if (consoleExport.active) {
+      return;  // the rest of the input waits for the export
+    }
   }
-  displayInboxMenu();
 }
 
-void onMenuEnterPressed() {
-  newMessagePending = false;
-  markDisplayActivity();
+// -----------------------------------------------------------------------------
+// Received page handling (consumer side of the radio queue)
+// -----------------------------------------------------------------------------
 
-  if (!inboxMenuActive) return;
+// Pages stored recently, so copies from other transmitters are dropped
+PageDedup pageDedup;
 
-  switch (inboxMenuIndex) {
-    case 0: // Del Msg
-      deleteCurrentMessage();
-      inboxMenuActive = false;
-      displayInbox();
-      break;
+// Drain all pages the radio task has queued: time sync, RIC matching,
+// storage, display and notification
+void handleReceivedPages() {
+  PROFILE_SCOPE(PROF_RX_PAGES);
+  RxPage* page;
 
-    case 1: // Del All
-      deleteAllMessages();
-      inboxMenuActive = false;
-      displayInbox();
-      break;
+  while ((page = rxQueuePeek()) != nullptr) {
+    const char* str = page->text;
+    size_t      len = page->len;
 
-    case 2: // Cancel
-    default:
-      inboxMenuActive = false;
-      displayInbox();
-      break;
-  }
-}
+    Serial.print(F("[Pager] Address:\t"));
+    Serial.print(page->addr);
+    Serial.print(F(" [Pager] Data:\t"));
+    Serial.println(str);
 
-void onEnterPressed() {
-  // Jede Taste quittiert das Reminder-Blinken
-  newMessagePending = false;
-  markDisplayActivity();
+    // Evaluate time messages
+    if (isTimeBeaconRic(page->addr)) {
+      rxCount->n[RX_STAT_TIME_BEACONS]++;
+    }
+    if (!replayActive()) {
+      handleTimeMessage(page->addr, str, len);  // replayed beacons must not set the clock
+    }
 
-  // Wenn Display aus war, erst aufwecken und nur die Inbox zeigen
-  if (!displayIsOn) {
-    displaySetOn(true);
-    displayInbox();
-    return;
-  }
+    // Route by RIC and function code: one table entry per page
+    const RicTable& rics = ricTable();
+    uint8_t         idx  = ricTableMatch(rics, page->addr, page->function);
+
+    // A copy of a page that is already in the inbox (replays are never
+    // deduplicated, they measure the decoder)
+    uint32_t hash      = pageDedupHash(page->addr, page->function, str, len);
+    bool     duplicate = idx != RIC_NOT_FOUND && !replayActive() &&
+                         pageDedupCheck(pageDedup, hash, millis(), PAGE_DEDUP_WINDOW_MS);
+    if (duplicate) {
+      rxCount->n[RX_STAT_DUPLICATES]++;
+      Serial.println(F("[Pager] Duplicate, not stored"));
+    } else if (idx != RIC_NOT_FOUND) {
+      const RicEntry& e = rics.entries[idx];
+      rxStatsCountRic(e.addr, e.function);
+
+      // Replayed pages end here, their latency is taken up to the store: the
+      // inbox, the history and the reminder keep the real messages
+      if (!replayActive()) {
+        // Store in inbox (RAM + LittleFS)
+        int slot = storeMessage(page->addr, idx, str, len);
+
+        // Show on display and start notification
+        displayPage(e.name, slot);
+        ringBuzzer(e.ringtone, e.priority);
+      }
+    }
 
-  // Wenn keine Nachrichten vorhanden sind, macht ein Lösch-Menü keinen Sinn
-  if (inboxCount == 0) {
-    displayInbox();
-    return;
+#if RF_REPLAY_ENABLE
+    replayOnPage(page->addr, str, len);
+#endif
+    if (!replayActive()) {
+      offsetCalOnPage(page->addr);
+    }
+    rxQueuePop();
   }
 
-  // Inbox-Menü öffnen
-  inboxMenuActive = true;
-  inboxMenuIndex  = 0;
-  displayInboxMenu();
+  // Report the burst counters whenever a burst set a new high-water mark
+  static uint32_t reportedMarks = 0;
+  uint32_t        marks         = rxDrainStats.backlogMax.load(std::memory_order_relaxed) +
+                                  rxDrainStats.queueDepthMax.load(std::memory_order_relaxed) +
+                                  rxDrainStats.budgetHits.load(std::memory_order_relaxed) +
+                                  rxQueueDropped.load(std::memory_order_relaxed);
+  if (marks != reportedMarks) {
+    reportedMarks = marks;
+    printRxDrainStats();
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -1490,7 +6031,9 @@ void onEnterPressed() {
 // -----------------------------------------------------------------------------
 
 void setup() {
-  Serial.begin(115200);
+  Serial.setTxBufferSize(CONSOLE_TX_BUFFER);  // before begin(), sizes the UART driver
+  Serial.begin(CONSOLE_BAUD);
+  Serial.onReceive(schedWakeLoop);            // console input wakes loop()
   pinMode(LED, OUTPUT);
   digitalWrite(LED, LOW);
 
@@ -1505,18 +6048,38 @@ void setup() {
   esp_bt_controller_disable();
 #endif
 
-  displayInit();
+#if PROFILE_ENABLE
+  profInit();  // after the CPU clock is set
+#endif
+
+  rxStats.n[RX_STAT_BOOTS] = 1;
+
+#if FAST_BOOT
+  // Receiver first: everything else happens while it is already listening
+  buttonsInit();
+  powerInit();          // wake-up sources and light sleep
+  notifyInit();         // buzzer, LED and their playback timer
+  storageInitMemory();  // empty inbox, LittleFS comes later
+  pocsagInit();
+  radioTaskStart();     // starts RX and decodes on its own core
+  persistTaskStart();   // mounts LittleFS and restores the inbox first
 
+  displayInit();
 #if defined(ESP32)
-  // Configure ADC for battery measurement
-  analogReadResolution(12);                           // 0..4095
-  analogSetPinAttenuation(PIN_BATTERY_ADC, ADC_11db); // up to ~3.6V at pin
+  // The sampler replaces a first reading taken while the supply settles
+  batteryInit();
+#endif
+  // Splash stays up until the first screen update
+  drawStartupScreen();
+#else
+  displayInit();
 
+#if defined(ESP32)
   // Give the regulator and battery a short moment to settle after boot
   delay(500);
 
-  // First battery measurement for the splash screen
-  batteryVoltage = readBatteryVoltage();
+  // ADC calibration and first battery reading for the splash screen
+  batteryInit();
 #endif
 
   // Show startup screen with battery voltage
@@ -1524,72 +6087,66 @@ void setup() {
   delay(1500);   // keep splash screen for 1.5s
 
   buttonsInit();
+  powerInit();     // wake-up sources and light sleep
+  notifyInit();    // buzzer, LED and their playback timer
   storageInit();   // Initialize LittleFS and restore inbox
+  persistTaskStart();
   pocsagInit();
-  pocsagStartRx();
+  radioTaskStart(); // starts RX and decodes on its own core
+#endif
+
+  Serial.print(F("[Boot] Setup done after "));
+  Serial.print((uint32_t)(esp_timer_get_time() / 1000));
+  Serial.println(F(" ms"));
 }
 
 void loop() {
-  // Advance internal pager clock
-  tickPagerClock();
-
-  // Poll buttons
-  handleButtons();
+  // Button events (once the inbox they navigate is restored)
+  if (inboxReady) {
+    PROFILE_CALL(PROF_BUTTONS, handleButtons());
+  }
 
   // Handle display power-save
-  handleDisplayPowerSave();
+  PROFILE_CALL(PROF_DISPLAY_PS, handleDisplayPowerSave());
 
-  // Handle non-blocking notification pattern
-  handleNotify();
+#if defined(ESP32)
+  // Background battery sampling / low-battery flush
+  handleBattery();
+#endif
 
-  // Handle LED reminder for new/unacknowledged messages
-  handleNewMessageReminder();
+  // RX statistics: rolling rates and periodic save
+  rxStatsTick();
 
   // Update clock bar once per second (only if we have time and display is on)
-  static unsigned long lastClockDraw = 0;
-  unsigned long        now           = millis();
-  if (pagerTime.valid && displayIsOn && (now - lastClockDraw > 1000)) {
-    lastClockDraw = now;
-    drawClockBar();
-    display.display();
+  unsigned long now = millis();
+  if (pagerClock.valid && displayIsOn && (now - lastClockDrawMillis > 1000)) {
+    lastClockDrawMillis = now;
+    if (clockBarChanged()) {
+      PROFILE_SCOPE(PROF_CLOCK_BAR);
+      drawClockBar();
+      displayFlushDirty();
+    }
   }
 
-  // Wait for at least 2 POCSAG batches to fit short/medium messages
-  if (pager.available() >= 2) {
-    Serial.print(F("[Pager] Received pager data, decoding ... "));
-
-    String   str;
-    uint32_t addr  = 0;
-    int      state = pager.readData(str, 0, &addr);
-
-    if (state == RADIOLIB_ERR_NONE) {
-      Serial.println(F("success!"));
+  // Pages decoded by the radio task
+  if (inboxReady) {
+    handleReceivedPages();
+  }
 
-      Serial.print(F("[Pager] Address:\t"));
-      Serial.print(String(addr));
-      Serial.print(F(" [Pager] Data:\t"));
-      Serial.println(str);
+  // Serial console commands and a running inbox export
+  handleConsole();
 
-      // Evaluate time messages
-      handleTimeMessage(addr, str);
+  // Offset calibration: deferred saves and reports
+  handleOffsetCal();
 
-      // Check RIC list
-      for (int i = 0; i < RICNUMBER; i++) {
-        if (addr == ric[i].ricvalue) {
-          // Store in inbox (RAM + LittleFS)
-          storeMessage(addr, ric[i].name, str);
+#if RF_REPLAY_ENABLE
+  handleReplay();
+#endif
 
-          // Show on display and start notification
-          displayPage(ric[i].name, str);
-          ringBuzzer(ric[i].ringtype);
-        }
-      }
-    } else {
-      Serial.print(F("failed, code "));
-      Serial.println(state);
-    }
-  }
+  // LED reminder for new/unacknowledged messages (played by the esp_timer)
+  notifyReminderSync();
 
-  // For debugging we can call:
-  // dumpInboxToSerial();
+  // Nothing left to do: sleep until the next timer, a button or a page
+  schedArmTimers();
+  schedWaitForEvent();
 }
@@ -0,0 +1,247 @@
+// Micro-benchmarks for the inbox and parser hot paths. Each one prints its
+// figure and fails below a deliberately loose floor, so only real
+// regressions (an accidental O(n) walk, a heap allocation per page) trip it.
+// Floors are for a desktop host, override them with -D in build_flags.
+
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+#include <inbox_codec.h>
+#include <inbox_ring.h>
+#include <pocsag_bch.h>
+#include <pocsag_codeword.h>
+#include <pocsag_decoder.h>
+#include <rf_replay.h>
+#include <time_message.h>
+
+#ifndef BENCH_MIN_STORES_PER_SEC
+#define BENCH_MIN_STORES_PER_SEC 200000.0
+#endif
+
+#ifndef BENCH_MAX_RESTORE_US_PER_RECORD
+#define BENCH_MAX_RESTORE_US_PER_RECORD 5.0
+#endif
+
+#ifndef BENCH_MIN_PARSES_PER_SEC
+#define BENCH_MIN_PARSES_PER_SEC 500000.0
+#endif
+
+// Decoder speed in multiples of real time at 2400 bps
+#ifndef BENCH_MIN_REPLAY_REALTIME
+#define BENCH_MIN_REPLAY_REALTIME 100.0
+#endif
+
+// Codeword correction, 1-2 bit errors in most words
+#ifndef BENCH_MIN_BCH_WORDS_PER_SEC
+#define BENCH_MIN_BCH_WORDS_PER_SEC 5000000.0
+#endif
+
+const int BENCH_PAGES   = 200000;
+const int BENCH_RECORDS = 4096;  // restore replays this many journal records
+const int BENCH_PARSES  = 200000;
+const int BENCH_REPLAY_PAGES = 200;
+const int BENCH_BCH_WORDS    = 1 << 20;
+
+static InboxRing ring;
+static uint8_t   journal[BENCH_RECORDS * 128];
+static volatile uint32_t sink;  // keeps results alive
+static uint8_t      replayData[64 * 1024];
+static ReplayExpect replayExpect[BENCH_REPLAY_PAGES];
+
+static const char* BENCH_TEXT = "Einsatz: Brandmeldeanlage ausgeloest, Hauptstrasse 12, RTW + HLF anfahren";
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void report(const char* what, double value, const char* unit) {
+  char line[96];
+  snprintf(line, sizeof(line), "%s: %.1f %s", what, value, unit);
+  TEST_MESSAGE(line);
+}
+
+void setUp() {
+  inboxRingReset(ring);
+}
+
+void tearDown() {}
+
+// storeMessage() path: ring push plus the journal record for the write-behind
+void bench_pages_stored_per_second() {
+  uint8_t     rec[INBOX_RECORD_MAX];
+  size_t      textLen = strlen(BENCH_TEXT);
+  PageMessage msg     = {};
+  msg.time            = packPagerTime({ 2025, 12, 3, 20, 6, 0, true });
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < BENCH_PAGES; ++i) {
+    msg.addr = 1000 + (uint32_t)i;
+    int slot = inboxRingPush(ring, msg, BENCH_TEXT, textLen);
+    sink    += (uint32_t)inboxEncodeRecord(rec, INBOX_REC_ADD, slot, &ring.msg[slot], "Feuerwehr", ring.text[slot]);
+  }
+  double rate = BENCH_PAGES / secondsSince(start);
+
+  report("pages stored", rate, "pages/s");
+  TEST_ASSERT_EQUAL_INT(INBOX_SIZE, ring.count);
+  TEST_ASSERT_GREATER_THAN(BENCH_MIN_STORES_PER_SEC, rate);
+}
+
+// loadInboxBinary() path without the file system: decode and replay records
+void bench_restore_time_for_n_records() {
+  size_t      textLen = strlen(BENCH_TEXT);
+  size_t      used    = 0;
+  PageMessage msg     = {};
+  msg.textLen         = (uint8_t)textLen;
+  msg.time            = packPagerTime({ 2025, 12, 3, 20, 6, 0, true });
+
+  uint8_t packed[INBOX_TEXT_PACKED];
+  textPack(packed, BENCH_TEXT, textLen);
+  for (int i = 0; i < BENCH_RECORDS; ++i) {
+    msg.addr = 1000 + (uint32_t)i;
+    used    += inboxEncodeRecord(journal + used, INBOX_REC_ADD, i % INBOX_SIZE, &msg, "Feuerwehr", packed);
+  }
+
+  auto   start = std::chrono::steady_clock::now();
+  size_t pos   = 0;
+  int    count = 0;
+  while (pos < used) {
+    size_t      len = inboxRecordLength(journal + pos);
+    InboxRecord r;
+    TEST_ASSERT_TRUE(len != 0 && inboxDecodeRecord(journal + pos, len, r));
+
+    PageMessage restored = {};
+    restored.addr        = r.addr;
+    restored.valid       = true;
+    restored.time        = r.packedTime;
+    inboxRingRestorePacked(ring, r.slot, restored, r.packedText, r.textLen);
+
+    pos += len;
+    count++;
+  }
+  double us = secondsSince(start) * 1e6;
+
+  report("restore", us / 1000.0, "ms total");
+  report("restore", us / count, "us/record");
+  TEST_ASSERT_EQUAL_INT(BENCH_RECORDS, count);
+  TEST_ASSERT_EQUAL_INT(INBOX_SIZE, ring.count);
+  TEST_ASSERT_LESS_THAN(BENCH_MAX_RESTORE_US_PER_RECORD, us / count);
+}
+
+// handleTimeMessage() parsing and the local time conversion
+void bench_time_parse_throughput() {
+  const char* beacon = "YYYYMMDDHHMMSS251203200659";
+  size_t      len    = strlen(beacon);
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < BENCH_PARSES; ++i) {
+    TimeBeacon parsed;
+    if (parseTimeMessage(i & 1 ? 216 : 224, beacon, len, parsed) == TIME_MSG_OK) {
+      PagerEpoch utc = pagerTimeToEpoch(parsed.time);
+      PagerTime  local;
+      pagerTimeFromEpoch(utc + pagerUtcOffsetMinutes(utc, 60, PAGER_DST_EU) * 60, local);
+      sink += packPagerTime(local);
+    }
+  }
+  double rate = BENCH_PARSES / secondsSince(start);
+
+  report("time parse", rate, "beacons/s");
+  TEST_ASSERT_GREATER_THAN(BENCH_MIN_PARSES_PER_SEC, rate);
+}
+
+static void countPage(const PocsagPage& page, void* ctx) {
+  ReplayMatcher* m = (ReplayMatcher*)ctx;
+  replayMatchPage(*m, page.addr, page.text, page.len);
+}
+
+// Reference decoder over a synthetic 2400 bps stream with 1e-3 bit errors:
+// pages per second of CPU time and how many times faster than the air time
+void bench_replay_decode_throughput() {
+  static const uint32_t rics[] = { 123456, 123457, 216, 1000003 };
+  ReplayScenario sc = {};
+  sc.pages          = BENCH_REPLAY_PAGES;
+  sc.pagesPerBurst  = 10;
+  sc.gapBits        = 1000;
+  sc.rics           = rics;
+  sc.ricCount       = 4;
+  sc.seed           = 1;
+
+  BitBuffer bits;
+  bitBufferInit(bits, replayData, sizeof(replayData));
+  int count = replayBuildScenario(sc, bits, replayExpect, BENCH_REPLAY_PAGES);
+
+  ReplayImpairment imp = {};
+  imp.berPpm           = 1000;
+  imp.seed             = 3;
+
+  ReplayMatcher m;
+  replayMatcherInit(m, replayExpect, count);
+  PocsagDecoder dec;
+  pocsagDecoderInit(dec, countPage, &m);
+  ReplayChannel ch;
+  replayChannelInit(ch, imp);
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < bits.bits; ++i) {
+    pocsagDecoderPushBit(dec, replayChannelBit(ch, bitBufferGet(bits.data, i)));
+  }
+  pocsagDecoderFlush(dec);
+  double secs = secondsSince(start);
+  replayMatcherFinish(m);
+
+  double airSecs = (double)bits.bits / 2400.0;
+  report("replay decode", dec.pages / secs, "pages/s");
+  report("replay decode", airSecs / secs, "x real time at 2400 bps");
+  report("replay intact", 100.0 * m.stats.intact / count, "% at BER 1e-3");
+  TEST_ASSERT_GREATER_THAN(BENCH_MIN_REPLAY_REALTIME, airSecs / secs);
+
+  // Same stream through the correcting decoder
+  replayMatcherInit(m, replayExpect, count);
+  pocsagDecoderInit(dec, countPage, &m, true);
+  replayChannelInit(ch, imp);
+  for (size_t i = 0; i < bits.bits; ++i) {
+    pocsagDecoderPushBit(dec, replayChannelBit(ch, bitBufferGet(bits.data, i)));
+  }
+  pocsagDecoderFlush(dec);
+  replayMatcherFinish(m);
+  report("replay intact", 100.0 * m.stats.intact / count, "% at BER 1e-3 with BCH correction");
+}
+
+// Syndrome lookup and correction of received codewords, 0-2 bit errors
+void bench_bch_correct_throughput() {
+  static uint32_t words[1024];
+  uint32_t        rng = 99;
+  for (uint32_t& w : words) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    w = pocsagEncodeCodeword(rng) ^ (1UL << (rng % 32)) ^ (rng & 0x100 ? 1UL << ((rng >> 9) % 32) : 0);
+  }
+
+  uint32_t fixedBits = 0;
+  auto     start     = std::chrono::steady_clock::now();
+  for (int n = 0; n < BENCH_BCH_WORDS; ++n) {
+    uint32_t cw = words[n & 1023];
+    fixedBits += (uint32_t)pocsagCorrectCodeword(cw);
+    sink = cw;
+  }
+  double secs = secondsSince(start);
+  sink        = fixedBits;
+
+  double rate = BENCH_BCH_WORDS / secs;
+  report("bch correct", rate, "codewords/s");
+  report("bch correct", POCSAG_BATCH_WORDS * 1e6 / rate, "us per batch");
+  TEST_ASSERT_GREATER_THAN(BENCH_MIN_BCH_WORDS_PER_SEC, rate);
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(bench_pages_stored_per_second);
+  RUN_TEST(bench_restore_time_for_n_records);
+  RUN_TEST(bench_time_parse_throughput);
+  RUN_TEST(bench_replay_decode_throughput);
+  RUN_TEST(bench_bch_correct_throughput);
+  return UNITY_END();
+}
@@ -0,0 +1,153 @@
+#include <string.h>
+#include <unity.h>
+#include <inbox_codec.h>
+
+static uint8_t rec[INBOX_RECORD_MAX];
+
+static size_t encodeAdd(const char* ricName, const char* text) {
+  PageMessage msg = {};
+  msg.addr        = 123456;
+  msg.textLen     = (uint8_t)strlen(text);
+  msg.time        = packPagerTime({ 2025, 12, 3, 20, 6, 0, true });
+
+  uint8_t packed[INBOX_TEXT_PACKED];
+  textPack(packed, text, msg.textLen);
+  return inboxEncodeRecord(rec, INBOX_REC_ADD, 5, &msg, ricName, packed);
+}
+
+void setUp() {
+  memset(rec, 0, sizeof(rec));
+}
+
+void tearDown() {}
+
+void test_crc32_check_value() {
+  const char* check = "123456789";
+  TEST_ASSERT_EQUAL_HEX32(0xCBF43926, crc32Update(0, (const uint8_t*)check, 9));
+}
+
+void test_add_record_roundtrip() {
+  size_t len = encodeAdd("Home", "Hello pager");
+  TEST_ASSERT_EQUAL_size_t(len, inboxRecordLength(rec));
+
+  InboxRecord r;
+  TEST_ASSERT_TRUE(inboxDecodeRecord(rec, len, r));
+  TEST_ASSERT_EQUAL_UINT8(INBOX_REC_ADD, r.type);
+  TEST_ASSERT_EQUAL_UINT8(5, r.slot);
+  TEST_ASSERT_EQUAL_UINT32(123456, r.addr);
+  TEST_ASSERT_EQUAL_size_t(4, r.ricLen);
+  TEST_ASSERT_EQUAL_MEMORY("Home", r.ricName, 4);
+  TEST_ASSERT_EQUAL_size_t(11, r.textLen);
+  TEST_ASSERT_NULL(r.text);
+
+  char text[12];
+  textUnpack(text, r.packedText, 0, r.textLen);
+  TEST_ASSERT_EQUAL_STRING("Hello pager", text);
+
+  PagerTime t = {};
+  unpackPagerTime(r.packedTime, t);
+  TEST_ASSERT_EQUAL_INT(2025, t.year);
+  TEST_ASSERT_EQUAL_INT(20, t.hour);
+}
+
+void test_delete_record_roundtrip() {
+  size_t len = inboxEncodeRecord(rec, INBOX_REC_DELETE, 9, nullptr, "", nullptr);
+  TEST_ASSERT_EQUAL_size_t(INBOX_RECORD_HDR_LEN + INBOX_RECORD_CRC_LEN, len);
+
+  InboxRecord r;
+  TEST_ASSERT_TRUE(inboxDecodeRecord(rec, len, r));
+  TEST_ASSERT_EQUAL_UINT8(INBOX_REC_DELETE, r.type);
+  TEST_ASSERT_EQUAL_UINT8(9, r.slot);
+}
+
+void test_flipped_bit_is_rejected() {
+  size_t len = encodeAdd("Home", "Hello pager");
+  rec[12] ^= 0x01;
+
+  InboxRecord r;
+  TEST_ASSERT_FALSE(inboxDecodeRecord(rec, len, r));
+}
+
+void test_torn_record_is_rejected() {
+  size_t len = encodeAdd("Home", "Hello pager");
+
+  InboxRecord r;
+  TEST_ASSERT_FALSE(inboxDecodeRecord(rec, len - 1, r));
+}
+
+void test_oversized_header_is_rejected() {
+  putLe16(rec + 2, (uint16_t)INBOX_RECORD_MAX);
+  TEST_ASSERT_EQUAL_size_t(0, inboxRecordLength(rec));
+}
+
+void test_slot_out_of_range_is_rejected() {
+  size_t len = inboxEncodeRecord(rec, INBOX_REC_DELETE, INBOX_SIZE, nullptr, "", nullptr);
+
+  InboxRecord r;
+  TEST_ASSERT_FALSE(inboxDecodeRecord(rec, len, r));
+}
+
+void test_plain_text_record_of_old_files() {
+  // Version 2 'A' body: addr, time, ricLen, ric, textLen, text unpacked
+  const uint8_t body[] = { 0x40, 0xE2, 0x01, 0x00, 0, 0, 0, 0, 1, 'H', 8, 0, 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h' };
+  rec[0] = INBOX_REC_ADD;
+  rec[1] = 2;
+  putLe16(rec + 2, sizeof(body));
+  memcpy(rec + INBOX_RECORD_HDR_LEN, body, sizeof(body));
+  size_t crcPos = INBOX_RECORD_HDR_LEN + sizeof(body);
+  putLe32(rec + crcPos, crc32Update(0, rec, crcPos));
+  size_t len = crcPos + INBOX_RECORD_CRC_LEN;
+
+  InboxRecord r;
+  TEST_ASSERT_TRUE(inboxDecodeRecord(rec, len, r, INBOX_FORMAT_PLAIN));
+  TEST_ASSERT_EQUAL_UINT32(123456, r.addr);
+  TEST_ASSERT_NULL(r.packedText);
+  TEST_ASSERT_EQUAL_size_t(8, r.textLen);
+  TEST_ASSERT_EQUAL_MEMORY("abcdefgh", r.text, 8);
+
+  // Packed, 8 characters take 7 bytes: the same body does not add up
+  TEST_ASSERT_FALSE(inboxDecodeRecord(rec, len, r));
+}
+
+void test_ric_name_is_capped() {
+  const char* longName = "a-very-long-ric-name-beyond-the-limit";
+  size_t      len      = encodeAdd(longName, "x");
+
+  InboxRecord r;
+  TEST_ASSERT_TRUE(inboxDecodeRecord(rec, len, r));
+  TEST_ASSERT_EQUAL_size_t(INBOX_RIC_NAME_MAX, r.ricLen);
+}
+
+void test_file_header() {
+  uint8_t hdr[INBOX_FILE_HEADER_LEN];
+  inboxEncodeFileHeader(hdr);
+  TEST_ASSERT_TRUE(inboxIsFileHeader(hdr));
+  TEST_ASSERT_EQUAL_UINT8(INBOX_FORMAT_VERSION, hdr[3]);
+  hdr[2] = 'H';  // history segment
+  TEST_ASSERT_FALSE(inboxIsFileHeader(hdr));
+}
+
+void test_largest_add_record() {
+  char text[INBOX_TEXT_MAX + 1];
+  memset(text, 'x', INBOX_TEXT_MAX);
+  text[INBOX_TEXT_MAX] = '\0';
+  TEST_ASSERT_EQUAL_size_t(INBOX_ADD_RECORD_MAX, encodeAdd("a-very-long-ric-name-beyond-the-limit", text));
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_crc32_check_value);
+  RUN_TEST(test_add_record_roundtrip);
+  RUN_TEST(test_delete_record_roundtrip);
+  RUN_TEST(test_flipped_bit_is_rejected);
+  RUN_TEST(test_torn_record_is_rejected);
+  RUN_TEST(test_oversized_header_is_rejected);
+  RUN_TEST(test_slot_out_of_range_is_rejected);
+  RUN_TEST(test_plain_text_record_of_old_files);
+  RUN_TEST(test_ric_name_is_capped);
+  RUN_TEST(test_file_header);
+  RUN_TEST(test_largest_add_record);
+  return UNITY_END();
+}
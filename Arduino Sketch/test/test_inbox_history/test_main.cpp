@@ -0,0 +1,117 @@
+#include <unity.h>
+#include <inbox_history.h>
+
+static const uint32_t HEADER_LEN = 8;
+static const uint32_t RECORD_LEN = 60;
+
+static InboxHistory history;
+
+void setUp() {
+  historyReset(history);
+  historySelectSegment(history, 0, 1, HEADER_LEN);
+}
+void tearDown() {}
+
+// Append like the firmware: start the other segment when this one is full
+static void archivePage(uint32_t addr) {
+  if (historySegmentFull(history)) {
+    historySelectSegment(history, history.segment ^ 1, history.generation + 1, HEADER_LEN);
+  }
+  historyAppend(history, addr, 12, 0x12345678, RECORD_LEN);
+}
+
+void test_entries_pack_the_page() {
+  uint32_t offset = historyAppend(history, 0x1FFFFF, 80, 0xCAFE, RECORD_LEN);
+  TEST_ASSERT_EQUAL_UINT32(HEADER_LEN, offset);
+
+  const HistoryEntry* e = historyFind(history, 0);
+  TEST_ASSERT_NOT_NULL(e);
+  TEST_ASSERT_EQUAL_UINT32(0x1FFFFF, historyAddr(*e));
+  TEST_ASSERT_EQUAL(80, historyTextLen(*e));
+  TEST_ASSERT_EQUAL(0, historySegment(*e));
+  TEST_ASSERT_EQUAL_UINT32(0xCAFE, e->packedTime);
+
+  TEST_ASSERT_EQUAL_UINT32(HEADER_LEN + RECORD_LEN,
+                           historyAppend(history, 1040, 5, 0, RECORD_LEN));
+  TEST_ASSERT_NULL(historyFind(history, 2));
+}
+
+void test_full_segment_drops_the_oldest_half() {
+  for (int i = 0; i < INBOX_HISTORY_MAX; ++i) {
+    archivePage((uint32_t)i);
+  }
+  TEST_ASSERT_EQUAL(INBOX_HISTORY_MAX, history.count);
+  TEST_ASSERT_EQUAL_UINT32(0, history.firstSeq);
+  TEST_ASSERT_EQUAL(1, history.segment);
+
+  // Next page starts segment 0 over: its pages are gone
+  archivePage(99999);
+  TEST_ASSERT_EQUAL(INBOX_HISTORY_SEGMENT_PAGES + 1, history.count);
+  TEST_ASSERT_EQUAL_UINT32(INBOX_HISTORY_SEGMENT_PAGES, history.firstSeq);
+  TEST_ASSERT_NULL(historyFind(history, 0));
+  TEST_ASSERT_EQUAL_UINT32(INBOX_HISTORY_SEGMENT_PAGES,
+                           historyAddr(*historyFind(history, INBOX_HISTORY_SEGMENT_PAGES)));
+
+  const HistoryEntry* newest = historyFind(history, historyEndSeq(history) - 1);
+  TEST_ASSERT_EQUAL_UINT32(99999, historyAddr(*newest));
+  TEST_ASSERT_EQUAL(0, historySegment(*newest));
+  TEST_ASSERT_EQUAL_UINT32(HEADER_LEN, newest->offset);
+  TEST_ASSERT_EQUAL_UINT32(3, history.generation);
+}
+
+void test_drop_newest_after_a_failed_write() {
+  archivePage(1);
+  archivePage(2);
+  historyDropNewest(history, RECORD_LEN);
+  TEST_ASSERT_EQUAL(1, history.count);
+  TEST_ASSERT_EQUAL_UINT32(HEADER_LEN + RECORD_LEN, history.segmentBytes);
+  archivePage(3);
+  TEST_ASSERT_EQUAL_UINT32(3, historyAddr(*historyFind(history, 1)));
+  TEST_ASSERT_EQUAL_UINT32(HEADER_LEN + RECORD_LEN, historyFind(history, 1)->offset);
+}
+
+void test_restore_two_segments() {
+  // Boot: older generation first, then the one that is appended to
+  historyReset(history);
+  historySelectSegment(history, 1, 7, HEADER_LEN);
+  for (int i = 0; i < INBOX_HISTORY_SEGMENT_PAGES; ++i) {
+    historyAppend(history, 100, 1, 0, RECORD_LEN);
+  }
+  historySelectSegment(history, 0, 8, HEADER_LEN);
+  historyAppend(history, 200, 1, 0, RECORD_LEN);
+
+  TEST_ASSERT_EQUAL(INBOX_HISTORY_SEGMENT_PAGES + 1, history.count);  // nothing dropped
+  TEST_ASSERT_FALSE(historySegmentFull(history));
+  TEST_ASSERT_EQUAL(1, historySegment(*historyFind(history, 0)));
+}
+
+void test_cache_evicts_least_recently_used() {
+  HistoryCache c;
+  historyCacheReset(c);
+  int slots[INBOX_HISTORY_CACHE];
+  for (int i = 0; i < INBOX_HISTORY_CACHE; ++i) {
+    TEST_ASSERT_EQUAL(-1, historyCacheLookup(c, (uint32_t)i));
+    slots[i] = historyCacheInsert(c, (uint32_t)i);
+  }
+  TEST_ASSERT_EQUAL(slots[0], historyCacheLookup(c, 0));  // 0 is fresh again
+
+  int slot = historyCacheInsert(c, 100);                  // replaces 1
+  TEST_ASSERT_EQUAL(slots[1], slot);
+  TEST_ASSERT_EQUAL(-1, historyCacheLookup(c, 1));
+  TEST_ASSERT_EQUAL(slots[0], historyCacheLookup(c, 0));
+  TEST_ASSERT_EQUAL(slot, historyCacheLookup(c, 100));
+  TEST_ASSERT_EQUAL_UINT32(3, c.hits);
+  TEST_ASSERT_EQUAL_UINT32(INBOX_HISTORY_CACHE + 1, c.misses);
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_entries_pack_the_page);
+  RUN_TEST(test_full_segment_drops_the_oldest_half);
+  RUN_TEST(test_drop_newest_after_a_failed_write);
+  RUN_TEST(test_restore_two_segments);
+  RUN_TEST(test_cache_evicts_least_recently_used);
+  return UNITY_END();
+}
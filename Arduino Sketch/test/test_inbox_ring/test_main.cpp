@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+#include <inbox_ring.h>
+
+static InboxRing ring;
+
+static PageMessage makeMessage(uint32_t addr) {
+  PageMessage msg = {};
+  msg.addr        = addr;
+  msg.ricIndex    = 0;
+  return msg;
+}
+
+// Unpacked text of slot
+static const char* slotText(int slot) {
+  static char text[INBOX_TEXT_MAX + 1];
+  textUnpack(text, ring.text[slot], 0, ring.msg[slot].textLen);
+  return text;
+}
+
+static int push(uint32_t addr) {
+  char text[16];
+  snprintf(text, sizeof(text), "msg %lu", (unsigned long)addr);
+  return inboxRingPush(ring, makeMessage(addr), text, strlen(text));
+}
+
+// Addresses in chronological order must match expected[0..n)
+static void assertOrder(const uint32_t* expected, int n) {
+  TEST_ASSERT_EQUAL_INT(n, ring.count);
+  int i = 0;
+  for (int slot = ring.order.head; slot != INBOX_NIL; slot = ring.next[slot], ++i) {
+    TEST_ASSERT_TRUE(i < n);
+    TEST_ASSERT_EQUAL_UINT32(expected[i], ring.msg[slot].addr);
+    TEST_ASSERT_TRUE(ring.msg[slot].valid);
+  }
+  TEST_ASSERT_EQUAL_INT(n, i);
+}
+
+void setUp() {
+  inboxRingReset(ring);
+}
+
+void tearDown() {}
+
+void test_reset_is_empty() {
+  TEST_ASSERT_EQUAL_INT(0, ring.count);
+  TEST_ASSERT_EQUAL_INT(INBOX_NIL, ring.order.head);
+  TEST_ASSERT_EQUAL_INT(INBOX_NIL, ring.order.tail);
+}
+
+void test_push_keeps_chronological_order() {
+  push(1);
+  push(2);
+  int slot = push(3);
+
+  const uint32_t expected[] = { 1, 2, 3 };
+  assertOrder(expected, 3);
+  TEST_ASSERT_EQUAL_INT(slot, ring.order.tail);
+  TEST_ASSERT_EQUAL_STRING("msg 3", slotText(slot));
+}
+
+void test_full_inbox_drops_oldest() {
+  for (int i = 0; i < INBOX_SIZE; ++i) {
+    push(100 + i);
+  }
+  push(999);
+
+  TEST_ASSERT_EQUAL_INT(INBOX_SIZE, ring.count);
+  TEST_ASSERT_EQUAL_UINT32(101, ring.msg[ring.order.head].addr);
+  TEST_ASSERT_EQUAL_UINT32(999, ring.msg[ring.order.tail].addr);
+}
+
+void test_unlink_middle() {
+  push(1);
+  int middle = push(2);
+  push(3);
+
+  inboxRingUnlink(ring, middle);
+  inboxRingUnlink(ring, middle);  // second unlink is a no-op
+
+  const uint32_t expected[] = { 1, 3 };
+  assertOrder(expected, 2);
+  TEST_ASSERT_FALSE(ring.msg[middle].valid);
+}
+
+void test_restore_into_used_slot_replaces_it() {
+  int first = push(1);
+  push(2);
+
+  const char* text = "replayed";
+  inboxRingRestore(ring, first, makeMessage(7), text, strlen(text));
+
+  const uint32_t expected[] = { 2, 7 };
+  assertOrder(expected, 2);
+  TEST_ASSERT_EQUAL_STRING("replayed", slotText(first));
+
+  // Packed text from a record is copied as it is
+  uint8_t packed[INBOX_TEXT_PACKED];
+  size_t  len = strlen("packed");
+  textPack(packed, "packed", len);
+  inboxRingRestorePacked(ring, first, makeMessage(8), packed, len);
+  TEST_ASSERT_EQUAL_STRING("packed", slotText(first));
+}
+
+void test_text_is_truncated() {
+  char text[INBOX_TEXT_MAX + 20];
+  memset(text, 'x', sizeof(text));
+
+  int slot = inboxRingPush(ring, makeMessage(1), text, sizeof(text));
+  TEST_ASSERT_EQUAL_INT(INBOX_TEXT_MAX, ring.msg[slot].textLen);
+  TEST_ASSERT_EQUAL_size_t(INBOX_TEXT_MAX, strlen(slotText(slot)));
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_reset_is_empty);
+  RUN_TEST(test_push_keeps_chronological_order);
+  RUN_TEST(test_full_inbox_drops_oldest);
+  RUN_TEST(test_unlink_middle);
+  RUN_TEST(test_restore_into_used_slot_replaces_it);
+  RUN_TEST(test_text_is_truncated);
+  return UNITY_END();
+}
@@ -0,0 +1,119 @@
+#include <unity.h>
+#include <notify_player.h>
+
+static const int MELODY[8] = { 2730, 3201, 2730, 3201, 2730, 0, 0, 0 };
+
+static NotifyPattern ringA;
+static NotifyPattern ringB;
+static NotifyPattern reminder;
+static NotifyPlayer  player;
+
+void setUp() {
+  notifyBuildRing(ringA, MELODY, 8, 100, 40);
+  notifyBuildRing(ringB, MELODY, 8, 50, 8);
+  notifyBuildReminder(reminder, 30000, 50);
+  notifyPlayerReset(player);
+}
+void tearDown() {}
+
+void test_ring_pattern() {
+  TEST_ASSERT_EQUAL_UINT32(4000, notifyPatternMs(ringA));
+  TEST_ASSERT_EQUAL(40, ringA.count);
+  TEST_ASSERT_EQUAL(2730, ringA.steps[0].freqHz);
+  TEST_ASSERT_TRUE(ringA.steps[0].led);
+  TEST_ASSERT_EQUAL(3201, ringA.steps[1].freqHz);
+  TEST_ASSERT_FALSE(ringA.steps[1].led);
+  TEST_ASSERT_EQUAL(0, ringA.steps[5].freqHz);
+  TEST_ASSERT_FALSE(ringA.steps[39].led);
+
+  // Equal neighbours are merged
+  const int hold[4] = { 1000, 1000, 1000, 0 };
+  NotifyPattern p;
+  notifyBuildRing(p, hold, 4, 100, 0);
+  TEST_ASSERT_EQUAL(2, p.count);
+  TEST_ASSERT_EQUAL(300, p.steps[0].ms);
+  TEST_ASSERT_EQUAL(0, p.steps[1].freqHz);
+}
+
+void test_reminder_pattern() {
+  TEST_ASSERT_EQUAL(2, reminder.count);
+  TEST_ASSERT_FALSE(reminder.steps[0].led);
+  TEST_ASSERT_TRUE(reminder.steps[1].led);
+  TEST_ASSERT_EQUAL_UINT32(30050, notifyPatternMs(reminder));
+
+  // Longer than a step can hold
+  NotifyPattern p;
+  notifyBuildReminder(p, 100000, 50);
+  TEST_ASSERT_EQUAL(3, p.count);
+  TEST_ASSERT_EQUAL_UINT32(100050, notifyPatternMs(p));
+}
+
+void test_ring_plays_once_then_idle() {
+  NotifyStep s;
+  TEST_ASSERT_FALSE(notifyPlayerNext(player, s));
+  TEST_ASSERT_TRUE(notifyPlayerRing(player, &ringB, 1));
+  for (int i = 0; i < ringB.count; ++i) {
+    TEST_ASSERT_TRUE(notifyPlayerNext(player, s));
+    TEST_ASSERT_EQUAL(ringB.steps[i].freqHz, s.freqHz);
+  }
+  TEST_ASSERT_FALSE(notifyPlayerNext(player, s));
+  TEST_ASSERT_FALSE(notifyPlayerRinging(player));
+}
+
+void test_priority_preemption() {
+  NotifyStep s;
+  notifyPlayerRing(player, &ringA, 1);  // APRSWX, normal
+  notifyPlayerNext(player, s);
+  notifyPlayerNext(player, s);
+
+  // EMERGENCY cuts in and starts from its first step
+  TEST_ASSERT_TRUE(notifyPlayerRing(player, &ringB, 3));
+  TEST_ASSERT_TRUE(notifyPlayerNext(player, s));
+  TEST_ASSERT_EQUAL(ringB.steps[0].ms, s.ms);
+  TEST_ASSERT_EQUAL_UINT32(1, player.preempted);
+
+  // A normal page does not cut it short, an equal one restarts it
+  TEST_ASSERT_FALSE(notifyPlayerRing(player, &ringA, 1));
+  TEST_ASSERT_EQUAL_UINT32(1, player.refused);
+  TEST_ASSERT_TRUE(notifyPlayerRing(player, &ringB, 3));
+  TEST_ASSERT_EQUAL_UINT32(3, player.rings);
+
+  // Once it has ended, any priority rings again
+  notifyPlayerStopRing(player);
+  TEST_ASSERT_TRUE(notifyPlayerRing(player, &ringA, 1));
+}
+
+void test_reminder_runs_between_rings() {
+  NotifyStep s;
+  notifyPlayerReminder(player, &reminder);
+  TEST_ASSERT_TRUE(notifyPlayerNext(player, s));
+  TEST_ASSERT_FALSE(s.led);
+  TEST_ASSERT_EQUAL(30000, s.ms);
+  TEST_ASSERT_TRUE(notifyPlayerNext(player, s));
+  TEST_ASSERT_TRUE(s.led);
+  TEST_ASSERT_TRUE(notifyPlayerNext(player, s));  // loops
+  TEST_ASSERT_FALSE(s.led);
+
+  // A ring takes over; afterwards the reminder starts over
+  notifyPlayerRing(player, &ringB, 1);
+  for (int i = 0; i < ringB.count; ++i) {
+    notifyPlayerNext(player, s);
+  }
+  TEST_ASSERT_TRUE(notifyPlayerNext(player, s));
+  TEST_ASSERT_EQUAL(30000, s.ms);
+
+  notifyPlayerReminder(player, nullptr);
+  TEST_ASSERT_FALSE(notifyPlayerNext(player, s));
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_ring_pattern);
+  RUN_TEST(test_reminder_pattern);
+  RUN_TEST(test_ring_plays_once_then_idle);
+  RUN_TEST(test_priority_preemption);
+  RUN_TEST(test_reminder_runs_between_rings);
+  return UNITY_END();
+}
@@ -0,0 +1,100 @@
+#include <unity.h>
+#include <offset_cal.h>
+
+static uint32_t rng = 2024;
+
+// Measurement noise of the frequency error estimate, +-range Hz
+static int32_t noise(int32_t range) {
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return (int32_t)(rng % (2 * range + 1)) - range;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_median() {
+  int32_t odd[]  = { 5, -3, 9, 1, 7 };
+  int32_t even[] = { 40, 10, 30, 20 };
+  TEST_ASSERT_EQUAL_INT32(5, offsetMedian(odd, 5));
+  TEST_ASSERT_EQUAL_INT32(25, offsetMedian(even, 4));
+}
+
+void test_calibration_converges_on_the_offset() {
+  const int32_t trueOffsetHz = 4400;  // UHF crystal error
+  int32_t       offsetHz     = 0;
+  OffsetCalibrator c;
+  offsetCalStart(c);
+
+  OffsetCalStep step   = OFFSET_CAL_WAIT;
+  int           beacon = 0;
+  while (step != OFFSET_CAL_DONE && beacon++ < 100) {
+    // The estimate only sees part of a large error (limited FEI range)
+    int32_t error  = trueOffsetHz - offsetHz;
+    int32_t seen   = error * 3 / 4 + noise(120);
+    int32_t adjust = 0;
+    step           = offsetCalSample(c, seen, adjust);
+    offsetHz      += adjust;
+  }
+
+  TEST_ASSERT_EQUAL(OFFSET_CAL_DONE, step);
+  TEST_ASSERT_INT32_WITHIN(OFFSET_CAL_DONE_HZ * 2, trueOffsetHz, offsetHz);
+  TEST_ASSERT_TRUE(c.rounds <= OFFSET_CAL_MAX_ROUNDS);
+  TEST_ASSERT_EQUAL_INT32(offsetHz, c.totalHz);
+}
+
+void test_outliers_are_ignored() {
+  OffsetCalibrator c;
+  offsetCalStart(c);
+  int32_t adjust;
+  for (int i = 0; i < OFFSET_CAL_ROUND - 1; ++i) {
+    TEST_ASSERT_EQUAL(OFFSET_CAL_WAIT, offsetCalSample(c, 300, adjust));
+  }
+  TEST_ASSERT_EQUAL(OFFSET_CAL_WAIT, offsetCalSample(c, 50000, adjust));  // other transmitter
+  TEST_ASSERT_EQUAL(OFFSET_CAL_ADJUST, offsetCalSample(c, 310, adjust));
+  TEST_ASSERT_EQUAL_INT32(300, adjust);
+}
+
+void test_drift_is_tracked() {
+  OffsetDrift d;
+  offsetDriftReset(d);
+  int32_t adjust;
+
+  // Small errors never trigger a correction
+  for (int i = 0; i < 200; ++i) {
+    TEST_ASSERT_FALSE(offsetDriftSample(d, noise(150), adjust));
+  }
+
+  // Warming up: the carrier appears 600 Hz higher
+  bool corrected = false;
+  for (int i = 0; i < 40 && !corrected; ++i) {
+    corrected = offsetDriftSample(d, 600 + noise(100), adjust);
+  }
+  TEST_ASSERT_TRUE(corrected);
+  TEST_ASSERT_INT32_WITHIN(350, 600, adjust);
+  TEST_ASSERT_EQUAL_INT(0, d.samples);
+}
+
+void test_drift_needs_enough_samples() {
+  OffsetDrift d;
+  offsetDriftReset(d);
+  int32_t adjust;
+  for (int i = 0; i < OFFSET_DRIFT_MIN; ++i) {
+    TEST_ASSERT_FALSE(offsetDriftSample(d, 2000, adjust));
+  }
+  TEST_ASSERT_TRUE(offsetDriftSample(d, 2000, adjust));
+  TEST_ASSERT_EQUAL_INT32(2000, adjust);
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_median);
+  RUN_TEST(test_calibration_converges_on_the_offset);
+  RUN_TEST(test_outliers_are_ignored);
+  RUN_TEST(test_drift_is_tracked);
+  RUN_TEST(test_drift_needs_enough_samples);
+  return UNITY_END();
+}
@@ -0,0 +1,87 @@
+#include <unity.h>
+#include <page_dedup.h>
+#include <string.h>
+
+static const uint32_t WINDOW_MS = 60000;
+
+static PageDedup dedup;
+
+static uint32_t hashOf(uint32_t addr, const char* text, uint8_t function = 0) {
+  return pageDedupHash(addr, function, text, strlen(text));
+}
+
+void setUp() {
+  pageDedupReset(dedup);
+}
+void tearDown() {}
+
+void test_hash_covers_address_and_text() {
+  TEST_ASSERT_EQUAL_UINT32(hashOf(1040, "ALARM"), hashOf(1040, "ALARM"));
+  TEST_ASSERT_TRUE(hashOf(1040, "ALARM") != hashOf(1041, "ALARM"));
+  TEST_ASSERT_TRUE(hashOf(1040, "ALARM") != hashOf(1040, "ALARm"));
+  TEST_ASSERT_TRUE(hashOf(1040, "") != hashOf(0, ""));
+}
+
+void test_function_bits_tell_pages_apart() {
+  // Function A and D of one RIC route to different entries
+  TEST_ASSERT_TRUE(hashOf(1040, "ALARM", 0) != hashOf(1040, "ALARM", 3));
+  TEST_ASSERT_FALSE(pageDedupCheck(dedup, hashOf(1040, "ALARM", 0), 1000, WINDOW_MS));
+  TEST_ASSERT_FALSE(pageDedupCheck(dedup, hashOf(1040, "ALARM", 3), 2000, WINDOW_MS));
+  TEST_ASSERT_TRUE(pageDedupCheck(dedup, hashOf(1040, "ALARM", 3), 3000, WINDOW_MS));
+}
+
+void test_copies_inside_the_window_are_duplicates() {
+  uint32_t h = hashOf(1040, "Einsatz B3");
+  TEST_ASSERT_FALSE(pageDedupCheck(dedup, h, 1000, WINDOW_MS));
+  TEST_ASSERT_TRUE(pageDedupCheck(dedup, h, 4000, WINDOW_MS));   // second transmitter
+  TEST_ASSERT_TRUE(pageDedupCheck(dedup, h, 50000, WINDOW_MS));  // resend
+  TEST_ASSERT_FALSE(pageDedupCheck(dedup, hashOf(65009, "Einsatz B3"), 5000, WINDOW_MS));
+  TEST_ASSERT_EQUAL_UINT32(2, dedup.hits);
+  TEST_ASSERT_EQUAL_UINT32(2, dedup.misses);
+}
+
+void test_repeats_do_not_extend_the_window() {
+  uint32_t h = hashOf(1080, "WX 12C");
+  TEST_ASSERT_FALSE(pageDedupCheck(dedup, h, 0, WINDOW_MS));
+  TEST_ASSERT_TRUE(pageDedupCheck(dedup, h, WINDOW_MS - 1, WINDOW_MS));
+  TEST_ASSERT_FALSE(pageDedupCheck(dedup, h, WINDOW_MS, WINDOW_MS));  // next bulletin
+}
+
+void test_millis_wrap() {
+  uint32_t h = hashOf(1040, "wrap");
+  TEST_ASSERT_FALSE(pageDedupCheck(dedup, h, 0xFFFFF000UL, WINDOW_MS));
+  TEST_ASSERT_TRUE(pageDedupCheck(dedup, h, 0x00001000UL, WINDOW_MS));
+}
+
+void test_oldest_page_is_replaced() {
+  char text[8];
+  for (int i = 0; i <= PAGE_DEDUP_SLOTS; ++i) {
+    text[0] = (char)('A' + i);
+    text[1] = '\0';
+    TEST_ASSERT_FALSE(pageDedupCheck(dedup, hashOf(1040, text), (uint32_t)i * 10, WINDOW_MS));
+  }
+  // "A" made room for the last page, "B" is still remembered
+  TEST_ASSERT_FALSE(pageDedupCheck(dedup, hashOf(1040, "A"), 500, WINDOW_MS));
+  TEST_ASSERT_TRUE(pageDedupCheck(dedup, hashOf(1040, "C"), 500, WINDOW_MS));
+}
+
+void test_window_zero_disables() {
+  uint32_t h = hashOf(1040, "x");
+  TEST_ASSERT_FALSE(pageDedupCheck(dedup, h, 0, 0));
+  TEST_ASSERT_FALSE(pageDedupCheck(dedup, h, 1, 0));
+  TEST_ASSERT_EQUAL_UINT32(0, dedup.hits);
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_hash_covers_address_and_text);
+  RUN_TEST(test_function_bits_tell_pages_apart);
+  RUN_TEST(test_copies_inside_the_window_are_duplicates);
+  RUN_TEST(test_repeats_do_not_extend_the_window);
+  RUN_TEST(test_millis_wrap);
+  RUN_TEST(test_oldest_page_is_replaced);
+  RUN_TEST(test_window_zero_disables);
+  return UNITY_END();
+}
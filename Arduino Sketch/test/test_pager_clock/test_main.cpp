@@ -0,0 +1,78 @@
+#include <unity.h>
+#include <pager_clock.h>
+
+static const int64_t SEC = 1000000;
+
+static PagerClock pc;
+
+void setUp() {
+  pagerClockReset(pc);
+}
+void tearDown() {}
+
+void test_first_beacon_sets_the_clock() {
+  TEST_ASSERT_FALSE(pc.valid);
+  TEST_ASSERT_EQUAL_INT(PAGER_CLOCK_SET, pagerClockSync(pc, 5 * SEC, 1000, 1, 120));
+  TEST_ASSERT_TRUE(pc.valid);
+  TEST_ASSERT_EQUAL_UINT32(1000, pagerClockNow(pc, 5 * SEC));
+  TEST_ASSERT_EQUAL_UINT32(1010, pagerClockNow(pc, 15 * SEC));
+}
+
+void test_small_error_is_slewed() {
+  pagerClockSync(pc, 0, 1000, 1, 120);
+
+  // Clock 10 s slow: catches up at 1/PAGER_CLOCK_SLEW_DIV, no jump
+  TEST_ASSERT_EQUAL_INT(PAGER_CLOCK_SLEWING, pagerClockSync(pc, 100 * SEC, 1110, 1, 120));
+  TEST_ASSERT_EQUAL_INT32(10000, pc.lastErrorMs);
+  TEST_ASSERT_EQUAL_UINT32(1100, pagerClockNow(pc, 100 * SEC));
+  TEST_ASSERT_EQUAL_UINT32(1100 + 20 + 1, pagerClockNow(pc, 120 * SEC));
+  TEST_ASSERT_EQUAL_UINT32(1300 + 10, pagerClockNow(pc, 300 * SEC));  // done after 200 s
+  TEST_ASSERT_EQUAL_UINT32(1400 + 10, pagerClockNow(pc, 400 * SEC));
+  TEST_ASSERT_EQUAL_UINT32(1, pc.steps);
+}
+
+void test_fast_clock_never_runs_backwards() {
+  pagerClockSync(pc, 0, 1000, 1, 120);
+  TEST_ASSERT_EQUAL_INT(PAGER_CLOCK_SLEWING, pagerClockSync(pc, 100 * SEC, 1095, 1, 120));
+  TEST_ASSERT_LESS_THAN(0, pc.lastErrorMs);
+
+  int64_t last = pagerClockMicros(pc, 100 * SEC);
+  for (int64_t t = 100 * SEC; t < 300 * SEC; t += SEC / 2) {
+    int64_t now = pagerClockMicros(pc, t);
+    TEST_ASSERT_TRUE(now >= last);
+    last = now;
+  }
+  TEST_ASSERT_EQUAL_UINT32(1295, pagerClockNow(pc, 300 * SEC));
+}
+
+void test_large_error_steps() {
+  pagerClockSync(pc, 0, 1000, 1, 120);
+  TEST_ASSERT_EQUAL_INT(PAGER_CLOCK_STEPPED, pagerClockSync(pc, 10 * SEC, 5000, 1, 120));
+  TEST_ASSERT_EQUAL_UINT32(5000, pagerClockNow(pc, 10 * SEC));
+  TEST_ASSERT_EQUAL_UINT32(2, pc.steps);
+  TEST_ASSERT_EQUAL_UINT32(2, pc.syncs);
+}
+
+void test_minute_beacon_within_its_minute_is_in_sync() {
+  pagerClockSync(pc, 0, 6030, 1, 120);
+
+  // "12:00" while the clock says 12:00:40
+  TEST_ASSERT_EQUAL_INT(PAGER_CLOCK_IN_SYNC, pagerClockSync(pc, 10 * SEC, 6000, 60, 120));
+  TEST_ASSERT_EQUAL_UINT32(6040, pagerClockNow(pc, 10 * SEC));
+
+  // "12:00" at 12:01:10: slewed back to the end of the minute
+  TEST_ASSERT_EQUAL_INT(PAGER_CLOCK_SLEWING, pagerClockSync(pc, 40 * SEC, 6000, 60, 120));
+  TEST_ASSERT_EQUAL_INT32(-10000, pc.lastErrorMs);
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_first_beacon_sets_the_clock);
+  RUN_TEST(test_small_error_is_slewed);
+  RUN_TEST(test_fast_clock_never_runs_backwards);
+  RUN_TEST(test_large_error_steps);
+  RUN_TEST(test_minute_beacon_within_its_minute_is_in_sync);
+  return UNITY_END();
+}
@@ -0,0 +1,172 @@
+#include <unity.h>
+#include <pager_time.h>
+
+static PagerTime makeTime(int year, int month, int day, int hour, int minute, int second) {
+  PagerTime t = { year, month, day, hour, minute, second, true };
+  return t;
+}
+
+static void assertTime(const PagerTime& t, int year, int month, int day, int hour, int minute, int second) {
+  TEST_ASSERT_EQUAL_INT(year, t.year);
+  TEST_ASSERT_EQUAL_INT(month, t.month);
+  TEST_ASSERT_EQUAL_INT(day, t.day);
+  TEST_ASSERT_EQUAL_INT(hour, t.hour);
+  TEST_ASSERT_EQUAL_INT(minute, t.minute);
+  TEST_ASSERT_EQUAL_INT(second, t.second);
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_pack_roundtrip() {
+  PagerTime in  = makeTime(2025, 12, 3, 20, 6, 59);
+  PagerTime out = {};
+  unpackPagerTime(packPagerTime(in), out);
+  TEST_ASSERT_TRUE(out.valid);
+  assertTime(out, 2025, 12, 3, 20, 6, 59);
+}
+
+void test_pack_invalid_is_zero() {
+  PagerTime none = {};
+  TEST_ASSERT_EQUAL_UINT32(0, packPagerTime(none));
+
+  PagerTime out = makeTime(2025, 1, 1, 0, 0, 0);
+  unpackPagerTime(0, out);
+  TEST_ASSERT_FALSE(out.valid);
+}
+
+void test_add_minutes_same_day() {
+  PagerTime t = makeTime(2025, 6, 15, 10, 30, 0);
+  pagerTimeAddMinutes(t, 90);
+  assertTime(t, 2025, 6, 15, 12, 0, 0);
+}
+
+void test_add_minutes_into_next_year() {
+  PagerTime t = makeTime(2025, 12, 31, 23, 30, 0);
+  pagerTimeAddMinutes(t, 60);
+  assertTime(t, 2026, 1, 1, 0, 30, 0);
+}
+
+void test_add_minutes_back_into_previous_month() {
+  PagerTime t = makeTime(2025, 3, 1, 0, 30, 0);
+  pagerTimeAddMinutes(t, -60);
+  assertTime(t, 2025, 2, 28, 23, 30, 0);
+}
+
+void test_leap_years() {
+  TEST_ASSERT_TRUE(pagerIsLeapYear(2024));
+  TEST_ASSERT_FALSE(pagerIsLeapYear(2100));
+  TEST_ASSERT_TRUE(pagerIsLeapYear(2000));
+
+  PagerTime t = makeTime(2024, 3, 1, 0, 30, 0);
+  pagerTimeAddMinutes(t, -60);
+  assertTime(t, 2024, 2, 29, 23, 30, 0);
+
+  t = makeTime(2024, 2, 28, 23, 59, 59);
+  pagerTimeTickSecond(t);
+  assertTime(t, 2024, 2, 29, 0, 0, 0);
+}
+
+void test_epoch_conversion() {
+  TEST_ASSERT_EQUAL_UINT32(0, pagerTimeToEpoch(makeTime(2000, 1, 1, 0, 0, 0)));
+  // 2025-12-03 20:06:59 UTC = Unix 1764792419
+  TEST_ASSERT_EQUAL_UINT32(1764792419UL - 946684800UL, pagerTimeToEpoch(makeTime(2025, 12, 3, 20, 6, 59)));
+
+  // Every day boundary of 2000..2063 survives the round trip
+  PagerTime t;
+  for (PagerEpoch day = 0; day < 64UL * 366; ++day) {
+    pagerTimeFromEpoch(day * 86400UL + 86399UL, t);
+    TEST_ASSERT_TRUE(pagerTimeInRange(t));
+    TEST_ASSERT_EQUAL_UINT32(day * 86400UL + 86399UL, pagerTimeToEpoch(t));
+  }
+}
+
+void test_add_minutes_across_days() {
+  PagerTime t = makeTime(2025, 1, 1, 12, 0, 0);
+  pagerTimeAddMinutes(t, 60 * 24 * 365);  // a whole year in one step
+  assertTime(t, 2026, 1, 1, 12, 0, 0);
+}
+
+void test_range_check() {
+  TEST_ASSERT_TRUE(pagerTimeInRange(makeTime(2024, 2, 29, 23, 59, 59)));
+  TEST_ASSERT_FALSE(pagerTimeInRange(makeTime(2025, 2, 29, 0, 0, 0)));
+  TEST_ASSERT_FALSE(pagerTimeInRange(makeTime(2025, 13, 1, 0, 0, 0)));
+  TEST_ASSERT_FALSE(pagerTimeInRange(makeTime(2025, 0, 1, 0, 0, 0)));
+  TEST_ASSERT_FALSE(pagerTimeInRange(makeTime(2025, 1, 1, 24, 0, 0)));
+  TEST_ASSERT_FALSE(pagerTimeInRange(makeTime(1999, 12, 31, 0, 0, 0)));
+}
+
+static PagerEpoch utcAt(int year, int month, int day, int hour, int minute) {
+  return pagerTimeToEpoch(makeTime(year, month, day, hour, minute, 0));
+}
+
+void test_dst_eu() {
+  // 2025: 30 March and 26 October, 01:00 UTC
+  TEST_ASSERT_EQUAL_INT(60, pagerUtcOffsetMinutes(utcAt(2025, 3, 30, 0, 59), 60, PAGER_DST_EU));
+  TEST_ASSERT_EQUAL_INT(120, pagerUtcOffsetMinutes(utcAt(2025, 3, 30, 1, 0), 60, PAGER_DST_EU));
+  TEST_ASSERT_EQUAL_INT(120, pagerUtcOffsetMinutes(utcAt(2025, 10, 26, 0, 59), 60, PAGER_DST_EU));
+  TEST_ASSERT_EQUAL_INT(60, pagerUtcOffsetMinutes(utcAt(2025, 10, 26, 1, 0), 60, PAGER_DST_EU));
+  TEST_ASSERT_EQUAL_INT(0, pagerUtcOffsetMinutes(utcAt(2024, 7, 1, 12, 0), -60, PAGER_DST_EU));
+  TEST_ASSERT_EQUAL_INT(60, pagerUtcOffsetMinutes(utcAt(2025, 7, 1, 12, 0), 60, PAGER_DST_NONE));
+}
+
+void test_dst_us() {
+  // New York 2025: 9 March 02:00 EST = 07:00 UTC, 2 November 02:00 EDT = 06:00 UTC
+  TEST_ASSERT_EQUAL_INT(-300, pagerUtcOffsetMinutes(utcAt(2025, 3, 9, 6, 59), -300, PAGER_DST_US));
+  TEST_ASSERT_EQUAL_INT(-240, pagerUtcOffsetMinutes(utcAt(2025, 3, 9, 7, 0), -300, PAGER_DST_US));
+  TEST_ASSERT_EQUAL_INT(-240, pagerUtcOffsetMinutes(utcAt(2025, 11, 2, 5, 59), -300, PAGER_DST_US));
+  TEST_ASSERT_EQUAL_INT(-300, pagerUtcOffsetMinutes(utcAt(2025, 11, 2, 6, 0), -300, PAGER_DST_US));
+}
+
+void test_local_to_utc() {
+  TEST_ASSERT_EQUAL_UINT32(utcAt(2025, 1, 15, 11, 0), pagerLocalToUtc(utcAt(2025, 1, 15, 12, 0), 60, PAGER_DST_EU));
+  TEST_ASSERT_EQUAL_UINT32(utcAt(2025, 7, 15, 10, 0), pagerLocalToUtc(utcAt(2025, 7, 15, 12, 0), 60, PAGER_DST_EU));
+  // Either side of the switches
+  TEST_ASSERT_EQUAL_UINT32(utcAt(2025, 3, 30, 0, 59), pagerLocalToUtc(utcAt(2025, 3, 30, 1, 59), 60, PAGER_DST_EU));
+  TEST_ASSERT_EQUAL_UINT32(utcAt(2025, 3, 30, 1, 0), pagerLocalToUtc(utcAt(2025, 3, 30, 3, 0), 60, PAGER_DST_EU));
+  TEST_ASSERT_EQUAL_UINT32(utcAt(2025, 10, 25, 23, 59), pagerLocalToUtc(utcAt(2025, 10, 26, 1, 59), 60, PAGER_DST_EU));
+  TEST_ASSERT_EQUAL_UINT32(utcAt(2025, 10, 26, 1, 30), pagerLocalToUtc(utcAt(2025, 10, 26, 2, 30), 60, PAGER_DST_EU));
+  TEST_ASSERT_EQUAL_UINT32(utcAt(2025, 3, 9, 7, 30), pagerLocalToUtc(utcAt(2025, 3, 9, 3, 30), -300, PAGER_DST_US));
+  TEST_ASSERT_EQUAL_UINT32(0, pagerLocalToUtc(utcAt(2000, 1, 1, 0, 30), 60, PAGER_DST_EU));
+}
+
+void test_add_minutes_ignores_invalid_time() {
+  PagerTime t = makeTime(2025, 3, 1, 0, 30, 0);
+  t.valid     = false;
+  pagerTimeAddMinutes(t, 120);
+  assertTime(t, 2025, 3, 1, 0, 30, 0);
+}
+
+void test_tick_rolls_over_year() {
+  PagerTime t = makeTime(2025, 12, 31, 23, 59, 59);
+  pagerTimeTickSecond(t);
+  assertTime(t, 2026, 1, 1, 0, 0, 0);
+}
+
+void test_tick_rolls_over_short_month() {
+  PagerTime t = makeTime(2025, 4, 30, 23, 59, 59);
+  pagerTimeTickSecond(t);
+  assertTime(t, 2025, 5, 1, 0, 0, 0);
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_pack_roundtrip);
+  RUN_TEST(test_pack_invalid_is_zero);
+  RUN_TEST(test_add_minutes_same_day);
+  RUN_TEST(test_add_minutes_into_next_year);
+  RUN_TEST(test_add_minutes_back_into_previous_month);
+  RUN_TEST(test_add_minutes_ignores_invalid_time);
+  RUN_TEST(test_tick_rolls_over_year);
+  RUN_TEST(test_tick_rolls_over_short_month);
+  RUN_TEST(test_leap_years);
+  RUN_TEST(test_epoch_conversion);
+  RUN_TEST(test_add_minutes_across_days);
+  RUN_TEST(test_range_check);
+  RUN_TEST(test_dst_eu);
+  RUN_TEST(test_dst_us);
+  RUN_TEST(test_local_to_utc);
+  return UNITY_END();
+}
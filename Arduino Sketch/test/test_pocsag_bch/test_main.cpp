@@ -0,0 +1,94 @@
+#include <unity.h>
+#include <pocsag_bch.h>
+#include <pocsag_codeword.h>
+
+static uint32_t rng = 12345;
+
+static uint32_t nextRandom() {
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return rng;
+}
+
+static uint32_t randomCodeword() {
+  return pocsagEncodeCodeword(nextRandom());
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_valid_codewords_have_zero_syndrome() {
+  TEST_ASSERT_EQUAL_UINT16(0, pocsagSyndrome(POCSAG_SYNC_WORD));
+  TEST_ASSERT_EQUAL_UINT16(0, pocsagSyndrome(POCSAG_IDLE_WORD));
+  for (int n = 0; n < 1000; ++n) {
+    uint32_t cw = randomCodeword();
+    TEST_ASSERT_EQUAL_UINT16(0, pocsagSyndrome(cw));
+
+    uint32_t copy = cw;
+    TEST_ASSERT_EQUAL_INT(0, pocsagCorrectCodeword(copy));
+    TEST_ASSERT_EQUAL_HEX32(cw, copy);
+  }
+}
+
+void test_every_single_bit_error_is_corrected() {
+  for (int n = 0; n < 50; ++n) {
+    uint32_t cw = randomCodeword();
+    for (int bit = 0; bit < 32; ++bit) {
+      uint32_t rx = cw ^ (1UL << bit);
+      TEST_ASSERT_EQUAL_INT(1, pocsagCorrectCodeword(rx));
+      TEST_ASSERT_EQUAL_HEX32(cw, rx);
+    }
+  }
+}
+
+void test_every_double_bit_error_is_corrected() {
+  for (int n = 0; n < 20; ++n) {
+    uint32_t cw = randomCodeword();
+    for (int i = 0; i < 32; ++i) {
+      for (int j = i + 1; j < 32; ++j) {
+        uint32_t rx = cw ^ (1UL << i) ^ (1UL << j);
+        TEST_ASSERT_EQUAL_INT(2, pocsagCorrectCodeword(rx));
+        TEST_ASSERT_EQUAL_HEX32(cw, rx);
+      }
+    }
+  }
+}
+
+void test_triple_bit_errors_are_detected() {
+  uint32_t cw = pocsagAddressWord(123456, POCSAG_FUNC_ALPHA);
+  for (int i = 0; i < 32; ++i) {
+    for (int j = i + 1; j < 32; ++j) {
+      for (int k = j + 1; k < 32; ++k) {
+        uint32_t bad = cw ^ (1UL << i) ^ (1UL << j) ^ (1UL << k);
+        uint32_t rx  = bad;
+        TEST_ASSERT_EQUAL_INT(-1, pocsagCorrectCodeword(rx));
+        TEST_ASSERT_EQUAL_HEX32(bad, rx);
+      }
+    }
+  }
+}
+
+void test_errored_sync_word() {
+  TEST_ASSERT_TRUE(pocsagIsSyncWord(POCSAG_SYNC_WORD, 0));
+  TEST_ASSERT_TRUE(pocsagIsSyncWord(POCSAG_SYNC_WORD ^ 0x00100001UL, POCSAG_SYNC_HUNT_ERRORS));
+  TEST_ASSERT_FALSE(pocsagIsSyncWord(POCSAG_SYNC_WORD ^ 0x00100003UL, POCSAG_SYNC_HUNT_ERRORS));
+  TEST_ASSERT_TRUE(pocsagIsSyncWord(POCSAG_SYNC_WORD ^ 0x0000000FUL, POCSAG_SYNC_BATCH_ERRORS));
+
+  // Preamble and idle fill must never pass for a sync word
+  TEST_ASSERT_FALSE(pocsagIsSyncWord(0xAAAAAAAAUL, POCSAG_SYNC_BATCH_ERRORS));
+  TEST_ASSERT_FALSE(pocsagIsSyncWord(0x55555555UL, POCSAG_SYNC_BATCH_ERRORS));
+  TEST_ASSERT_FALSE(pocsagIsSyncWord(POCSAG_IDLE_WORD, POCSAG_SYNC_BATCH_ERRORS));
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_valid_codewords_have_zero_syndrome);
+  RUN_TEST(test_every_single_bit_error_is_corrected);
+  RUN_TEST(test_every_double_bit_error_is_corrected);
+  RUN_TEST(test_triple_bit_errors_are_detected);
+  RUN_TEST(test_errored_sync_word);
+  return UNITY_END();
+}
@@ -0,0 +1,115 @@
+#include <unity.h>
+#include <pocsag_rate.h>
+
+static uint32_t rng = 4711;
+
+static uint32_t nextRandom() {
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return rng;
+}
+
+// Level changes of a preamble at `bitRate`, as seen by a receiver sampling
+// at `sampleRate`: intervals are whole sample periods
+static int edgesUntilDetected(PocsagRateDetector& d, uint32_t bitRate, uint32_t sampleRate,
+                              uint16_t& detected) {
+  uint64_t lastSample = 0;
+  for (int bit = 1; bit < 576; ++bit) {
+    uint64_t sample = (uint64_t)bit * sampleRate / bitRate;
+    uint32_t us     = (uint32_t)((sample - lastSample) * 1000000ULL / sampleRate);
+    lastSample      = sample;
+    detected        = pocsagRateDetectorEdge(d, us);
+    if (detected != 0) {
+      return bit;
+    }
+  }
+  return -1;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_preambles_are_detected_at_their_rate() {
+  const uint16_t rates[] = { 512, 1200, 2400 };
+  for (uint16_t rate : rates) {
+    PocsagRateDetector d;
+    pocsagRateDetectorReset(d);
+    uint16_t detected = 0;
+    int      edges    = edgesUntilDetected(d, rate, rate, detected);
+    TEST_ASSERT_EQUAL_UINT32(rate, detected);
+    TEST_ASSERT_EQUAL_INT(POCSAG_RATE_DETECT_EDGES, edges);
+  }
+}
+
+void test_slower_preambles_seen_at_the_hunt_rate() {
+  const uint16_t rates[] = { 512, 1200, 2400 };
+  for (uint16_t rate : rates) {
+    PocsagRateDetector d;
+    pocsagRateDetectorReset(d);
+    uint16_t detected = 0;
+    int      edges    = edgesUntilDetected(d, rate, POCSAG_HUNT_BIT_RATE, detected);
+    TEST_ASSERT_EQUAL_UINT32(rate, detected);
+    TEST_ASSERT_TRUE(edges > 0 && edges <= POCSAG_RATE_DETECT_EDGES + 1);
+  }
+}
+
+void test_jitter_is_tolerated() {
+  PocsagRateDetector d;
+  pocsagRateDetectorReset(d);
+  uint16_t detected = 0;
+  for (int i = 0; i < POCSAG_RATE_DETECT_EDGES && detected == 0; ++i) {
+    uint32_t us = 833 - 100 + nextRandom() % 200;  // +-12 %
+    detected    = pocsagRateDetectorEdge(d, us);
+  }
+  TEST_ASSERT_EQUAL_UINT32(1200, detected);
+}
+
+void test_noise_and_data_are_not_a_preamble() {
+  PocsagRateDetector d;
+  pocsagRateDetectorReset(d);
+
+  // Receiver noise: level changes at random times
+  for (int i = 0; i < 100000; ++i) {
+    TEST_ASSERT_EQUAL_UINT32(0, pocsagRateDetectorEdge(d, 50 + nextRandom() % 4000));
+  }
+
+  // Random data at 1200 bps: runs of 1..n bit periods
+  for (int i = 0; i < 100000; ++i) {
+    uint32_t bits = 1;
+    while ((nextRandom() & 1) && bits < 8) {
+      bits++;
+    }
+    uint16_t rate = pocsagRateDetectorEdge(d, bits * 833);
+    TEST_ASSERT_TRUE(rate == 0 || rate == 1200);
+  }
+}
+
+void test_broken_run_starts_over() {
+  PocsagRateDetector d;
+  pocsagRateDetectorReset(d);
+  for (int i = 0; i < POCSAG_RATE_DETECT_EDGES - 1; ++i) {
+    TEST_ASSERT_EQUAL_UINT32(0, pocsagRateDetectorEdge(d, 417));
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, pocsagRateDetectorEdge(d, 1250));  // a missed edge
+  TEST_ASSERT_EQUAL_UINT32(0, pocsagRateDetectorEdge(d, 417));
+  TEST_ASSERT_EQUAL_UINT16(1, d.run);
+}
+
+void test_bandwidth_grows_with_rate() {
+  TEST_ASSERT_TRUE(pocsagRxBandwidthKHz(512) < pocsagRxBandwidthKHz(1200));
+  TEST_ASSERT_TRUE(pocsagRxBandwidthKHz(1200) < pocsagRxBandwidthKHz(2400));
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_preambles_are_detected_at_their_rate);
+  RUN_TEST(test_slower_preambles_seen_at_the_hunt_rate);
+  RUN_TEST(test_jitter_is_tolerated);
+  RUN_TEST(test_noise_and_data_are_not_a_preamble);
+  RUN_TEST(test_broken_run_starts_over);
+  RUN_TEST(test_bandwidth_grows_with_rate);
+  return UNITY_END();
+}
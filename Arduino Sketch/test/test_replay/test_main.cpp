@@ -0,0 +1,233 @@
+#include <string.h>
+#include <unity.h>
+#include <pocsag_codeword.h>
+#include <pocsag_decoder.h>
+#include <pocsag_encoder.h>
+#include <rf_replay.h>
+
+static uint8_t      streamData[64 * 1024];
+static BitBuffer    stream;
+static ReplayExpect expect[256];
+
+static const uint32_t RICS[] = { 123456, 123457, 216, 1000003, 8, 65541, 2504, 999999 };
+
+struct ReplayRun {
+  PocsagDecoder dec;
+  ReplayMatcher matcher;
+  uint32_t      bitRate;
+  PocsagPage    lastPage;
+};
+
+static void onPage(const PocsagPage& page, void* ctx) {
+  ReplayRun* run = (ReplayRun*)ctx;
+  run->lastPage  = page;
+
+  int idx = replayMatchPage(run->matcher, page.addr, page.text, page.len);
+  if (idx >= 0) {
+    uint32_t lateBits = run->dec.bitIndex - expect[idx].endBit;
+    replayRecordLatency(run->matcher, (uint32_t)replayBitsToMicros(lateBits, run->bitRate));
+  }
+}
+
+static int buildScenario(uint16_t pages, uint8_t perBurst) {
+  ReplayScenario sc = {};
+  sc.pages          = pages;
+  sc.pagesPerBurst  = perBurst;
+  sc.gapBits        = 300;
+  sc.rics           = RICS;
+  sc.ricCount       = sizeof(RICS) / sizeof(RICS[0]);
+  sc.seed           = 42;
+
+  bitBufferInit(stream, streamData, sizeof(streamData));
+  return replayBuildScenario(sc, stream, expect, sizeof(expect) / sizeof(expect[0]));
+}
+
+static void play(ReplayRun& run, int count, uint32_t bitRate, const ReplayImpairment& imp,
+                 bool correct = false) {
+  run.bitRate = bitRate;
+  pocsagDecoderInit(run.dec, onPage, &run, correct);
+  replayMatcherInit(run.matcher, expect, count);
+
+  ReplayChannel ch;
+  replayChannelInit(ch, imp);
+  for (size_t i = 0; i < stream.bits; ++i) {
+    pocsagDecoderPushBit(run.dec, replayChannelBit(ch, bitBufferGet(stream.data, i)));
+  }
+  pocsagDecoderFlush(run.dec);
+  replayMatcherFinish(run.matcher);
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_sync_and_idle_are_codewords() {
+  TEST_ASSERT_TRUE(pocsagCodewordValid(POCSAG_SYNC_WORD));
+  TEST_ASSERT_TRUE(pocsagCodewordValid(POCSAG_IDLE_WORD));
+  TEST_ASSERT_EQUAL_HEX32(POCSAG_IDLE_WORD, pocsagEncodeCodeword(POCSAG_IDLE_WORD));
+}
+
+void test_bit_error_breaks_codeword() {
+  uint32_t cw = pocsagAddressWord(123456, POCSAG_FUNC_ALPHA);
+  TEST_ASSERT_TRUE(pocsagCodewordValid(cw));
+  for (int bit = 0; bit < 32; ++bit) {
+    TEST_ASSERT_FALSE(pocsagCodewordValid(cw ^ (1UL << bit)));
+  }
+}
+
+void test_clean_stream_decodes_at_all_rates() {
+  const uint32_t rates[] = { 512, 1200, 2400 };
+  int            count   = buildScenario(120, 6);
+  TEST_ASSERT_EQUAL_INT(120, count);
+
+  for (uint32_t rate : rates) {
+    ReplayRun run;
+    play(run, count, rate, ReplayImpairment{});
+    TEST_ASSERT_EQUAL_UINT32(120, run.matcher.stats.intact);
+    TEST_ASSERT_EQUAL_UINT32(0, run.matcher.stats.lost);
+    TEST_ASSERT_EQUAL_UINT32(0, run.matcher.stats.spurious);
+    TEST_ASSERT_EQUAL_UINT32(0, run.dec.badCodewords);
+
+    // A page is complete once the next codeword shows up, with a sync word
+    // in between at most two codewords late
+    TEST_ASSERT_EQUAL_UINT32(120, run.matcher.stats.latencyCount);
+    TEST_ASSERT_TRUE(run.matcher.stats.latencySumUs / 120 >= replayBitsToMicros(32, rate));
+    TEST_ASSERT_TRUE(run.matcher.stats.latencyMaxUs <= replayBitsToMicros(64, rate));
+  }
+}
+
+void test_addresses_use_their_frame() {
+  int count = buildScenario(sizeof(RICS) / sizeof(RICS[0]), 1);
+
+  ReplayRun run;
+  play(run, count, 1200, ReplayImpairment{});
+  TEST_ASSERT_EQUAL_UINT32((uint32_t)count, run.matcher.stats.intact);
+}
+
+void test_numeric_page() {
+  bitBufferInit(stream, streamData, sizeof(streamData));
+  PocsagEncoder enc;
+  pocsagBeginTransmission(enc, stream);
+  TEST_ASSERT_TRUE(pocsagEncodePage(enc, 2504, POCSAG_FUNC_NUMERIC, "0815-4711", 9, nullptr));
+  TEST_ASSERT_TRUE(pocsagEndTransmission(enc));
+
+  ReplayRun run;
+  play(run, 0, 1200, ReplayImpairment{});
+  TEST_ASSERT_EQUAL_UINT32(2504, run.lastPage.addr);
+  TEST_ASSERT_EQUAL_STRING("0815-4711", run.lastPage.text);
+}
+
+void test_bit_errors_and_bursts_are_accounted() {
+  int count = buildScenario(200, 8);
+
+  ReplayImpairment imp = {};
+  imp.berPpm           = 2000;
+  imp.burstEveryBits   = 20000;
+  imp.burstBits        = 200;
+  imp.seed             = 7;
+
+  ReplayRun run;
+  play(run, count, 1200, imp);
+
+  const ReplayStats& s = run.matcher.stats;
+  TEST_ASSERT_GREATER_THAN(0, run.dec.badCodewords);
+  TEST_ASSERT_LESS_THAN((uint32_t)count, s.intact);
+  TEST_ASSERT_EQUAL_UINT32((uint32_t)count, s.intact + s.corrupted + s.lost);
+}
+
+void test_correction_recovers_weak_signal_pages() {
+  int count = buildScenario(200, 8);
+
+  ReplayImpairment imp = {};
+  imp.berPpm           = 3000;
+  imp.seed             = 11;
+
+  ReplayRun plain, fixed;
+  play(plain, count, 1200, imp);
+  play(fixed, count, 1200, imp, true);
+
+  TEST_ASSERT_GREATER_THAN(0, fixed.dec.correctedBits);
+  TEST_ASSERT_GREATER_THAN(plain.matcher.stats.intact, fixed.matcher.stats.intact);
+  TEST_ASSERT_GREATER_OR_EQUAL((uint32_t)count - 2, fixed.matcher.stats.intact);
+  TEST_ASSERT_EQUAL_UINT32(0, fixed.matcher.stats.spurious);
+}
+
+void test_errored_sync_keeps_the_transmission() {
+  int count = buildScenario(16, 16);
+
+  // Two bit errors in the second batch sync word of the transmission
+  size_t sync2 = POCSAG_PREAMBLE_BITS + POCSAG_BATCH_BITS;
+  uint32_t word = 0;
+  for (size_t i = 0; i < 32; ++i) {
+    word = (word << 1) | bitBufferGet(stream.data, sync2 + i);
+  }
+  TEST_ASSERT_EQUAL_HEX32(POCSAG_SYNC_WORD, word);
+  const size_t flips[] = { sync2 + 3, sync2 + 20 };
+  for (size_t bit : flips) {
+    stream.data[bit / 8] ^= (uint8_t)(0x80 >> (bit % 8));
+  }
+
+  ReplayRun plain, fixed;
+  play(plain, count, 1200, ReplayImpairment{});
+  play(fixed, count, 1200, ReplayImpairment{}, true);
+
+  TEST_ASSERT_LESS_THAN((uint32_t)count, plain.matcher.stats.intact);
+  TEST_ASSERT_EQUAL_UINT32((uint32_t)count, fixed.matcher.stats.intact);
+  TEST_ASSERT_EQUAL_UINT32(1, fixed.dec.correctedSyncs);
+  TEST_ASSERT_EQUAL_UINT32(1, fixed.dec.syncLosses);  // only the end of transmission
+}
+
+void test_channel_is_deterministic() {
+  ReplayImpairment imp = {};
+  imp.berPpm           = 50000;
+  imp.seed             = 1234;
+
+  ReplayChannel a, b;
+  replayChannelInit(a, imp);
+  replayChannelInit(b, imp);
+  for (int i = 0; i < 10000; ++i) {
+    TEST_ASSERT_EQUAL_UINT8(replayChannelBit(a, i & 1), replayChannelBit(b, i & 1));
+  }
+  TEST_ASSERT_GREATER_THAN(300, a.errors);
+  TEST_ASSERT_LESS_THAN(700, a.errors);
+}
+
+void test_file_header_roundtrip() {
+  uint8_t hdr[REPLAY_FILE_HEADER_LEN];
+  replayEncodeFileHeader(hdr, 2400, 17, 123456);
+
+  uint16_t rate, pages;
+  uint32_t bits;
+  TEST_ASSERT_TRUE(replayDecodeFileHeader(hdr, rate, pages, bits));
+  TEST_ASSERT_EQUAL_INT(2400, rate);
+  TEST_ASSERT_EQUAL_INT(17, pages);
+  TEST_ASSERT_EQUAL_UINT32(123456, bits);
+
+  replayEncodeFileHeader(hdr, 9600, 1, 1);
+  TEST_ASSERT_FALSE(replayDecodeFileHeader(hdr, rate, pages, bits));
+
+  ReplayExpect in = { 123456, 4096, 80, 0xDEADBEEF }, out;
+  uint8_t      rec[REPLAY_FILE_PAGE_LEN];
+  replayEncodeExpect(rec, in);
+  replayDecodeExpect(rec, out);
+  TEST_ASSERT_EQUAL_UINT32(in.addr, out.addr);
+  TEST_ASSERT_EQUAL_UINT32(in.endBit, out.endBit);
+  TEST_ASSERT_EQUAL_INT(in.textLen, out.textLen);
+  TEST_ASSERT_EQUAL_HEX32(in.textHash, out.textHash);
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_sync_and_idle_are_codewords);
+  RUN_TEST(test_bit_error_breaks_codeword);
+  RUN_TEST(test_clean_stream_decodes_at_all_rates);
+  RUN_TEST(test_addresses_use_their_frame);
+  RUN_TEST(test_numeric_page);
+  RUN_TEST(test_bit_errors_and_bursts_are_accounted);
+  RUN_TEST(test_correction_recovers_weak_signal_pages);
+  RUN_TEST(test_errored_sync_keeps_the_transmission);
+  RUN_TEST(test_channel_is_deterministic);
+  RUN_TEST(test_file_header_roundtrip);
+  return UNITY_END();
+}
@@ -0,0 +1,149 @@
+#include <unity.h>
+#include <ric_table.h>
+#include <string.h>
+
+static RicTable table;
+
+static RicEntry entry(uint32_t addr, uint8_t function, const char* name, uint8_t ringtone = 0,
+                      uint8_t priority = RIC_PRIORITY_NORMAL) {
+  RicEntry e = {};
+  e.addr     = addr;
+  e.function = function;
+  e.ringtone = ringtone;
+  e.priority = priority;
+  strncpy(e.name, name, RIC_NAME_MAX);
+  return e;
+}
+
+void setUp() {
+  ricTableReset(table);
+}
+void tearDown() {}
+
+void test_function_routing() {
+  TEST_ASSERT_EQUAL(0, ricTableAdd(table, entry(1040, RIC_FUNCTION_ANY, "EMERGENCY")));
+  TEST_ASSERT_EQUAL(1, ricTableAdd(table, entry(65009, 0, "IND-A", 1)));
+  TEST_ASSERT_EQUAL(2, ricTableAdd(table, entry(65009, 3, "IND-D", 2, RIC_PRIORITY_URGENT)));
+
+  TEST_ASSERT_EQUAL(0, ricTableMatch(table, 1040, 2));
+  TEST_ASSERT_EQUAL(1, ricTableMatch(table, 65009, 0));
+  TEST_ASSERT_EQUAL(2, ricTableMatch(table, 65009, 3));
+  TEST_ASSERT_EQUAL(RIC_NOT_FOUND, ricTableMatch(table, 65009, 1));  // B and C not subscribed
+  TEST_ASSERT_EQUAL(RIC_NOT_FOUND, ricTableMatch(table, 1041, 0));
+
+  // Own entry beats the catch-all
+  TEST_ASSERT_EQUAL(3, ricTableAdd(table, entry(1040, 1, "EMERG-B")));
+  TEST_ASSERT_EQUAL(3, ricTableMatch(table, 1040, 1));
+  TEST_ASSERT_EQUAL(0, ricTableMatch(table, 1040, 0));
+
+  // Without function bits: catch-all first, else any function of the address
+  TEST_ASSERT_EQUAL(0, ricTableMatch(table, 1040, RIC_FUNCTION_UNKNOWN));
+  TEST_ASSERT_EQUAL(1, ricTableMatch(table, 65009, RIC_FUNCTION_UNKNOWN));
+}
+
+void test_update_and_remove() {
+  ricTableAdd(table, entry(100, 0, "ONE"));
+  ricTableAdd(table, entry(200, 0, "TWO"));
+  ricTableAdd(table, entry(300, 0, "THREE"));
+
+  // Same address and function: updated in place
+  TEST_ASSERT_EQUAL(1, ricTableAdd(table, entry(200, 0, "TWO-NEW", 3)));
+  TEST_ASSERT_EQUAL(3, table.count);
+  TEST_ASSERT_EQUAL_STRING("TWO-NEW", table.entries[1].name);
+
+  TEST_ASSERT_TRUE(ricTableRemove(table, 100, 0));
+  TEST_ASSERT_FALSE(ricTableRemove(table, 100, 0));
+  TEST_ASSERT_EQUAL(2, table.count);
+  TEST_ASSERT_EQUAL(0, ricTableMatch(table, 200, 0));
+  TEST_ASSERT_EQUAL(1, ricTableMatch(table, 300, 0));
+  TEST_ASSERT_EQUAL(RIC_NOT_FOUND, ricTableMatch(table, 100, 0));
+  TEST_ASSERT_EQUAL(1, ricTableFindName(table, "THREE", 5));
+  TEST_ASSERT_EQUAL(RIC_NOT_FOUND, ricTableFindName(table, "THR", 3));
+}
+
+void test_full_table() {
+  // Group RICs sharing the low bits, so they land in the same frame
+  for (int i = 0; i < RIC_TABLE_MAX; ++i) {
+    TEST_ASSERT_EQUAL(i, ricTableAdd(table, entry(8000 + 8 * i, i & 3, "GROUP")));
+  }
+  TEST_ASSERT_EQUAL(RIC_NOT_FOUND, ricTableAdd(table, entry(5, 0, "LATE")));
+  for (int i = 0; i < RIC_TABLE_MAX; ++i) {
+    TEST_ASSERT_EQUAL(i, ricTableMatch(table, 8000 + 8 * i, i & 3));
+    TEST_ASSERT_EQUAL(RIC_NOT_FOUND, ricTableMatch(table, 8000 + 8 * i, (i + 1) & 3));
+  }
+  TEST_ASSERT_EQUAL(0, table.lastFrame);
+
+  // Still updatable when full
+  TEST_ASSERT_EQUAL(7, ricTableAdd(table, entry(8056, 3, "GROUP7", 1)));
+}
+
+void test_invalid_entries_are_rejected() {
+  TEST_ASSERT_EQUAL(RIC_NOT_FOUND, ricTableAdd(table, entry(RIC_ADDR_MAX + 1, 0, "BIG")));
+  TEST_ASSERT_EQUAL(RIC_NOT_FOUND, ricTableAdd(table, entry(1, 5, "FUNC")));
+  TEST_ASSERT_EQUAL(RIC_NOT_FOUND, ricTableAdd(table, entry(1, 0, "PRIO", 0, RIC_PRIORITY_COUNT)));
+  TEST_ASSERT_EQUAL(0, table.count);
+}
+
+void test_last_frame() {
+  ricTableAdd(table, entry(1040, RIC_FUNCTION_ANY, "EMERGENCY"));  // frame 0
+  ricTableAdd(table, entry(1083, 0, "WX"));                        // frame 3
+  TEST_ASSERT_EQUAL(3, table.lastFrame);
+  ricTableRemove(table, 1083, 0);
+  TEST_ASSERT_EQUAL(0, table.lastFrame);
+}
+
+void test_parse_lines() {
+  RicEntry e;
+  TEST_ASSERT_EQUAL(1, ricTableParseLine("1040,*,EMERGENCY,0,3", e));
+  TEST_ASSERT_EQUAL_UINT32(1040, e.addr);
+  TEST_ASSERT_EQUAL(RIC_FUNCTION_ANY, e.function);
+  TEST_ASSERT_EQUAL_STRING("EMERGENCY", e.name);
+  TEST_ASSERT_EQUAL(RIC_PRIORITY_URGENT, e.priority);
+
+  TEST_ASSERT_EQUAL(1, ricTableParseLine("  65009 , d , IND ,2\r\n", e));
+  TEST_ASSERT_EQUAL(3, e.function);
+  TEST_ASSERT_EQUAL_STRING("IND", e.name);
+  TEST_ASSERT_EQUAL(2, e.ringtone);
+  TEST_ASSERT_EQUAL(RIC_PRIORITY_NORMAL, e.priority);  // default
+
+  TEST_ASSERT_EQUAL(0, ricTableParseLine("# RIC,function,name", e));
+  TEST_ASSERT_EQUAL(0, ricTableParseLine("   \r\n", e));
+
+  TEST_ASSERT_EQUAL(-1, ricTableParseLine("1040,E,BAD", e));          // function
+  TEST_ASSERT_EQUAL(-1, ricTableParseLine("1040,A,", e));             // no name
+  TEST_ASSERT_EQUAL(-1, ricTableParseLine("2097152,A,BIG", e));       // 22 bits
+  TEST_ASSERT_EQUAL(-1, ricTableParseLine("12x,A,NUM", e));
+  TEST_ASSERT_EQUAL(-1, ricTableParseLine("1,A,NAME-LONGER-THAN-15", e));
+  TEST_ASSERT_EQUAL(-1, ricTableParseLine("1,A,PRIO,0,4", e));
+  TEST_ASSERT_EQUAL(-1, ricTableParseLine("1,A,MORE,0,1,x", e));
+}
+
+void test_format_round_trip() {
+  RicEntry in = entry(2097151, 2, "CALL", 12, RIC_PRIORITY_HIGH);
+  char     line[40];
+  size_t   len = ricTableFormatLine(in, line, sizeof(line));
+  TEST_ASSERT_EQUAL_STRING("2097151,C,CALL,12,2", line);
+  TEST_ASSERT_EQUAL(strlen(line), len);
+
+  RicEntry out;
+  TEST_ASSERT_EQUAL(1, ricTableParseLine(line, out));
+  TEST_ASSERT_EQUAL_UINT32(in.addr, out.addr);
+  TEST_ASSERT_EQUAL(in.function, out.function);
+  TEST_ASSERT_EQUAL(in.ringtone, out.ringtone);
+  TEST_ASSERT_EQUAL(in.priority, out.priority);
+  TEST_ASSERT_EQUAL_STRING(in.name, out.name);
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_function_routing);
+  RUN_TEST(test_update_and_remove);
+  RUN_TEST(test_full_table);
+  RUN_TEST(test_invalid_entries_are_rejected);
+  RUN_TEST(test_last_frame);
+  RUN_TEST(test_parse_lines);
+  RUN_TEST(test_format_round_trip);
+  return UNITY_END();
+}
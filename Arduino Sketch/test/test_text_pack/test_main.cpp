@@ -0,0 +1,75 @@
+#include <string.h>
+#include <unity.h>
+#include <text_pack.h>
+
+static uint8_t packed[TEXT_PACKED_LEN(128)];
+static char    text[129];
+
+void setUp() {
+  memset(packed, 0xAA, sizeof(packed));
+}
+
+void tearDown() {}
+
+void test_packed_length() {
+  TEST_ASSERT_EQUAL_size_t(0, TEXT_PACKED_LEN(0));
+  TEST_ASSERT_EQUAL_size_t(1, TEXT_PACKED_LEN(1));
+  TEST_ASSERT_EQUAL_size_t(7, TEXT_PACKED_LEN(8));
+  TEST_ASSERT_EQUAL_size_t(8, TEXT_PACKED_LEN(9));
+  TEST_ASSERT_EQUAL_size_t(70, TEXT_PACKED_LEN(80));
+}
+
+void test_round_trip_all_characters() {
+  for (int i = 0; i < 128; ++i) {
+    text[i] = (char)i;
+  }
+  TEST_ASSERT_EQUAL_size_t(112, textPack(packed, text, 128));
+
+  char out[129];
+  textUnpack(out, packed, 0, 128);
+  TEST_ASSERT_EQUAL_MEMORY(text, out, 128);
+  TEST_ASSERT_EQUAL_CHAR('\0', out[128]);
+}
+
+void test_bit_layout() {
+  // 'A' = 1000001b in bits 0-6, 'B' = 1000010b in bits 7-13
+  textPack(packed, "AB", 2);
+  TEST_ASSERT_EQUAL_HEX8(0x41, packed[0]);
+  TEST_ASSERT_EQUAL_HEX8(0x21, packed[1]);
+}
+
+void test_random_access() {
+  const char* msg = "Einsatz: Hauptstrasse 12, RTW + HLF anfahren";
+  size_t      len = strlen(msg);
+  textPack(packed, msg, len);
+
+  for (size_t i = 0; i < len; ++i) {
+    TEST_ASSERT_EQUAL_CHAR(msg[i], textCharAt(packed, i));
+  }
+  textUnpack(text, packed, 9, 11);
+  TEST_ASSERT_EQUAL_STRING("Hauptstrass", text);
+}
+
+void test_eight_bit_bytes_become_question_marks() {
+  textPack(packed, "a\xE4z", 3);
+  textUnpack(text, packed, 0, 3);
+  TEST_ASSERT_EQUAL_STRING("a?z", text);
+}
+
+void test_nothing_written_past_the_packed_length() {
+  textPack(packed, "1234567", 7);  // 49 bits
+  TEST_ASSERT_EQUAL_HEX8(0xAA, packed[7]);
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_packed_length);
+  RUN_TEST(test_round_trip_all_characters);
+  RUN_TEST(test_bit_layout);
+  RUN_TEST(test_random_access);
+  RUN_TEST(test_eight_bit_bytes_become_question_marks);
+  RUN_TEST(test_nothing_written_past_the_packed_length);
+  return UNITY_END();
+}
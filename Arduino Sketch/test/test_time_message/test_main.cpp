@@ -0,0 +1,96 @@
+#include <string.h>
+#include <unity.h>
+#include <time_message.h>
+
+static TimeMessageResult parse(uint32_t addr, const char* text, TimeBeacon& beacon) {
+  return parseTimeMessage(addr, text, strlen(text), beacon);
+}
+
+static void assertTime(const PagerTime& t, int year, int month, int day, int hour, int minute, int second) {
+  TEST_ASSERT_TRUE(t.valid);
+  TEST_ASSERT_EQUAL_INT(year, t.year);
+  TEST_ASSERT_EQUAL_INT(month, t.month);
+  TEST_ASSERT_EQUAL_INT(day, t.day);
+  TEST_ASSERT_EQUAL_INT(hour, t.hour);
+  TEST_ASSERT_EQUAL_INT(minute, t.minute);
+  TEST_ASSERT_EQUAL_INT(second, t.second);
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_parses_dapnet_beacon() {
+  TimeBeacon beacon = {};
+  TEST_ASSERT_EQUAL_INT(TIME_MSG_OK, parse(224, "YYYYMMDDHHMMSS251203200659", beacon));
+  assertTime(beacon.time, 2025, 12, 3, 20, 6, 59);
+  TEST_ASSERT_FALSE(beacon.local);
+  TEST_ASSERT_EQUAL_INT(1, beacon.resolution);
+}
+
+void test_pattern_may_follow_a_prefix() {
+  TimeBeacon beacon = {};
+  TEST_ASSERT_EQUAL_INT(TIME_MSG_OK, parse(216, "XX YYYYMMDDHHMMSS250101000000", beacon));
+  TEST_ASSERT_EQUAL_INT(2025, beacon.time.year);
+  TEST_ASSERT_EQUAL_INT(1, beacon.time.month);
+}
+
+void test_parses_xtime() {
+  TimeBeacon beacon = {};
+  TEST_ASSERT_EQUAL_INT(TIME_MSG_OK, parse(2000, "XTIME=1542031225XTIME=1542031225", beacon));
+  assertTime(beacon.time, 2025, 12, 3, 15, 42, 0);
+  TEST_ASSERT_TRUE(beacon.local);
+  TEST_ASSERT_EQUAL_INT(60, beacon.resolution);
+
+  TEST_ASSERT_EQUAL_INT(TIME_MSG_OK, parse(208, "XTIME=0001010126", beacon));
+  assertTime(beacon.time, 2026, 1, 1, 0, 1, 0);
+}
+
+void test_parses_2504_format() {
+  TimeBeacon beacon = {};
+  TEST_ASSERT_EQUAL_INT(TIME_MSG_OK, parse(2504, "154207   031225", beacon));
+  assertTime(beacon.time, 2025, 12, 3, 15, 42, 7);
+  TEST_ASSERT_TRUE(beacon.local);
+  TEST_ASSERT_EQUAL_INT(1, beacon.resolution);
+
+  TEST_ASSERT_EQUAL_INT(TIME_MSG_OK, parse(2504, " 000000 010126", beacon));
+  assertTime(beacon.time, 2026, 1, 1, 0, 0, 0);
+
+  TEST_ASSERT_EQUAL_INT(TIME_MSG_BAD, parse(2504, "154207031225", beacon));
+}
+
+void test_other_rics_are_ignored() {
+  TimeBeacon beacon = {};
+  TEST_ASSERT_EQUAL_INT(TIME_MSG_NONE, parse(123456, "YYYYMMDDHHMMSS251203200659", beacon));
+  TEST_ASSERT_EQUAL_INT(TIME_MSG_NONE, parse(2001, "XTIME=1542031225", beacon));
+  TEST_ASSERT_FALSE(beacon.time.valid);
+}
+
+void test_short_or_missing_pattern() {
+  TimeBeacon beacon = {};
+  TEST_ASSERT_EQUAL_INT(TIME_MSG_SHORT, parse(224, "YYYYMMDDHHMMSS2512", beacon));
+  TEST_ASSERT_EQUAL_INT(TIME_MSG_SHORT, parse(224, "251203200659", beacon));
+  TEST_ASSERT_EQUAL_INT(TIME_MSG_SHORT, parse(208, "XTIME=15420312", beacon));
+  TEST_ASSERT_EQUAL_INT(TIME_MSG_SHORT, parse(2504, "154207   ", beacon));
+  TEST_ASSERT_FALSE(beacon.time.valid);
+}
+
+void test_non_digits_are_rejected() {
+  TimeBeacon beacon = {};
+  TEST_ASSERT_EQUAL_INT(TIME_MSG_BAD, parse(224, "YYYYMMDDHHMMSS2512032006x9", beacon));
+  TEST_ASSERT_EQUAL_INT(TIME_MSG_BAD, parse(2000, "XTIME=15:42 03.12.25", beacon));
+  TEST_ASSERT_FALSE(beacon.time.valid);
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_parses_dapnet_beacon);
+  RUN_TEST(test_pattern_may_follow_a_prefix);
+  RUN_TEST(test_parses_xtime);
+  RUN_TEST(test_parses_2504_format);
+  RUN_TEST(test_other_rics_are_ignored);
+  RUN_TEST(test_short_or_missing_pattern);
+  RUN_TEST(test_non_digits_are_rejected);
+  return UNITY_END();
+}